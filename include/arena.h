@@ -0,0 +1,45 @@
+/*
+ * 大页内存区接口
+ * 大批量的游戏状态用普通 4 KiB 页时，每局都可能落在不同的页上，TLB 缺失很多；
+ * 内存区可以用透明大页（madvise(MADV_HUGEPAGE)）或预留的大页（MAP_HUGETLB）支撑，
+ * 请求的方式不可用时依次退回到透明大页和普通页
+ */
+
+#ifndef SNAKE_ARENA_H
+#define SNAKE_ARENA_H
+
+#include <SDL3/SDL.h>
+
+/* 内存区的页面类型 */
+typedef enum
+{
+    SNAKE_ARENA_NORMAL_PAGES,      /* 普通页（明确禁止透明大页，便于比较） */
+    SNAKE_ARENA_TRANSPARENT_HUGE,  /* 透明大页：内核在缺页时尽量使用大页 */
+    SNAKE_ARENA_EXPLICIT_HUGE,     /* 预留的大页（需要事先设置 vm.nr_hugepages） */
+    SNAKE_ARENA_PAGES_COUNT
+} SnakeArenaPages;
+
+/* 内存区 */
+typedef struct
+{
+    void *base;             /* 可用内存的起始地址（按页面大小对齐） */
+    size_t size;            /* 可用内存的大小 */
+    SnakeArenaPages pages;  /* 实际使用的页面类型（可能因退回而与请求不同） */
+    size_t page_size;       /* 页面类型对应的页面大小 */
+    void *mapping;          /* 映射的起始地址和大小，用于释放 */
+    size_t mapping_size;
+} SnakeArena;
+
+/* 分配至少 size 字节的内存区，请求的页面类型不可用时退回；失败时返回 false */
+bool snake_arena_create(SnakeArena *arena, size_t size, SnakeArenaPages pages);
+
+/* 释放内存区 */
+void snake_arena_destroy(SnakeArena *arena);
+
+/* 内存区中实际由大页支撑的字节数（透明大页在首次访问之后才能确定），无法查询时返回 0 */
+size_t snake_arena_huge_bytes(const SnakeArena *arena);
+
+/* 页面类型的名称 */
+const char *snake_arena_pages_name(SnakeArenaPages pages);
+
+#endif /* SNAKE_ARENA_H */
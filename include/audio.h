@@ -0,0 +1,53 @@
+/*
+ * 音效混音接口
+ * 游戏线程把 snake_step 产生的事件写入无锁队列，
+ * 音频线程在 SDL 音频流回调中取出事件，用预先生成的 PCM 数据混音；
+ * 音频线程上不分配内存、不加锁
+ */
+
+#ifndef SNAKE_AUDIO_H
+#define SNAKE_AUDIO_H
+
+#include <SDL3/SDL.h>
+
+/* 音效种类 */
+typedef enum
+{
+    SNAKE_SOUND_EAT,   /* 吃到食物或拾取物 */
+    SNAKE_SOUND_TURN,  /* 转向 */
+    SNAKE_SOUND_DEATH, /* 撞到自己 */
+    SNAKE_SOUND_COUNT
+} SnakeSound;
+
+/* 混音器统计信息（由音频线程发布，游戏线程读取快照） */
+typedef struct
+{
+    Uint64 callbacks;     /* 音频回调次数 */
+    Uint64 frames;        /* 已混音的采样帧数 */
+    Uint64 busy_ns;       /* 回调中累计耗费的 CPU 时间（纳秒） */
+    Uint64 max_busy_ns;   /* 单次回调的最长耗时（纳秒） */
+    Uint32 sounds_played; /* 已开始播放的音效数量 */
+    float peak;           /* 输出的峰值幅度 */
+} SnakeMixerStats;
+
+typedef struct SnakeMixer SnakeMixer;
+
+/* 打开默认音频设备并启动混音，失败时返回 NULL */
+SnakeMixer *snake_mixer_open(void);
+
+/* 关闭音频设备并释放混音器，mixer 可以为 NULL */
+void snake_mixer_close(SnakeMixer *mixer);
+
+/* 请求播放音效（只写入无锁队列），队列已满时返回 false；mixer 可以为 NULL */
+bool snake_mixer_play(SnakeMixer *mixer, SnakeSound sound);
+
+/* 把 snake_step 的事件位掩码（SNAKE_EVENT_*）转换为音效，返回成功写入队列的音效数量 */
+int snake_mixer_play_events(SnakeMixer *mixer, Uint8 events);
+
+/* 获取统计信息快照 */
+void snake_mixer_get_stats(SnakeMixer *mixer, SnakeMixerStats *stats);
+
+/* 获取因队列已满而丢弃的音效请求数量 */
+Uint32 snake_mixer_dropped(const SnakeMixer *mixer);
+
+#endif /* SNAKE_AUDIO_H */
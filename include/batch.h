@@ -0,0 +1,44 @@
+/*
+ * 批量推进接口
+ * 训练和评估时同时运行成千上万局单人游戏，各局状态连续存放在一个按缓存行对齐的数组中，
+ * 每次调用为每局应用一个转向并推进一个 tick
+ */
+
+#ifndef SNAKE_BATCH_H
+#define SNAKE_BATCH_H
+
+#include <SDL3/SDL.h>
+#include "snake.h"
+
+#define SNAKE_BATCH_NO_TURN 0xFFU /* 本 tick 不转向 */
+#define SNAKE_BATCH_PREFETCH_DISTANCE 4 /* 默认预取距离（局数），批量超出缓存时的最佳值 */
+#define SNAKE_BATCH_TURN_CHANCE 4 /* snake_batch_random_turns 中每局转向的概率为 1/4 */
+
+/* 依次使用种子 seed、seed + 1、... 初始化 count 局游戏（games 按缓存行对齐，例如来自大页内存区） */
+void snake_batch_init(SnakeContext *games, int count, Uint64 seed);
+
+/* 分配 count 局游戏的状态数组（按缓存行对齐）并用 snake_batch_init 初始化；
+ * 失败时返回 NULL，用 snake_batch_free 释放
+ */
+SnakeContext *snake_batch_alloc(int count, Uint64 seed);
+
+/* 释放 snake_batch_alloc 分配的状态数组 */
+void snake_batch_free(SnakeContext *games);
+
+/* 依次推进 count 局游戏各一个 tick：turns[i] 为第 i 局的转向（SnakeDirection 或
+ * SNAKE_BATCH_NO_TURN），turns 为 NULL 时都不转向
+ */
+void snake_step_batch(SnakeContext *games, const Uint8 *turns, int count);
+
+/* 流水线方式的 snake_step_batch，结果完全相同：推进第 i 局时预取第 i + 2 * distance 局的
+ * 第一条缓存行（计数器和蛇），并按第 i + distance 局已在缓存中的蛇头蛇尾坐标预取对应的格子；
+ * 批量超出缓存时掩盖每局的缓存缺失，distance 为 0 时不预取
+ */
+void snake_step_batch_pipelined(SnakeContext *games, const Uint8 *turns, int count, int distance);
+
+/* 为 count 局生成随机对局的转向：每局以 1/SNAKE_BATCH_TURN_CHANCE 的概率转向随机方向，
+ * 否则为 SNAKE_BATCH_NO_TURN；检查和基准模式的随机对局都由它驱动，rng 为 SDL_rand_r 的状态
+ */
+void snake_batch_random_turns(Uint8 *turns, int count, Uint64 *rng);
+
+#endif /* SNAKE_BATCH_H */
@@ -0,0 +1,20 @@
+/*
+ * 配置文件接口
+ * 配置文件为 "键 = 值" 格式的文本，每行一项，# 开头的行为注释，
+ * 解析后逐项交给调用者处理，键的含义由各模块自行解释（例如 bind.Up = up）
+ */
+
+#ifndef SNAKE_CONFIG_H
+#define SNAKE_CONFIG_H
+
+#include <SDL3/SDL.h>
+
+#define SNAKE_CONFIG_DEFAULT_PATH "snake.cfg" /* 默认配置文件路径 */
+
+/* 配置项处理函数，无法识别或值无效时返回 false（记录警告后继续解析） */
+typedef bool (*SnakeConfigFunc)(void *userdata, const char *key, const char *value);
+
+/* 读取并解析配置文件，文件无法读取时返回 false */
+bool snake_config_load(const char *path, SnakeConfigFunc func, void *userdata);
+
+#endif /* SNAKE_CONFIG_H */
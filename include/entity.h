@@ -0,0 +1,55 @@
+/*
+ * 实体存储接口
+ * 食物、拾取物和特效以句柄引用，组件存放在 SnakeEntities 的稠密数组中
+ */
+
+#ifndef SNAKE_ENTITY_H
+#define SNAKE_ENTITY_H
+
+#include "snake.h"
+
+/* 销毁所有实体，所有旧句柄失效 */
+void snake_entities_clear(SnakeEntities *e);
+
+/* 创建实体，容量不足时返回 SNAKE_ENTITY_INVALID
+ * value 对食物和拾取物表示分值，对特效表示持续的 tick 数；
+ * 食物和拾取物会登记到格子交叉引用中，调用者负责写入对应的 SNAKE_CELL_FOOD
+ */
+SnakeEntity snake_entity_create(SnakeEntities *e, SnakeEntityKind kind, char x, char y, Uint8 value);
+
+/* 检查句柄是否仍然有效（槽位代数一致） */
+bool snake_entity_alive(const SnakeEntities *e, SnakeEntity entity);
+
+/* 销毁实体，无效句柄会被忽略 */
+void snake_entity_destroy(SnakeEntities *e, SnakeEntity entity);
+
+/* 通过格子交叉引用查找实体，没有时返回 SNAKE_ENTITY_INVALID */
+SnakeEntity snake_entity_at(const SnakeEntities *e, char x, char y);
+
+/* 获取实体种类（句柄必须有效） */
+SnakeEntityKind snake_entity_kind(const SnakeEntities *e, SnakeEntity entity);
+
+/* 获取实体的分值或剩余 tick 数（句柄必须有效） */
+Uint8 snake_entity_value(const SnakeEntities *e, SnakeEntity entity);
+
+/* 获取食物或拾取物的坐标（句柄必须有效） */
+void snake_entity_position(const SnakeEntities *e, SnakeEntity entity, char *x, char *y);
+
+/* 把食物或拾取物移动到新格子并更新格子交叉引用，调用者负责更新场地 */
+void snake_entity_move(SnakeEntities *e, SnakeEntity entity, char x, char y);
+
+/* 设置食物或拾取物的存活时间，并在到期堆中登记 now + lifetime（lifetime 为 0 时不登记） */
+void snake_entity_set_lifetime(SnakeEntities *e, SnakeEntity entity, Uint16 lifetime, Uint32 now);
+
+/* 获取食物或拾取物的存活时间（句柄必须有效） */
+Uint16 snake_entity_lifetime(const SnakeEntities *e, SnakeEntity entity);
+
+/* 弹出一个在 now 或之前到期、且仍然存活的实体，没有时返回 SNAKE_ENTITY_INVALID
+ * 已被吃掉的实体的旧记录在这里按代数校验后丢弃，每次 O(log n)
+ */
+SnakeEntity snake_entities_pop_expired(SnakeEntities *e, Uint32 now);
+
+/* 每 tick 的实体系统：推进特效计时并销毁到期的特效 */
+void snake_entities_tick(SnakeEntities *e);
+
+#endif /* SNAKE_ENTITY_H */
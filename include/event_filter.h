@@ -0,0 +1,53 @@
+/*
+ * 事件过滤接口
+ * 通过 SDL_SetEventFilter 在事件进入 SDL 队列之前丢弃游戏不需要的事件
+ * （鼠标、触摸、文字输入、按键抬起和自动重复等），并按类别统计通过和丢弃的数量
+ */
+
+#ifndef SNAKE_EVENT_FILTER_H
+#define SNAKE_EVENT_FILTER_H
+
+#include <SDL3/SDL.h>
+
+/* 事件类别 */
+typedef enum
+{
+    SNAKE_EVENT_CATEGORY_QUIT,       /* 退出和应用生命周期 */
+    SNAKE_EVENT_CATEGORY_WINDOW,     /* 窗口和显示器 */
+    SNAKE_EVENT_CATEGORY_KEY_DOWN,   /* 按键按下 */
+    SNAKE_EVENT_CATEGORY_KEY_REPEAT, /* 按键自动重复 */
+    SNAKE_EVENT_CATEGORY_KEY_UP,     /* 按键抬起 */
+    SNAKE_EVENT_CATEGORY_TEXT,       /* 文字输入和输入法 */
+    SNAKE_EVENT_CATEGORY_MOUSE,      /* 鼠标 */
+    SNAKE_EVENT_CATEGORY_TOUCH,      /* 触摸和手写笔 */
+    SNAKE_EVENT_CATEGORY_JOYSTICK,   /* 原始摇杆事件（手柄另有对应的事件） */
+    SNAKE_EVENT_CATEGORY_GAMEPAD,    /* 手柄热插拔、按钮按下和摇杆 */
+    SNAKE_EVENT_CATEGORY_GAMEPAD_OTHER, /* 手柄按钮抬起、触摸板和传感器 */
+    SNAKE_EVENT_CATEGORY_SENSOR,     /* 传感器 */
+    SNAKE_EVENT_CATEGORY_OTHER,      /* 其他事件 */
+    SNAKE_EVENT_CATEGORY_COUNT
+} SnakeEventCategory;
+
+/* 事件统计（过滤器可能在任意线程中调用，计数使用原子操作） */
+typedef struct
+{
+    SDL_AtomicInt passed[SNAKE_EVENT_CATEGORY_COUNT];  /* 进入队列的事件数量 */
+    SDL_AtomicInt dropped[SNAKE_EVENT_CATEGORY_COUNT]; /* 被丢弃的事件数量 */
+} SnakeEventStats;
+
+/* 获取事件类别的名称 */
+const char *snake_event_category_name(SnakeEventCategory category);
+
+/* 判断事件的类别 */
+SnakeEventCategory snake_event_category(const SDL_Event *event);
+
+/* 安装事件过滤器（需要在 SDL_Init 之后调用），stats 在移除之前必须一直有效 */
+void snake_event_filter_install(SnakeEventStats *stats);
+
+/* 移除事件过滤器 */
+void snake_event_filter_remove(void);
+
+/* 输出各类别事件的统计 */
+void snake_event_stats_log(SnakeEventStats *stats);
+
+#endif /* SNAKE_EVENT_FILTER_H */
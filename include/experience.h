@@ -0,0 +1,59 @@
+/*
+ * 经验回放缓冲区接口
+ * 进程内强化学习使用的固定容量回放缓冲区：观察按打包的 cells 保存（每帧 162 字节，而不是每格一个浮点数），
+ * 相邻的转移共用帧：第 i 个转移的下一个观察就是第 i + 1 个转移的观察，每帧只保存一次；
+ * 按优先级采样，优先级保存在求和树中，采样和更新都是 O(log n)，采样的一批转移解码到调用者的缓冲区
+ */
+
+#ifndef SNAKE_EXPERIENCE_H
+#define SNAKE_EXPERIENCE_H
+
+#include <SDL3/SDL.h>
+#include "snake.h"
+
+#define SNAKE_EXPERIENCE_PRIORITY_EPSILON 1e-3f /* 加在误差上，误差为 0 的转移也有机会被采样 */
+
+/* 一批采样结果，数组由调用者分配，每个至少 count 项；weights 可以为 NULL */
+typedef struct
+{
+    float *obs;          /* [count][SNAKE_MATRIX_SIZE] 执行动作之前的场地，每格为 SnakeCell 的值 */
+    float *next_obs;     /* [count][SNAKE_MATRIX_SIZE] 执行动作之后的场地 */
+    Uint8 *actions;      /* 动作（与轨迹数据集相同，0xFF 表示不转向） */
+    float *rewards;      /* 奖励 */
+    Uint8 *dones;        /* 结束标志 */
+    Uint32 *indices;     /* 转移在缓冲区中的位置，用于更新优先级 */
+    float *weights;      /* 重要性采样权重（按这一批中的最大值归一化） */
+} SnakeExperienceBatch;
+
+typedef struct SnakeExperience SnakeExperience;
+
+/* 创建容量为 capacity 个转移的缓冲区，alpha 为优先级的指数（0 表示均匀采样），失败时返回 NULL */
+SnakeExperience *snake_experience_create(Uint32 capacity, float alpha);
+
+/* 释放缓冲区 */
+void snake_experience_destroy(SnakeExperience *exp);
+
+/* 加入一个转移：obs 为执行动作之前的 cells；下一个观察来自下一次加入的 obs，
+ * 因此最新加入的转移要等到下一次加入之后才能被采样；缓冲区满时覆盖最旧的转移；
+ * 新转移的优先级为目前见过的最大优先级
+ */
+void snake_experience_add(SnakeExperience *exp, const unsigned char *obs, Uint8 action, float reward, bool done);
+
+/* 可以采样的转移数量 */
+Uint32 snake_experience_size(const SnakeExperience *exp);
+
+/* 缓冲区占用的字节数（帧、转移和求和树） */
+size_t snake_experience_bytes(const SnakeExperience *exp);
+
+/* 按优先级分层采样 count 个转移并解码到 batch，beta 为重要性采样的指数；
+ * 返回采样的数量（没有可以采样的转移时为 0）
+ */
+Uint32 snake_experience_sample(SnakeExperience *exp, Uint32 count, float beta, Uint64 *rng, SnakeExperienceBatch *batch);
+
+/* 按训练得到的误差更新 count 个转移的优先级：(|误差| + epsilon) ^ alpha */
+void snake_experience_update(SnakeExperience *exp, const Uint32 *indices, const float *errors, Uint32 count);
+
+/* 把一帧打包的 cells 解码为每格一个浮点数 */
+void snake_experience_decode(const unsigned char *cells, float *out);
+
+#endif /* SNAKE_EXPERIENCE_H */
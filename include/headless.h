@@ -0,0 +1,130 @@
+/*
+ * 无窗口运行模式
+ * 通过命令行参数选择，在 SDL_AppInit 中直接运行并返回结果，
+ * 不创建窗口，可在 CI 等无显示环境中执行
+ */
+
+#ifndef SNAKE_HEADLESS_H
+#define SNAKE_HEADLESS_H
+
+#include <SDL3/SDL.h>
+
+/* 渲染回归检查（--render-check）
+ * 使用软件渲染器回放脚本化对局（包括有蛇撞死并复活的多人对局），逐帧计算哈希：
+ * 每种渲染策略必须与逐格绘制的参考实现一致，参考实现必须与黄金哈希文件一致
+ * （默认路径下没有文件时只比较策略，--golden 指定的文件不存在时失败）
+ *   --golden <path>   黄金哈希文件路径（默认 test/golden/render_hashes.txt），指定后文件必须存在
+ *   --update-golden   用参考实现的结果重写黄金哈希文件
+ */
+SDL_AppResult snake_render_check(int argc, char *argv[]);
+
+/* 音效混音检查（--audio-check）
+ * 使用 SDL 的 dummy 音频驱动运行混音器，模拟一段对局并触发音效，
+ * 检查事件全部被音频线程消费、输出了有效的音频，并报告混音耗费的 CPU 时间
+ */
+SDL_AppResult snake_audio_check(int argc, char *argv[]);
+
+/* 回放跳转检查（--seek-check）
+ * 生成一段约一百万 tick 的随机回放，保存为带关键帧的回放文件后重新打开，
+ * 乱序跳转到若干 tick 并与顺序播放的状态逐字节比较，报告跳转耗时
+ *   --replay-path <path>   临时回放文件路径（默认 seek_check.snkr，检查结束后删除）
+ */
+SDL_AppResult snake_seek_check(int argc, char *argv[]);
+
+/* 流式回放检查（--stream-check）
+ * 检查 LZ 编解码往返，录制一段约四百万 tick 的随机对局（后台线程分块压缩写入），
+ * 按需解压播放并与录制时的状态逐字节比较，再随机定位检查块索引，报告压缩率
+ *   --replay-path <path>   临时回放文件路径（默认 stream_check.snks，检查结束后删除）
+ */
+SDL_AppResult snake_stream_check(int argc, char *argv[]);
+
+/* 回退检查（--rewind-check）
+ * 以默认速度模拟十分钟的随机对局并记录回退历史，
+ * 每次回退 60 个 tick，结果必须与当时保存的完整状态逐字节一致，报告历史占用的内存和回退耗时
+ */
+SDL_AppResult snake_rewind_check(int argc, char *argv[]);
+
+/* 分歧定位（--bisect、--bisect-record）
+ * 比较回放文件中每个 tick 的滚动校验和，报告第一个出现差异的 tick；
+ * 再从它之前的关键帧（快照布局不同时从头）重新模拟到这个 tick，逐格报告这个 tick 的变化和当前版本与哪一方一致
+ *   --bisect-record <path>   用当前版本运行随机回放并保存（--ticks、--seed 指定长度和种子）
+ *   --bisect <a> [<b>]       比较两个版本分别记录的回放；只给出一个文件时与当前版本重新运行的结果比较
+ */
+SDL_AppResult snake_bisect(int argc, char *argv[]);
+
+/* 长蛇压力测试（--stress）
+ * 自动驾驶沿哈密顿回路让蛇一直增长到占满场地，按蛇身长度分段输出每 tick 的
+ * snake_step 和渲染耗时；再在运行时指定大小的大场地上让蛇增长到 10^6 格左右，输出每 tick 的移动和挑选空格子耗时；
+ * 任一场地上的耗时随长度增长超过限度时失败
+ *   --stress-csv <path>      把两个场地各长度段的耗时写入 CSV 文件（用于绘图）
+ *   --stress-width <w>       大场地宽度（默认 1024）
+ *   --stress-height <h>      大场地高度（默认 1024，必须为偶数）
+ */
+SDL_AppResult snake_stress(int argc, char *argv[]);
+
+/* 批量推进基准测试（--batch-bench）
+ * 以 16 到 131072 局的批量连续推进游戏，输出每种批量下逐局推进和各预取距离（1 到 16）下
+ * 流水线推进的每次 snake_step 平均耗时、普通页和大页内存区的耗时（以及实际得到的页面大小），
+ * 以及状态结构的缓存行布局；
+ * 各方式的最终状态与逐局推进不一致时失败
+ *   --batch-steps <n>         每种批量大小推进的总 tick 数（默认 4M）
+ *   --prefetch-distance <k>   只比较逐局推进和预取距离 k
+ */
+SDL_AppResult snake_batch_bench(int argc, char *argv[]);
+
+/* NUMA 分片基准测试（--shard-bench）
+ * 每个工作线程推进自己的一批游戏，线程轮流分配到各 NUMA 节点并绑定，
+ * 分别由主线程统一分配（共享放置）和由工作线程首次访问分配（本地放置），报告每个节点的吞吐量；
+ * 只有一个节点时只运行本地放置，不按节点绑定线程
+ *   --threads <n>       工作线程数（默认为逻辑 CPU 数）
+ *   --shard-games <n>   每个线程的游戏局数（默认 8192）
+ *   --pin-cpus <列表>   按列表把每个线程绑定到一个 CPU 上（代替按节点绑定）
+ *   --priority <级别>   工作线程的优先级：low、normal、high 或 time_critical
+ */
+SDL_AppResult snake_shard_bench(int argc, char *argv[]);
+
+/* tick 计时检查（--timing-check）
+ * 检查 60 Hz 的 tick 预定时刻在一百万个 tick 之后没有累计误差，
+ * 再实际运行并用 SDL_DelayPrecise 睡到每个 tick，输出 tick 延迟直方图；
+ * 在预定时刻之后 0.5 毫秒内执行的 tick 少于 99% 时失败；默认门槛需要安静的机器并绑定 CPU
+ *   --timing-ticks <n>          实际运行的 tick 数（默认 300，即 5 秒）
+ *   --timing-target-ms <ms>     目标延迟（默认 0.5，按直方图的 50 微秒桶向下取整）
+ *   --timing-min-percent <p>    在目标延迟内执行的 tick 至少占的百分比（默认 99）
+ *   --timing-warn-only          延迟不达标时只输出警告，累计误差仍然检查
+ *   --pin-cpus <列表>           实际运行之前把线程绑定到这些 CPU 上
+ *   --priority <级别>           实际运行之前调整线程优先级
+ */
+SDL_AppResult snake_timing_check(int argc, char *argv[]);
+
+/* 轨迹数据集检查（--trajectory-check）
+ * 录制一段随机对局的轨迹，先只映射奖励和结束两列核对总奖励和局数，
+ * 再按动作列重新模拟，每行的观察必须与模拟的场地一致；
+ * 最后运行一局多人对局，其他玩家死亡时玩家1 的奖励和结束标记不能受影响
+ *   --trajectory-path <path>   数据集文件路径（检查结束后删除）
+ *   --trajectory-ticks <n>     录制的 tick 数（默认 100000）
+ */
+SDL_AppResult snake_trajectory_check(int argc, char *argv[]);
+
+/* 经验回放缓冲区检查（--experience-check）
+ * 用随机对局填满缓冲区并绕过一圈以上，采样解码的转移必须与按浮点数保存的参照一致，
+ * 优先级高 1000 倍的转移被采样的比例必须接近理论值，每个转移的内存至少比浮点数保存少 10 倍
+ *   --experience-capacity <n>   缓冲区容量（默认 16384）
+ */
+SDL_AppResult snake_experience_check(int argc, char *argv[]);
+
+/* 以蛇头为中心的观察检查（--crop-check）
+ * 批量推进一组随机对局，对所有局取出每种奇数边长的窗口并与参照实现比较，
+ * 再比较批量取出（支持时使用 AVX2 收集指令）和逐局取出的耗时
+ *   --crop-games <n>   局数（默认 4096）
+ *   --crop-size <n>    计时使用的窗口边长（奇数，默认 11）
+ */
+SDL_AppResult snake_crop_check(int argc, char *argv[]);
+
+/* 合法动作掩码和危险特征检查（--features-check）
+ * 批量推进一组随机对局（其中一部分为两名玩家），射线距离必须与逐格查找一致，
+ * 单人对局的掩码必须与复制游戏后实际推进一个 tick 的结果一致，再比较位图计算和逐格查找的耗时
+ *   --features-games <n>   局数（默认 4096）
+ */
+SDL_AppResult snake_features_check(int argc, char *argv[]);
+
+#endif /* SNAKE_HEADLESS_H */
@@ -0,0 +1,41 @@
+/*
+ * 回退历史接口
+ * 每个 tick 之后记录一条撤销记录：与上一 tick 相比发生变化的字节段及其旧值
+ * （通常只有几个格子、蛇头蛇尾和计数器），记录按先后写入固定大小的环形缓冲区，
+ * 空间不足时丢弃最旧的记录；回退时按相反顺序恢复旧值，不保存完整的状态副本
+ */
+
+#ifndef SNAKE_HISTORY_H
+#define SNAKE_HISTORY_H
+
+#include <SDL3/SDL.h>
+#include "snake.h"
+
+#define SNAKE_HISTORY_BYTES (256U * 1024U) /* 环形缓冲区大小（2的幂），默认速度下可保存十分钟以上 */
+#define SNAKE_HISTORY_REWIND_TICKS 16      /* 每次按下回退键回退的 tick 数 */
+#define SNAKE_HISTORY_MAX_RECORD (2 * sizeof(SnakeContext) + 16) /* 单条记录的最大长度 */
+
+/* 回退历史 */
+typedef struct
+{
+    Uint8 ring[SNAKE_HISTORY_BYTES];            /* 撤销记录 */
+    Uint32 head;                                /* 下一条记录的写入位置（累计字节数，取模得到下标） */
+    Uint32 tail;                                /* 最旧记录的位置 */
+    Uint32 count;                               /* 记录数量（可以回退的 tick 数） */
+    SnakeContext shadow;                        /* 最后一次记录时的状态，用于比较出变化 */
+    Uint8 scratch[SNAKE_HISTORY_MAX_RECORD];    /* 正在生成的记录 */
+} SnakeHistory;
+
+/* 清空历史，以 ctx 作为起点（重新开始游戏等不经过 snake_step 的整体修改之后调用） */
+void snake_history_reset(SnakeHistory *history, const SnakeContext *ctx);
+
+/* 在 snake_step 之后调用：记录自上次记录以来 ctx 的变化 */
+void snake_history_record(SnakeHistory *history, const SnakeContext *ctx);
+
+/* 回退最多 ticks 个 tick，返回实际回退的数量；上次记录之后对 ctx 的修改一并丢弃 */
+int snake_history_rewind(SnakeHistory *history, SnakeContext *ctx, int ticks);
+
+/* 获取环形缓冲区已使用的字节数 */
+Uint32 snake_history_bytes(const SnakeHistory *history);
+
+#endif /* SNAKE_HISTORY_H */
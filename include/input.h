@@ -0,0 +1,111 @@
+/*
+ * 输入接口
+ * 键盘通过按扫描码索引的绑定表映射为动作（转向、重置、暂停、调速、退出），
+ * 绑定表可以从配置文件加载，每个绑定带有玩家编号；
+ * 手柄（十字键、左摇杆）映射为移动方向，按连接顺序分配给玩家，支持手柄热插拔；
+ * 转向事件先写入每个玩家自己的队列，在 tick 边界依次生效；
+ * 也可以在每次 snake_step 之前直接采样键盘和手柄状态，
+ * 使方向总是取自 tick 边界时刻的按键状态，减少有效输入延迟
+ */
+
+#ifndef SNAKE_INPUT_H
+#define SNAKE_INPUT_H
+
+#include <SDL3/SDL.h>
+#include "snake.h"
+
+#define SNAKE_INPUT_MAX_GAMEPADS 4        /* 同时使用的手柄数量上限 */
+#define SNAKE_INPUT_STICK_DEADZONE 8000   /* 摇杆死区（轴值范围 -32768..32767） */
+#define SNAKE_INPUT_NO_DIRECTION -1       /* 没有对应的方向 */
+#define SNAKE_INPUT_QUEUE_SIZE 4          /* 每个玩家缓存的转向数量 */
+
+/* 按键动作 */
+typedef enum
+{
+    SNAKE_ACTION_NONE,   /* 未绑定 */
+    SNAKE_ACTION_RIGHT,  /* 向右转（四个转向动作与 SnakeDirection 顺序一致） */
+    SNAKE_ACTION_UP,     /* 向上转 */
+    SNAKE_ACTION_LEFT,   /* 向左转 */
+    SNAKE_ACTION_DOWN,   /* 向下转 */
+    SNAKE_ACTION_RESET,  /* 重新开始 */
+    SNAKE_ACTION_PAUSE,  /* 暂停/继续 */
+    SNAKE_ACTION_FASTER, /* 加快速度 */
+    SNAKE_ACTION_SLOWER, /* 减慢速度 */
+    SNAKE_ACTION_REWIND, /* 回退最近的 tick 并暂停 */
+    SNAKE_ACTION_QUIT,   /* 退出游戏 */
+    SNAKE_ACTION_COUNT
+} SnakeAction;
+
+#define SNAKE_ACTION_IS_TURN(action) ((action) >= SNAKE_ACTION_RIGHT && (action) <= SNAKE_ACTION_DOWN)
+#define SNAKE_ACTION_DIRECTION(action) ((SnakeDirection)((action) - SNAKE_ACTION_RIGHT))
+
+/* 绑定表元素：低4位为动作，高4位为玩家编号（从0开始），分发只需一次查表 */
+typedef Uint8 SnakeBinding;
+#define SNAKE_BINDING(action, player) ((SnakeBinding)((action) | ((player) << 4)))
+#define SNAKE_BINDING_ACTION(binding) ((SnakeAction)((binding) & 0x0F))
+#define SNAKE_BINDING_PLAYER(binding) ((binding) >> 4)
+
+/* 输入方式 */
+typedef enum
+{
+    SNAKE_INPUT_EVENTS,  /* 响应按键和手柄事件（默认） */
+    SNAKE_INPUT_SAMPLED, /* 每次 snake_step 之前采样按键和手柄状态 */
+    SNAKE_INPUT_MODE_COUNT
+} SnakeInputMode;
+
+/* 单个玩家的转向队列（环形缓冲区） */
+typedef struct
+{
+    Uint8 dirs[SNAKE_INPUT_QUEUE_SIZE]; /* 等待生效的方向 */
+    Uint8 head;                         /* 队首下标 */
+    Uint8 count;                        /* 队列中的方向数量 */
+} SnakeTurnQueue;
+
+/* 输入状态 */
+typedef struct
+{
+    SnakeInputMode mode;                               /* 输入方式 */
+    SnakeBinding bindings[SDL_SCANCODE_COUNT];         /* 按键绑定表，按扫描码索引 */
+    SDL_Gamepad *gamepads[SNAKE_INPUT_MAX_GAMEPADS];   /* 已打开的手柄 */
+    int stick_dir[SNAKE_INPUT_MAX_GAMEPADS];           /* 手柄左摇杆上一次的方向 */
+    int gamepad_count;                                 /* 已打开的手柄数量 */
+    SnakeTurnQueue queues[SNAKE_MAX_PLAYERS];          /* 每个玩家的转向队列 */
+} SnakeInput;
+
+/* 获取输入方式的名称 */
+const char *snake_input_mode_name(SnakeInputMode mode);
+
+/* 根据名称查找输入方式，找不到时返回 SNAKE_INPUT_MODE_COUNT */
+SnakeInputMode snake_input_mode_from_name(const char *name);
+
+/* 获取动作的名称 */
+const char *snake_action_name(SnakeAction action);
+
+/* 初始化输入状态并设置默认按键绑定（已连接的手柄会以 SDL_EVENT_GAMEPAD_ADDED 事件打开） */
+void snake_input_init(SnakeInput *input, SnakeInputMode mode);
+
+/* 关闭所有手柄 */
+void snake_input_quit(SnakeInput *input);
+
+/* 设置默认按键绑定：玩家1 方向键，玩家2 WASD，玩家3 IJKL，玩家4 小键盘 8456 */
+void snake_input_bind_defaults(SnakeInput *input);
+
+/* 绑定按键，action 为 SNAKE_ACTION_NONE 时解除绑定 */
+void snake_input_bind(SnakeInput *input, SDL_Scancode key_code, SnakeAction action, int player);
+
+/* 按名称绑定按键，例如 ("W", "up:2")，玩家编号从1开始，省略时为1；名称无效时返回 false */
+bool snake_input_bind_named(SnakeInput *input, const char *key_name, const char *value);
+
+/* 摇杆位置对应的方向（取偏移较大的轴），处于死区内时返回 SNAKE_INPUT_NO_DIRECTION */
+int snake_input_stick_direction(Sint16 x, Sint16 y);
+
+/* 把转向写入玩家的队列，队列已满或与最后一个转向相同时丢弃 */
+void snake_input_queue_turn(SnakeInput *input, int player, SnakeDirection dir);
+
+/* 处理手柄事件：热插拔、十字键和摇杆（采样方式下只处理热插拔） */
+void snake_input_handle_event(SnakeInput *input, const SnakeContext *ctx, const SDL_Event *event);
+
+/* 在 snake_step 之前调用：事件方式下应用各玩家队列中的转向，采样方式下读取键盘和手柄的当前状态 */
+void snake_input_tick(SnakeInput *input, SnakeContext *ctx);
+
+#endif /* SNAKE_INPUT_H */
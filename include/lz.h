@@ -0,0 +1,23 @@
+/*
+ * LZ 压缩接口
+ * 面向速度的 LZ77 字节压缩（与 LZ4 块格式类似）：
+ * 数据由若干序列组成，每个序列为 1 字节标记（高4位字面量长度，低4位匹配长度-4），
+ * 长度达到 15 时后跟 255 累加的扩展字节，然后是字面量和 2 字节小端匹配偏移，
+ * 最后一个序列只有字面量；每次压缩都是独立的，不依赖之前的数据
+ */
+
+#ifndef SNAKE_LZ_H
+#define SNAKE_LZ_H
+
+#include <SDL3/SDL.h>
+
+/* 压缩结果的最大长度（数据不可压缩时略大于原长度） */
+#define SNAKE_LZ_BOUND(size) ((size) + (size) / 255 + 16)
+
+/* 压缩 size 字节的 src 到 dst，返回压缩后的长度；dst 容量不足时返回 0 */
+int snake_lz_compress(const Uint8 *src, int size, Uint8 *dst, int capacity);
+
+/* 解压到 dst，返回解压后的长度；数据损坏或 dst 容量不足时返回 -1 */
+int snake_lz_decompress(const Uint8 *src, int size, Uint8 *dst, int capacity);
+
+#endif /* SNAKE_LZ_H */
@@ -0,0 +1,48 @@
+/*
+ * 合法动作掩码和危险特征接口
+ * 为批量中的每局游戏计算一名玩家的合法且安全的转向掩码，以及从蛇头出发 8 个方向上
+ * 到最近的蛇身和食物的距离；计算只使用行占用位图和按实体坐标建立的食物位图，
+ * 通过移位和找最低位完成，不逐格解码场地
+ */
+
+#ifndef SNAKE_MOVE_FEATURES_H
+#define SNAKE_MOVE_FEATURES_H
+
+#include <SDL3/SDL.h>
+#include "snake.h"
+
+/* 射线方向：从向右开始逆时针排列，SnakeDirection d 对应射线 2 * d */
+typedef enum
+{
+    SNAKE_RAY_RIGHT,
+    SNAKE_RAY_UP_RIGHT,
+    SNAKE_RAY_UP,
+    SNAKE_RAY_UP_LEFT,
+    SNAKE_RAY_LEFT,
+    SNAKE_RAY_DOWN_LEFT,
+    SNAKE_RAY_DOWN,
+    SNAKE_RAY_DOWN_RIGHT,
+    SNAKE_RAY_COUNT
+} SnakeRay;
+
+#define SNAKE_RAY_NONE 0 /* 射线上没有找到 */
+
+/* 一批特征，数组由调用者分配：
+ * masks 的第 d 位为 1 表示转向 SnakeDirection d 合法（与 snake_redir 相同，不允许 180 度转弯）
+ * 且下一步不会撞上蛇身；蛇尾在这一步移开时，蛇头可以进入自己的蛇尾格子；
+ * 其他蛇的身体一律视为障碍（不预测它们这一步的移动）；
+ * 射线距离为沿该方向第几格遇到蛇身或食物（包括拾取物），场地相连时射线绕回，
+ * 水平方向最多 SNAKE_GAME_WIDTH - 1 格，竖直和斜向最多 SNAKE_GAME_HEIGHT - 1 格，没有遇到时为 SNAKE_RAY_NONE；
+ * 玩家不在场上时掩码和距离都为 0
+ */
+typedef struct
+{
+    Uint8 *masks;      /* [count] */
+    Uint8 *body_rays;  /* [count][SNAKE_RAY_COUNT] */
+    Uint8 *food_rays;  /* [count][SNAKE_RAY_COUNT] */
+} SnakeFeatures;
+
+/* 计算 count 局连续存放的游戏中 player 的特征 */
+void snake_features_batch(const SnakeContext *games, int count, int player, SnakeFeatures *out);
+
+#endif /* SNAKE_MOVE_FEATURES_H */
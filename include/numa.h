@@ -0,0 +1,43 @@
+/*
+ * NUMA 拓扑接口
+ * 多路服务器上每个节点有自己的内存，线程访问本节点的内存最快；
+ * 从系统读取各节点的 CPU 列表，并把线程绑定到指定节点或指定 CPU 上。
+ * Linux 以外的系统或读取失败时视为只有一个节点，绑定不做任何事
+ */
+
+#ifndef SNAKE_NUMA_H
+#define SNAKE_NUMA_H
+
+#include <SDL3/SDL.h>
+
+#define SNAKE_NUMA_MAX_NODES 16  /* 支持的节点数量上限 */
+#define SNAKE_NUMA_MAX_CPUS 1024 /* 支持的逻辑 CPU 编号上限 */
+
+/* NUMA 拓扑 */
+typedef struct
+{
+    int node_count;                                       /* 节点数量（至少为 1） */
+    int node_ids[SNAKE_NUMA_MAX_NODES];                   /* 系统中的节点编号 */
+    int cpu_count[SNAKE_NUMA_MAX_NODES];                  /* 每个节点的逻辑 CPU 数量（0 表示未知） */
+    Uint64 cpus[SNAKE_NUMA_MAX_NODES][SNAKE_NUMA_MAX_CPUS / 64]; /* 每个节点的 CPU 位图 */
+} SnakeNumaTopology;
+
+/* 读取 NUMA 拓扑，失败时得到一个 CPU 未知的节点 */
+void snake_numa_detect(SnakeNumaTopology *topo);
+
+/* 把调用线程绑定到第 node 个节点（拓扑中的下标）的 CPU 上；不支持或失败时返回 false */
+bool snake_numa_pin_thread(const SnakeNumaTopology *topo, int node);
+
+/* 解析 "0-3,8-11" 形式的 CPU 列表，加入位图 cpus（SNAKE_NUMA_MAX_CPUS 位），返回 CPU 数量；格式错误时返回 -1 */
+int snake_numa_parse_cpulist(const char *text, Uint64 *cpus);
+
+/* 把位图 cpus 格式化为 CPU 列表 */
+void snake_numa_format_cpulist(const Uint64 *cpus, char *text, size_t size);
+
+/* 把调用线程绑定到位图 cpus 中的 CPU 上；不支持或失败时返回 false */
+bool snake_numa_pin_cpus(const Uint64 *cpus);
+
+/* 读取调用线程实际允许运行的 CPU；不支持时返回 false */
+bool snake_numa_current_cpus(Uint64 *cpus);
+
+#endif /* SNAKE_NUMA_H */
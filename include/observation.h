@@ -0,0 +1,27 @@
+/*
+ * 以蛇头为中心的观察接口
+ * 从打包的场地中取出蛇头周围 size × size 的窗口，场地上下、左右相连（与移动时的绕回相同），
+ * 窗口按蛇的朝向旋转：第一行是蛇头前方最远的一行，每行从蛇的左侧到右侧，蛇头位于窗口中心；
+ * 蛇身格子的方向也换算到蛇的朝向（前方为 SNAKE_CELL_SUP，右侧为 SNAKE_CELL_SRIGHT），
+ * 这样同一局面无论蛇朝哪个方向，得到的观察都相同
+ */
+
+#ifndef SNAKE_OBSERVATION_H
+#define SNAKE_OBSERVATION_H
+
+#include <SDL3/SDL.h>
+#include "snake.h"
+
+#define SNAKE_CROP_MAX_SIZE 17 /* 窗口边长上限（奇数，不超过场地高度，绕回时只跨越一次边界） */
+
+/* 取出一局游戏中 player 的窗口，朝向为 next_dir；size 为不超过 SNAKE_CROP_MAX_SIZE 的奇数，
+ * out 为 size × size 个格子（SnakeCell 的值），按行存放；参数无效时返回 false
+ */
+bool snake_crop(const SnakeContext *ctx, int player, int size, Uint8 *out);
+
+/* 对 count 局连续存放的游戏依次取出窗口，结果与逐局调用 snake_crop 相同，
+ * out 为 [count][size × size]；CPU 支持 AVX2 时每次用向量收集指令取出 8 个格子
+ */
+bool snake_crop_batch(const SnakeContext *games, int count, int player, int size, Uint8 *out);
+
+#endif /* SNAKE_OBSERVATION_H */
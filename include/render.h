@@ -0,0 +1,30 @@
+/*
+ * 游戏画面渲染接口
+ * 提供多种渲染策略，所有策略必须输出与逐格绘制完全相同的像素，
+ * 由 --render-check 模式负责校验
+ */
+
+#ifndef SNAKE_RENDER_H
+#define SNAKE_RENDER_H
+
+#include <SDL3/SDL.h>
+#include "snake.h"
+
+/* 渲染策略枚举 */
+typedef enum
+{
+    SNAKE_RENDER_PER_CELL, /* 逐格调用 SDL_RenderFillRect（参考实现） */
+    SNAKE_RENDER_BATCHED,  /* 按颜色分组，一次 SDL_RenderFillRects 提交 */
+    SNAKE_RENDER_STRATEGY_COUNT
+} SnakeRenderStrategy;
+
+/* 获取渲染策略名称（用于命令行参数和日志） */
+const char *snake_render_strategy_name(SnakeRenderStrategy strategy);
+
+/* 根据名称查找渲染策略，找不到时返回 SNAKE_RENDER_STRATEGY_COUNT */
+SnakeRenderStrategy snake_render_strategy_from_name(const char *name);
+
+/* 绘制一帧游戏画面（不调用 SDL_RenderPresent） */
+bool snake_render(SDL_Renderer *renderer, const SnakeContext *ctx, SnakeRenderStrategy strategy);
+
+#endif /* SNAKE_RENDER_H */
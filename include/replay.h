@@ -0,0 +1,106 @@
+/*
+ * 游戏回放接口
+ * 一局游戏由随机种子和按 tick 排序的方向输入完全确定，
+ * 回放时按相同顺序调用 snake_redir 和 snake_step 即可重现
+ *
+ * 长回放可以附带关键帧：每隔固定 tick 数保存一份完整的 SnakeContext，
+ * 跳转时恢复最近的关键帧，最多再执行一个关键帧间隔的 snake_step；
+ * 同时保存每个 tick 的滚动校验和，两次运行不一致时可以定位到第一个出现差异的 tick
+ */
+
+#ifndef SNAKE_REPLAY_H
+#define SNAKE_REPLAY_H
+
+#include <SDL3/SDL.h>
+#include "snake.h"
+
+/* 单条输入记录：在第 tick 次 snake_step 之前改变方向 */
+typedef struct
+{
+    Uint32 tick;    /* 输入生效的 tick */
+    Uint8 dir;      /* SnakeDirection */
+} SnakeReplayInput;
+
+/* 脚本化回放 */
+typedef struct
+{
+    const char *name;               /* 回放名称 */
+    Uint64 seed;                    /* 随机种子 */
+    Uint32 ticks;                   /* 回放总 tick 数 */
+    const SnakeReplayInput *inputs; /* 按 tick 升序排列的输入 */
+    int input_count;                /* 输入数量 */
+} SnakeReplay;
+
+/* 回放播放器 */
+typedef struct
+{
+    const SnakeReplay *replay; /* 正在播放的回放 */
+    Uint32 tick;               /* 已执行的 tick 数 */
+    int cursor;                /* 下一条待应用的输入 */
+} SnakeReplayPlayer;
+
+/* 关键帧索引项：tick 到快照的映射 */
+typedef struct
+{
+    Uint32 tick;   /* 关键帧的 tick（关键帧间隔的整数倍） */
+    Uint32 cursor; /* 此时下一条待应用的输入 */
+    Uint64 offset; /* 快照在回放文件中的偏移 */
+} SnakeReplayKeyframe;
+
+/* 带关键帧的回放
+ * 由 snake_replay_build_keyframes 在内存中生成，或由 snake_replay_open 从文件打开；
+ * 从文件打开时只读取输入、索引和校验和，快照在跳转时按偏移读取；
+ * 文件中快照的布局指纹与本程序不同时不使用快照，跳转时从头模拟
+ */
+typedef struct
+{
+    SnakeReplay replay;              /* 种子、长度和输入 */
+    SnakeReplayInput *input_storage; /* 从文件读取的输入（内存中生成时为 NULL） */
+    Uint32 keyframe_interval;        /* 关键帧间隔（tick） */
+    Uint32 keyframe_count;           /* 关键帧数量 */
+    SnakeReplayKeyframe *keyframes;  /* 关键帧索引，第 i 项对应 tick = i * keyframe_interval */
+    SnakeContext *states;            /* 内存中的快照（从文件打开时为 NULL） */
+    Uint32 *checksums;               /* 第 t 项为执行 t 个 tick 之后的滚动校验和（共 ticks + 1 项） */
+    SDL_IOStream *io;                /* 打开的回放文件（内存中生成时为 NULL） */
+    bool snapshots;                  /* 快照可以恢复（内存中生成，或文件中的布局指纹与本程序相同） */
+} SnakeReplayArchive;
+
+#define SNAKE_REPLAY_KEYFRAME_INTERVAL 1024 /* 默认关键帧间隔 */
+
+/* 开始播放：使用回放的种子初始化游戏状态 */
+void snake_replay_start(SnakeReplayPlayer *player, const SnakeReplay *replay, SnakeContext *ctx);
+
+/* 推进一个 tick：应用该 tick 的输入后调用 snake_step
+ * 回放结束时返回 false
+ */
+bool snake_replay_step(SnakeReplayPlayer *player, SnakeContext *ctx);
+
+/* 生成随机输入：每个 tick 以 1/turn_chance 的概率转向，返回输入数量（inputs 至少能容纳 ticks 项） */
+int snake_replay_random_inputs(SnakeReplayInput *inputs, Uint32 ticks, Uint64 seed, int turn_chance);
+
+/* 完整模拟一遍回放，每 interval 个 tick 保存一个关键帧，并记录每个 tick 的滚动校验和；
+ * archive 引用 replay 的输入
+ */
+bool snake_replay_build_keyframes(SnakeReplayArchive *archive, const SnakeReplay *replay, Uint32 interval);
+
+/* 把回放、关键帧和索引写入文件
+ * 快照按 SnakeContext 的内存布局保存，文件头记录布局指纹，只能由指纹相同的程序恢复；其他程序仍可读取输入和校验和
+ */
+bool snake_replay_save(const SnakeReplayArchive *archive, const char *path);
+
+/* 打开回放文件：读取输入、关键帧索引和校验和，文件在 snake_replay_close 之前保持打开
+ * 输入和校验和与 SnakeContext 的布局无关；文件头中的布局指纹（每个字段的名称、偏移和大小）
+ * 与本程序不同时 snapshots 为 false，字段重新排列但大小不变的情况也能识别
+ */
+bool snake_replay_open(SnakeReplayArchive *archive, const char *path);
+
+/* 释放回放占用的内存并关闭文件 */
+void snake_replay_close(SnakeReplayArchive *archive);
+
+/* 跳转到指定 tick（超出回放长度时跳到结尾）：
+ * 恢复不晚于该 tick 的最近关键帧，再执行剩余的 tick（快照不可用时从头执行）；
+ * player 可以是清零的（尚未开始播放），向前跳转距离小于关键帧时从当前位置继续执行
+ */
+bool snake_replay_seek(SnakeReplayPlayer *player, SnakeReplayArchive *archive, SnakeContext *ctx, Uint32 tick);
+
+#endif /* SNAKE_REPLAY_H */
@@ -0,0 +1,70 @@
+/*
+ * 流式回放接口
+ * 用于长时间运行（浸泡测试）的对局录制：输入按固定大小分块，每块独立用 LZ 压缩，
+ * 文件末尾附带块索引，读取端可以直接定位到任意块；
+ * 写入端由后台线程压缩和写文件，读取端按需解压，两端占用的内存都与回放长度无关
+ *
+ * 文件布局：
+ *   文件头   magic "SNKS"、版本、随机种子
+ *   块       块头（首个输入的 tick、输入数量、原始长度、压缩长度）+ 数据，
+ *            原始数据为 (与上一输入的 tick 差的变长编码, 方向) 序列；
+ *            压缩长度等于原始长度时数据未压缩
+ *   索引     每块一项（首个输入的 tick、输入数量、块偏移）
+ *   文件尾   索引偏移、总 tick 数、magic "SNKE"
+ * 没有文件尾的文件（录制中途退出）通过依次扫描块头读取
+ */
+
+#ifndef SNAKE_REPLAY_STREAM_H
+#define SNAKE_REPLAY_STREAM_H
+
+#include <SDL3/SDL.h>
+#include "replay.h"
+
+#define SNAKE_REPLAY_CHUNK_SIZE 65536   /* 每块原始数据的长度上限（字节） */
+#define SNAKE_REPLAY_WRITER_BUFFERS 4   /* 写入端的块缓冲区数量（一个正在填充，其余等待压缩） */
+
+/* 写入端统计 */
+typedef struct
+{
+    Uint32 inputs;         /* 输入数量 */
+    Uint32 chunks;         /* 块数量 */
+    Uint64 raw_bytes;      /* 块数据压缩前的总长度 */
+    Uint64 stored_bytes;   /* 块数据写入文件的总长度 */
+    Uint32 stalls;         /* 缓冲区全部在等待压缩、录制线程被迫等待的次数 */
+} SnakeReplayWriterStats;
+
+typedef struct SnakeReplayWriter SnakeReplayWriter;
+typedef struct SnakeReplayReader SnakeReplayReader;
+
+/* 创建回放文件并启动后台写入线程，失败时返回 NULL */
+SnakeReplayWriter *snake_replay_writer_open(const char *path, Uint64 seed);
+
+/* 记录一条输入（tick 不能小于上一条），块写满时交给后台线程，不等待压缩和写文件 */
+void snake_replay_writer_record(SnakeReplayWriter *writer, Uint32 tick, SnakeDirection dir);
+
+/* 写出剩余的输入、索引和文件尾并释放写入端，stats 可以为 NULL；任何写入失败时返回 false */
+bool snake_replay_writer_close(SnakeReplayWriter *writer, Uint32 ticks, SnakeReplayWriterStats *stats);
+
+/* 打开回放文件并读取块索引，失败时返回 NULL */
+SnakeReplayReader *snake_replay_reader_open(const char *path);
+
+/* 关闭回放文件并释放读取端 */
+void snake_replay_reader_close(SnakeReplayReader *reader);
+
+/* 获取随机种子和总 tick 数（没有文件尾时为最后一条输入的 tick + 1） */
+Uint64 snake_replay_reader_seed(const SnakeReplayReader *reader);
+Uint32 snake_replay_reader_ticks(const SnakeReplayReader *reader);
+
+/* 读取下一条输入（需要时解压下一块），没有更多输入或数据损坏时返回 false */
+bool snake_replay_reader_next(SnakeReplayReader *reader, SnakeReplayInput *input);
+
+/* 定位到第一条 tick 不小于给定值的输入：按索引二分查找所在的块，只解压这一块 */
+bool snake_replay_reader_seek(SnakeReplayReader *reader, Uint32 tick);
+
+/* 从头播放：使用回放的种子初始化游戏状态，并定位到第一条输入 */
+void snake_replay_reader_start(SnakeReplayReader *reader, SnakeContext *ctx);
+
+/* 推进一个 tick：应用该 tick 的输入后调用 snake_step，回放结束时返回 false */
+bool snake_replay_reader_step(SnakeReplayReader *reader, SnakeContext *ctx);
+
+#endif /* SNAKE_REPLAY_STREAM_H */
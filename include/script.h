@@ -0,0 +1,95 @@
+/*
+ * 协程脚本接口
+ * 用 C++20 协程编写"等待 N 个 tick、在某处生成食物、显示提示文字"这类脚本，
+ * 由调度器在每次 snake_step 之前按 tick 恢复执行，不需要在 SDL_AppIterate 中维护状态机
+ *
+ * 协程帧从固定大小的内存池分配，脚本挂起期间每个 tick 不产生任何堆分配
+ */
+
+#ifndef SNAKE_SCRIPT_H
+#define SNAKE_SCRIPT_H
+
+#include <coroutine>
+#include <SDL3/SDL.h>
+#include "snake.h"
+
+#define SNAKE_SCRIPT_MAX_TASKS 8   /* 同时运行的脚本数量上限 */
+#define SNAKE_SCRIPT_FRAME_SIZE 512 /* 单个协程帧的最大字节数 */
+#define SNAKE_SCRIPT_TEXT_SIZE 64  /* 提示文字的最大长度 */
+
+struct SnakeScriptScheduler;
+
+/* 脚本协程的返回类型
+ * 脚本创建后处于挂起状态，交给调度器后才开始执行
+ */
+struct SnakeScript
+{
+    struct promise_type
+    {
+        SnakeScriptScheduler *sched; /* 所属调度器 */
+        Uint64 wake_tick;            /* 下一次恢复执行的 tick */
+
+        /* 协程帧从脚本内存池分配，池耗尽时返回空指针 */
+        static void *operator new(size_t size) noexcept;
+        static void operator delete(void *ptr, size_t size) noexcept;
+        static SnakeScript get_return_object_on_allocation_failure() noexcept { return SnakeScript{}; }
+
+        SnakeScript get_return_object() noexcept
+        {
+            return SnakeScript{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {}
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/* 等待指定数量的 tick：co_await SnakeWaitTicks{n} */
+struct SnakeWaitTicks
+{
+    Uint32 ticks;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<SnakeScript::promise_type> h) const noexcept;
+    void await_resume() const noexcept {}
+};
+
+/* 脚本调度器 */
+struct SnakeScriptScheduler
+{
+    std::coroutine_handle<SnakeScript::promise_type> tasks[SNAKE_SCRIPT_MAX_TASKS]; /* 运行中的脚本 */
+    int task_count;                      /* 运行中的脚本数量 */
+    Uint64 tick;                         /* 当前 tick（每次 snake_step 前加一） */
+    SnakeContext *ctx;                   /* 脚本操作的游戏状态 */
+    char text[SNAKE_SCRIPT_TEXT_SIZE];   /* 当前提示文字 */
+    Uint64 text_until_tick;              /* 提示文字的显示截止 tick */
+};
+
+/* 脚本入口函数 */
+typedef SnakeScript (*SnakeScriptFunc)(SnakeScriptScheduler *sched);
+
+/* 初始化调度器 */
+void snake_script_init(SnakeScriptScheduler *sched, SnakeContext *ctx);
+
+/* 启动脚本，调度器已满或协程帧分配失败时返回 false */
+bool snake_script_start(SnakeScriptScheduler *sched, SnakeScript script);
+
+/* 根据名称启动内置脚本，找不到时返回 false */
+bool snake_script_start_named(SnakeScriptScheduler *sched, const char *name);
+
+/* 在 snake_step 之前调用：恢复所有到期的脚本并回收已结束的脚本 */
+void snake_script_tick(SnakeScriptScheduler *sched);
+
+/* 销毁所有运行中的脚本 */
+void snake_script_quit(SnakeScriptScheduler *sched);
+
+/* 显示提示文字，持续 ticks 个 tick */
+void snake_script_show_text(SnakeScriptScheduler *sched, const char *text, Uint32 ticks);
+
+/* 获取当前应显示的提示文字，没有时返回 NULL */
+const char *snake_script_text(const SnakeScriptScheduler *sched);
+
+#endif /* SNAKE_SCRIPT_H */
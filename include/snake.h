@@ -0,0 +1,221 @@
+/*
+ * 贪吃蛇游戏核心逻辑接口
+ * 游戏状态使用位压缩存储，与渲染、输入等模块无关，
+ * 可以在无窗口环境下单独运行（例如回放和渲染回归检查）
+ */
+
+#ifndef SNAKE_H
+#define SNAKE_H
+
+#include <SDL3/SDL.h>
+
+/* 游戏基本参数设置 */
+#define STEP_RATE_IN_MILLISECONDS 125 /* 游戏更新时间步长（毫秒） */
+#define SNAKE_BLOCK_SIZE_IN_PIXELS 24 /* 蛇身方块大小（像素） */
+#define SDL_WINDOW_WIDTH (SNAKE_BLOCK_SIZE_IN_PIXELS * SNAKE_GAME_WIDTH)
+#define SDL_WINDOW_HEIGHT (SNAKE_BLOCK_SIZE_IN_PIXELS * SNAKE_GAME_HEIGHT)
+
+/* 游戏场地大小设置 */
+#define SNAKE_GAME_WIDTH 24U  /* 游戏场地宽度（格子数） */
+#define SNAKE_GAME_HEIGHT 18U /* 游戏场地高度（格子数） */
+#define SNAKE_MATRIX_SIZE (SNAKE_GAME_WIDTH * SNAKE_GAME_HEIGHT)
+
+/* 位操作相关的常量定义 */
+#define THREE_BITS 0x7U /* 用于位操作的3位掩码，用于提取单元格状态 */
+#define SHIFT(x, y) (((x) + ((y) * SNAKE_GAME_WIDTH)) * SNAKE_CELL_MAX_BITS)
+
+/* 单元格状态枚举
+ * 使用3位二进制表示不同的单元格状态
+ * 0: 空单元格
+ * 1-4: 蛇身体（不同方向）
+ * 5: 食物或拾取物（具体种类见实体存储）
+ */
+typedef enum
+{
+    SNAKE_CELL_NOTHING = 0U, /* 空单元格 */
+    SNAKE_CELL_SRIGHT = 1U,  /* 蛇身体向右 */
+    SNAKE_CELL_SUP = 2U,     /* 蛇身体向上 */
+    SNAKE_CELL_SLEFT = 3U,   /* 蛇身体向左 */
+    SNAKE_CELL_SDOWN = 4U,   /* 蛇身体向下 */
+    SNAKE_CELL_FOOD = 5U     /* 食物或拾取物 */
+} SnakeCell;
+
+#define SNAKE_CELL_MAX_BITS 3U /* 表示一个单元格状态所需的位数 */
+#define SNAKE_CELLS_BYTES ((SNAKE_MATRIX_SIZE * SNAKE_CELL_MAX_BITS) / 8U) /* 打包后的场地字节数 */
+
+/* 蛇的移动方向枚举 */
+typedef enum
+{
+    SNAKE_DIR_RIGHT, /* 向右移动 */
+    SNAKE_DIR_UP,    /* 向上移动 */
+    SNAKE_DIR_LEFT,  /* 向左移动 */
+    SNAKE_DIR_DOWN   /* 向下移动 */
+} SnakeDirection;
+
+#define SNAKE_MAX_PLAYERS 4 /* 同一场地上的蛇（本地玩家）数量上限 */
+
+#define SNAKE_CACHE_LINE 64 /* 缓存行大小（字节），用于状态结构的对齐 */
+
+/* snake_step 产生的事件（位掩码，所有玩家合并），供音效等模块使用 */
+#define SNAKE_EVENT_ATE 0x01U    /* 吃到食物 */
+#define SNAKE_EVENT_PICKUP 0x02U /* 吃到拾取物 */
+#define SNAKE_EVENT_TURNED 0x04U /* 改变了移动方向 */
+#define SNAKE_EVENT_DIED 0x08U   /* 撞到自己，游戏重置 */
+#define SNAKE_EVENT_WON 0x10U    /* 占满场地，游戏重置 */
+
+/* 实体容量（食物、拾取物、特效） */
+#define SNAKE_MAX_FOODS 64
+#define SNAKE_MAX_PICKUPS 16
+#define SNAKE_MAX_EFFECTS 32
+#define SNAKE_MAX_ENTITIES (SNAKE_MAX_FOODS + SNAKE_MAX_PICKUPS + SNAKE_MAX_EFFECTS)
+#define SNAKE_ENTITY_NO_SLOT 0xFFU /* 格子上没有实体 */
+
+/* 实体句柄：低16位为槽位，高16位为代数，槽位复用后旧句柄自动失效 */
+typedef Uint32 SnakeEntity;
+#define SNAKE_ENTITY_INVALID 0U
+
+/* 到期队列元素：实体在 due_tick 时到期 */
+typedef struct
+{
+    Uint32 due_tick;    /* 到期的 tick */
+    SnakeEntity entity; /* 到期的实体（可能已被吃掉，弹出时按代数校验） */
+} SnakeExpiry;
+
+#define SNAKE_MAX_EXPIRIES (SNAKE_MAX_FOODS + SNAKE_MAX_PICKUPS)
+
+/* 实体种类，每种实体的组件存放在各自的稠密数组中 */
+typedef enum
+{
+    SNAKE_ENTITY_FOOD,   /* 食物：吃掉后蛇身增长并补充新食物 */
+    SNAKE_ENTITY_PICKUP, /* 拾取物：只加分，不增长 */
+    SNAKE_ENTITY_EFFECT, /* 特效：不占格子，计时结束后自动销毁 */
+    SNAKE_ENTITY_KIND_COUNT
+} SnakeEntityKind;
+
+/* 实体存储
+ * 每种实体的组件按结构数组（SoA）紧密排列，删除时用最后一个元素填补空位，
+ * 每 tick 的系统只遍历这些连续数组，不扫描整个场地；
+ * 可拾取的实体（食物、拾取物）通过 cell_slot 从格子反查
+ */
+typedef struct
+{
+    /* 每 tick 都检查的计数和到期堆放在最前面，与堆顶共用缓存行 */
+    Uint8 count[SNAKE_ENTITY_KIND_COUNT];  /* 每种实体的数量 */
+    Uint8 expiry_count;                    /* 到期堆中的元素数量 */
+    Uint8 free_count;                      /* 空闲槽位数量 */
+
+    /* 到期最小堆：按 due_tick 排序，每 tick 只处理堆顶已到期的实体 */
+    SnakeExpiry expiry[SNAKE_MAX_EXPIRIES];
+
+    /* 句柄表：槽位 → 种类和稠密数组下标 */
+    Uint16 generation[SNAKE_MAX_ENTITIES]; /* 槽位代数（从1开始） */
+    Uint8 kind[SNAKE_MAX_ENTITIES];        /* 槽位中实体的种类 */
+    Uint8 dense[SNAKE_MAX_ENTITIES];       /* 槽位中实体在稠密数组中的下标 */
+    Uint8 free_slots[SNAKE_MAX_ENTITIES];  /* 空闲槽位栈 */
+
+    /* 食物组件 */
+    Uint8 food_x[SNAKE_MAX_FOODS];
+    Uint8 food_y[SNAKE_MAX_FOODS];
+    Uint8 food_value[SNAKE_MAX_FOODS]; /* 分值 */
+    Uint8 food_slot[SNAKE_MAX_FOODS];  /* 反查槽位 */
+    Uint16 food_lifetime[SNAKE_MAX_FOODS]; /* 存活 tick 数，到期后移动到新位置（0 表示永久） */
+
+    /* 拾取物组件 */
+    Uint8 pickup_x[SNAKE_MAX_PICKUPS];
+    Uint8 pickup_y[SNAKE_MAX_PICKUPS];
+    Uint8 pickup_value[SNAKE_MAX_PICKUPS];
+    Uint8 pickup_slot[SNAKE_MAX_PICKUPS];
+    Uint16 pickup_lifetime[SNAKE_MAX_PICKUPS]; /* 存活 tick 数，到期后消失（0 表示永久） */
+
+    /* 特效组件 */
+    Uint8 effect_x[SNAKE_MAX_EFFECTS];
+    Uint8 effect_y[SNAKE_MAX_EFFECTS];
+    Uint8 effect_ticks_left[SNAKE_MAX_EFFECTS]; /* 剩余显示的 tick 数 */
+    Uint8 effect_slot[SNAKE_MAX_EFFECTS];
+
+    /* 格子 → 槽位交叉引用 */
+    Uint8 cell_slot[SNAKE_MATRIX_SIZE];
+} SnakeEntities;
+
+/* 单条蛇的状态 */
+typedef struct
+{
+    char head_xpos;           /* 蛇头X坐标 */
+    char head_ypos;           /* 蛇头Y坐标 */
+    char tail_xpos;           /* 蛇尾X坐标 */
+    char tail_ypos;           /* 蛇尾Y坐标 */
+    char next_dir;            /* 下一步移动方向 */
+    char inhibit_tail_step;   /* 抑制蛇尾移动的计数器（用于实现蛇身增长） */
+    bool alive;               /* 是否在场上（多人模式下死亡后等待出生点空出再复活） */
+    unsigned score;           /* 得分（吃到食物和拾取物累加分值） */
+} SnakePlayer;
+
+/* 蛇的状态上下文结构
+ * 使用位压缩存储游戏场地状态，每个单元格用3位表示；
+ * 多条蛇共用同一场地，蛇身格子属于哪条蛇记录在 owner 中
+ *
+ * 布局按访问频率排列：每个 tick 都读写的计数器和蛇放在第一条缓存行，
+ * 场地从缓存行边界开始，只在吃到东西时访问的实体存储放在最后；
+ * 结构按缓存行对齐，堆上分配时需使用 SDL_aligned_alloc(SNAKE_CACHE_LINE, ...)
+ */
+typedef struct
+{
+    /* 热数据：每个 tick 都会访问 */
+    Uint64 rng_state;         /* 食物位置的随机数状态，固定种子即可完整重现一局游戏 */
+    Uint32 tick;              /* 本局已执行的 tick 数 */
+    unsigned occupied_cells;   /* 已占用的单元格数量 */
+    Uint16 free_cells;        /* 空格子数量 */
+    Uint8 events;             /* 最近一次 snake_step 产生的事件（SNAKE_EVENT_*） */
+    int player_count;         /* 玩家数量 */
+    SnakePlayer players[SNAKE_MAX_PLAYERS]; /* 各玩家的蛇，players[0] 为单人模式的蛇 */
+
+    /* 场地：snake_cell_at 一次读取2字节，cells 之后必须还有其他字段 */
+    alignas(SNAKE_CACHE_LINE) unsigned char cells[SNAKE_CELLS_BYTES]; /* 游戏场地状态数组 */
+    Uint32 occupied_rows[SNAKE_GAME_HEIGHT]; /* 每行的占用位图，用于常数时间挑选空格子 */
+    Uint8 owner[SNAKE_MATRIX_SIZE]; /* 蛇身格子所属的玩家（格子为空或食物时无意义） */
+
+    /* 冷数据：只在生成或吃掉实体时访问 */
+    SnakeEntities entities;   /* 食物、拾取物和特效 */
+} SnakeContext;
+
+/* 获取指定位置的单元格状态 */
+SnakeCell snake_cell_at(const SnakeContext *ctx, char x, char y);
+
+/* 游戏初始化函数（保留 rng_state 和玩家数量，使重置后的随机序列可重现） */
+void snake_initialize(SnakeContext *ctx);
+
+/* 使用指定随机种子初始化单人游戏 */
+void snake_initialize_seeded(SnakeContext *ctx, Uint64 seed);
+
+/* 设置玩家数量（1 到 SNAKE_MAX_PLAYERS）并重新开始游戏 */
+void snake_set_player_count(SnakeContext *ctx, int count);
+
+/* 在指定空格子上生成食物，格子已被占用或食物已满时返回 false */
+bool snake_spawn_food(SnakeContext *ctx, char x, char y);
+
+/* 在指定空格子上生成限时食物，lifetime 个 tick 后移动到新的随机空格子 */
+bool snake_spawn_timed_food(SnakeContext *ctx, char x, char y, Uint16 lifetime);
+
+/* 在指定空格子上生成拾取物，格子已被占用或拾取物已满时返回 false */
+bool snake_spawn_pickup(SnakeContext *ctx, char x, char y, Uint8 value);
+
+/* 改变玩家1的蛇的移动方向（不允许180度转弯） */
+void snake_redir(SnakeContext *ctx, SnakeDirection dir);
+
+/* 改变指定玩家的蛇的移动方向（不允许180度转弯） */
+void snake_player_redir(SnakeContext *ctx, int player, SnakeDirection dir);
+
+/* 更新所有蛇的状态：移动、碰撞检测和食物收集
+ * 单人模式下撞到蛇身会重置整局游戏；多人模式下只有撞上的蛇被移除，之后在出生点复活
+ */
+void snake_step(SnakeContext *ctx);
+
+/* 计算游戏状态的校验和：场地、蛇身格子的所属玩家、各玩家、实体组件（食物和拾取物的位置、分值和存活时间，
+ * 特效的剩余 tick 数）、到期堆、计数器和随机数状态；逐字段计算，与结构体布局无关，每 tick 计算一次的开销很小
+ */
+Uint32 snake_checksum(const SnakeContext *ctx);
+
+/* 滚动校验和：把当前状态的校验和合并到之前所有 tick 的滚动校验和中（初值为 0） */
+Uint32 snake_checksum_roll(Uint32 rolling, const SnakeContext *ctx);
+
+#endif /* SNAKE_H */
@@ -0,0 +1,37 @@
+/*
+ * 线程策略接口
+ * 把线程绑定到指定的 CPU 并调整优先级，使系统繁忙时 tick 的延迟仍然可预测；
+ * 主线程（游戏模拟和渲染）的策略来自配置文件，工作线程的策略来自命令行，
+ * 应用之后读回并报告实际生效的 CPU 和优先级
+ */
+
+#ifndef SNAKE_THREAD_POLICY_H
+#define SNAKE_THREAD_POLICY_H
+
+#include <SDL3/SDL.h>
+#include "numa.h"
+
+/* 线程策略 */
+typedef struct
+{
+    Uint64 cpus[SNAKE_NUMA_MAX_CPUS / 64]; /* 允许运行的 CPU 位图 */
+    int cpu_count;                         /* CPU 数量（0 表示不绑定） */
+    SDL_ThreadPriority priority;           /* 优先级 */
+    bool set_priority;                     /* 是否调整优先级（否则保持系统默认） */
+} SnakeThreadPolicy;
+
+/* 初始化为不绑定、不调整优先级 */
+void snake_thread_policy_init(SnakeThreadPolicy *policy);
+
+/* 设置一项：cpus = <CPU 列表，例如 2 或 0-3,8>，priority = low | normal | high | time_critical；
+ * 无法识别或值无效时返回 false
+ */
+bool snake_thread_policy_set(SnakeThreadPolicy *policy, const char *key, const char *value);
+
+/* 把策略应用到调用线程，并报告实际生效的设置（name 为日志中的线程名）；
+ * index < 0 时绑定到整个 CPU 列表，否则只绑定到列表中的第 index 个 CPU（按列表循环），
+ * 使每个工作线程独占一个核心；任一项失败时返回 false，其余项仍然应用
+ */
+bool snake_thread_policy_apply(const SnakeThreadPolicy *policy, int index, const char *name);
+
+#endif /* SNAKE_THREAD_POLICY_H */
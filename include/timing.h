@@ -0,0 +1,92 @@
+/*
+ * 计时接口
+ * tick 调度使用纳秒时钟，周期以 32.32 定点纳秒保存，小数部分逐 tick 累加，
+ * 非整数毫秒的速率（例如 60 Hz）长时间运行也不会漂移；
+ * 直方图记录 tick 实际执行时刻与预定时刻之差等耗时分布
+ */
+
+#ifndef SNAKE_TIMING_H
+#define SNAKE_TIMING_H
+
+#include <SDL3/SDL.h>
+
+#define SNAKE_HISTOGRAM_BUCKETS 64 /* 直方图的桶数，超出范围的样本计入最后一个桶 */
+#define SNAKE_TICK_JITTER_TARGET_NS 500000U /* tick 应在预定时刻之后 0.5 毫秒内执行 */
+
+/* 等宽分桶的耗时直方图 */
+typedef struct
+{
+    Uint64 bucket_ns;                          /* 每个桶的宽度（纳秒） */
+    Uint32 buckets[SNAKE_HISTOGRAM_BUCKETS];   /* 各桶的样本数 */
+    Uint64 count;                              /* 样本总数 */
+    Uint64 sum_ns;                             /* 样本之和 */
+    Uint64 max_ns;                             /* 最大样本 */
+} SnakeHistogram;
+
+/* tick 定时器 */
+typedef struct
+{
+    Uint64 period_fp;       /* tick 周期（32.32 定点纳秒） */
+    Uint64 due_ns;          /* 下一个 tick 的预定时刻（整数部分） */
+    Uint32 due_frac;        /* 下一个 tick 的预定时刻（小数部分） */
+    SnakeHistogram jitter;  /* tick 实际执行时刻晚于预定时刻的时间 */
+} SnakeTickClock;
+
+/* 画面呈现统计：相邻两次呈现的间隔，以及按预期间隔计算的掉帧数 */
+typedef struct
+{
+    Uint64 target_ns;          /* 预期的呈现间隔（0 表示不限制帧率，不统计掉帧） */
+    Uint64 last_ns;            /* 上一次呈现的时刻（0 表示还没有呈现过） */
+    Uint64 frames;             /* 呈现次数 */
+    Uint64 missed;             /* 掉帧数：间隔超过预期时错过的刷新次数之和 */
+    SnakeHistogram intervals;  /* 呈现间隔 */
+} SnakePresentStats;
+
+/* 清空直方图，每个桶的宽度为 bucket_ns */
+void snake_histogram_init(SnakeHistogram *histogram, Uint64 bucket_ns);
+
+/* 记录一个样本 */
+void snake_histogram_add(SnakeHistogram *histogram, Uint64 ns);
+
+/* 估计第 p 百分位（0 到 100），返回所在桶的上界 */
+Uint64 snake_histogram_percentile(const SnakeHistogram *histogram, double p);
+
+/* 小于 ns 的样本所占的比例（ns 向下取整到桶的边界） */
+double snake_histogram_fraction_below(const SnakeHistogram *histogram, Uint64 ns);
+
+/* 输出摘要和各非空桶的样本数，每行以 name 开头 */
+void snake_histogram_log(const SnakeHistogram *histogram, const char *name);
+
+/* 清空呈现统计，预期间隔为 target_ns（0 表示不统计掉帧） */
+void snake_present_stats_init(SnakePresentStats *stats, Uint64 target_ns);
+
+/* 在每次呈现之后调用，记录与上一次呈现的间隔 */
+void snake_present_stats_record(SnakePresentStats *stats, Uint64 now_ns);
+
+/* 输出呈现间隔直方图和掉帧数，mode 为画面节奏模式的名称 */
+void snake_present_stats_log(const SnakePresentStats *stats, const char *mode);
+
+/* 初始化定时器：周期为 period_ns，第一个 tick 在 now_ns 之后一个周期 */
+void snake_clock_init(SnakeTickClock *clock, Uint64 period_ns, Uint64 now_ns);
+
+/* 按每秒 hz 个 tick 设置周期（可以不是整数纳秒），已预定的下一个 tick 不变 */
+void snake_clock_set_rate(SnakeTickClock *clock, double hz);
+
+/* 把周期乘以 num / den 并限制在 [min_ns, max_ns] 内 */
+void snake_clock_scale(SnakeTickClock *clock, Uint64 num, Uint64 den, Uint64 min_ns, Uint64 max_ns);
+
+/* 获取周期（纳秒，向下取整） */
+Uint64 snake_clock_period_ns(const SnakeTickClock *clock);
+
+/* 从 now_ns 重新开始计时（暂停期间每帧调用），下一个 tick 在一个周期之后 */
+void snake_clock_restart(SnakeTickClock *clock, Uint64 now_ns);
+
+/* 下一个 tick 已经到期时记录延迟、把预定时刻推进一个周期并返回 true，
+ * 在循环中调用直到返回 false，可以补上错过的 tick
+ */
+bool snake_clock_tick(SnakeTickClock *clock, Uint64 now_ns);
+
+/* 获取下一个 tick 的预定时刻（纳秒，向上取整） */
+Uint64 snake_clock_due(const SnakeTickClock *clock);
+
+#endif /* SNAKE_TIMING_H */
@@ -0,0 +1,93 @@
+/*
+ * 轨迹数据集接口
+ * 把对局按 tick 导出为离线训练数据：每行包含观察（3 位一格的场地，与 SnakeContext::cells 相同）、
+ * 动作、奖励和结束标志；行按固定数量分块，块内每一列连续存放，文件末尾附带块索引，
+ * 读取端可以只映射需要的列（例如只读奖励），不必读取或解码其他列
+ *
+ * 文件布局（小端）：
+ *   文件头   magic "SNKT"、版本、场地宽高、每格位数、观察字节数、每块行数，补齐到 64 字节
+ *   块       依次为观察、动作、奖励、结束四列，每列从 64 字节边界开始：
+ *              观察  行数 × 观察字节数
+ *              动作  每行 1 字节（SnakeDirection，SNAKE_TRAJECTORY_NO_ACTION 表示不转向）
+ *              奖励  每行一个 32 位浮点数
+ *              结束  每行 1 位（第 i 行在第 i / 8 字节的第 i % 8 位）
+ *   索引     每块一项（首行编号、行数、每列的偏移和长度）
+ *   文件尾   索引偏移、总行数、块数量、magic "SNTE"
+ * 写入端用两个块缓冲区：录制线程填充一个，后台线程写出另一个
+ */
+
+#ifndef SNAKE_TRAJECTORY_H
+#define SNAKE_TRAJECTORY_H
+
+#include <SDL3/SDL.h>
+#include "snake.h"
+
+#define SNAKE_TRAJECTORY_CHUNK_ROWS 4096  /* 每块的行数 */
+#define SNAKE_TRAJECTORY_ALIGN 64         /* 列在文件中的对齐 */
+#define SNAKE_TRAJECTORY_NO_ACTION 0xFF   /* 这个 tick 没有转向 */
+#define SNAKE_TRAJECTORY_OBS_BYTES SNAKE_CELLS_BYTES /* 每行观察的字节数 */
+
+/* 列 */
+typedef enum
+{
+    SNAKE_TRAJECTORY_OBS,
+    SNAKE_TRAJECTORY_ACTION,
+    SNAKE_TRAJECTORY_REWARD,
+    SNAKE_TRAJECTORY_DONE,
+    SNAKE_TRAJECTORY_COLUMN_COUNT
+} SnakeTrajectoryColumn;
+
+/* 写入端统计 */
+typedef struct
+{
+    Uint64 rows;           /* 行数 */
+    Uint32 chunks;         /* 块数量 */
+    Uint64 bytes;          /* 写入文件的总字节数 */
+    Uint32 stalls;         /* 两个缓冲区都在使用、录制线程被迫等待的次数 */
+} SnakeTrajectoryWriterStats;
+
+/* 映射的一列：data 指向第一行，在 snake_trajectory_unmap 之前有效 */
+typedef struct
+{
+    const void *data;      /* 列数据 */
+    Uint64 size;           /* 列的字节数 */
+    Uint32 rows;           /* 行数 */
+    void *mapping;         /* 映射（或读入的缓冲区）的起始地址和大小，用于释放 */
+    size_t mapping_size;
+} SnakeTrajectoryView;
+
+typedef struct SnakeTrajectoryWriter SnakeTrajectoryWriter;
+typedef struct SnakeTrajectoryReader SnakeTrajectoryReader;
+
+/* 玩家1 在刚执行的 tick 中得到的奖励：得分的增加量，玩家1 死亡时为 -1，占满场地时为 +1；
+ * 玩家1 死亡或占满场地（游戏随之重置）时 done 为 true；prev 为执行这个 tick 之前玩家1 的状态
+ * 多人模式下只看玩家1 自己（在场状态从 true 变为 false），其他玩家死亡不影响玩家1 的奖励
+ */
+float snake_trajectory_reward(const SnakeContext *ctx, const SnakePlayer *prev, bool *done);
+
+/* 创建数据集文件并启动后台写入线程，失败时返回 NULL */
+SnakeTrajectoryWriter *snake_trajectory_writer_open(const char *path);
+
+/* 记录一行：obs 为执行这个 tick 之前的 cells，块写满时交给后台线程，不等待写文件 */
+void snake_trajectory_writer_record(SnakeTrajectoryWriter *writer, const unsigned char *obs, Uint8 action, float reward, bool done);
+
+/* 写出剩余的行、索引和文件尾并释放写入端，stats 可以为 NULL；任何写入失败时返回 false */
+bool snake_trajectory_writer_close(SnakeTrajectoryWriter *writer, SnakeTrajectoryWriterStats *stats);
+
+/* 打开数据集文件并读取块索引，失败时返回 NULL */
+SnakeTrajectoryReader *snake_trajectory_reader_open(const char *path);
+
+/* 关闭数据集文件并释放读取端（已映射的列仍然有效，需要分别释放） */
+void snake_trajectory_reader_close(SnakeTrajectoryReader *reader);
+
+/* 获取总行数和块数量 */
+Uint64 snake_trajectory_reader_rows(const SnakeTrajectoryReader *reader);
+Uint32 snake_trajectory_reader_chunks(const SnakeTrajectoryReader *reader);
+
+/* 映射第 chunk 块的一列（Linux 使用只读 mmap，其他系统读入内存），失败时返回 false */
+bool snake_trajectory_map(SnakeTrajectoryReader *reader, Uint32 chunk, SnakeTrajectoryColumn column, SnakeTrajectoryView *view);
+
+/* 释放映射的列 */
+void snake_trajectory_unmap(SnakeTrajectoryView *view);
+
+#endif /* SNAKE_TRAJECTORY_H */
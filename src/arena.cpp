@@ -0,0 +1,178 @@
+/*
+ * 大页内存区实现（Linux 使用 mmap 和 madvise，其他系统使用普通的对齐分配）
+ */
+
+#include "arena.h"
+
+#ifdef SDL_PLATFORM_LINUX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define ARENA_DEFAULT_HUGE_PAGE (2U * 1024U * 1024U) /* 读取不到系统设置时的大页大小 */
+#define ARENA_FALLBACK_ALIGN 4096U                   /* 非 Linux 系统上的对齐 */
+
+static const char *const pages_names_[SNAKE_ARENA_PAGES_COUNT] = {"normal", "transparent-huge", "explicit-huge"};
+
+const char *snake_arena_pages_name(SnakeArenaPages pages)
+{
+    return (unsigned)pages < SNAKE_ARENA_PAGES_COUNT ? pages_names_[pages] : "unknown";
+}
+
+#ifdef SDL_PLATFORM_LINUX
+/* 在 /proc 文件的文本中找到 key，返回其后以 kB 为单位的数值（字节） */
+static size_t proc_kb_(const char *text, const char *key)
+{
+    const char *line = SDL_strstr(text, key);
+    return line ? (size_t)SDL_strtoull(line + SDL_strlen(key), NULL, 10) * 1024U : 0;
+}
+
+/* 系统的大页大小 */
+static size_t huge_page_size_(void)
+{
+    char *meminfo = (char *)SDL_LoadFile("/proc/meminfo", NULL);
+    size_t size = meminfo ? proc_kb_(meminfo, "Hugepagesize:") : 0;
+    SDL_free(meminfo);
+    return size ? size : ARENA_DEFAULT_HUGE_PAGE;
+}
+
+static size_t round_up_(size_t size, size_t align)
+{
+    return (size + align - 1) / align * align;
+}
+
+/* 按 pages 映射内存，失败时返回 false 并保持 arena 不变 */
+static bool map_(SnakeArena *arena, size_t size, SnakeArenaPages pages)
+{
+    const size_t huge = huge_page_size_();
+    void *mapping;
+    size_t mapping_size;
+    Uint8 *base;
+
+    switch (pages)
+    {
+    case SNAKE_ARENA_EXPLICIT_HUGE:
+        mapping_size = round_up_(size, huge);
+        mapping = mmap(NULL, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mapping == MAP_FAILED)
+        {
+            return false; /* 没有预留足够的大页 */
+        }
+        base = (Uint8 *)mapping;
+        arena->page_size = huge;
+        break;
+
+    case SNAKE_ARENA_TRANSPARENT_HUGE:
+        /* 多映射一个大页，使可用部分从大页边界开始 */
+        mapping_size = round_up_(size, huge) + huge;
+        mapping = mmap(NULL, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED)
+        {
+            return false;
+        }
+        base = (Uint8 *)round_up_((size_t)mapping, huge);
+        if (madvise(base, round_up_(size, huge), MADV_HUGEPAGE) != 0)
+        {
+            munmap(mapping, mapping_size); /* 内核不支持透明大页 */
+            return false;
+        }
+        arena->page_size = huge;
+        break;
+
+    default:
+        mapping_size = round_up_(size, (size_t)sysconf(_SC_PAGESIZE));
+        mapping = mmap(NULL, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapping == MAP_FAILED)
+        {
+            return false;
+        }
+        base = (Uint8 *)mapping;
+        madvise(base, mapping_size, MADV_NOHUGEPAGE); /* 透明大页设为 always 时也保持普通页 */
+        arena->page_size = (size_t)sysconf(_SC_PAGESIZE);
+        break;
+    }
+    arena->base = base;
+    arena->size = size;
+    arena->pages = pages;
+    arena->mapping = mapping;
+    arena->mapping_size = mapping_size;
+    return true;
+}
+#endif
+
+bool snake_arena_create(SnakeArena *arena, size_t size, SnakeArenaPages pages)
+{
+    SDL_zerop(arena);
+#ifdef SDL_PLATFORM_LINUX
+    /* 依次退回：预留的大页 → 透明大页 → 普通页 */
+    while (!map_(arena, size, pages))
+    {
+        if (pages == SNAKE_ARENA_NORMAL_PAGES)
+        {
+            return SDL_SetError("Cannot map %" SDL_PRIu64 " bytes", (Uint64)size);
+        }
+        pages = (SnakeArenaPages)(pages - 1);
+    }
+    return true;
+#else
+    (void)pages;
+    arena->base = SDL_aligned_alloc(ARENA_FALLBACK_ALIGN, size);
+    if (!arena->base)
+    {
+        return false;
+    }
+    arena->size = size;
+    arena->pages = SNAKE_ARENA_NORMAL_PAGES;
+    arena->page_size = ARENA_FALLBACK_ALIGN;
+    return true;
+#endif
+}
+
+void snake_arena_destroy(SnakeArena *arena)
+{
+#ifdef SDL_PLATFORM_LINUX
+    if (arena->mapping)
+    {
+        munmap(arena->mapping, arena->mapping_size);
+    }
+#else
+    SDL_aligned_free(arena->base);
+#endif
+    SDL_zerop(arena);
+}
+
+size_t snake_arena_huge_bytes(const SnakeArena *arena)
+{
+#ifdef SDL_PLATFORM_LINUX
+    char *smaps;
+    char *line;
+    size_t huge = 0;
+
+    if (arena->pages == SNAKE_ARENA_EXPLICIT_HUGE)
+    {
+        return arena->size;
+    }
+    if (arena->pages != SNAKE_ARENA_TRANSPARENT_HUGE)
+    {
+        return 0;
+    }
+    /* 在 /proc/self/smaps 中找到包含内存区的映射，读取其 AnonHugePages */
+    smaps = (char *)SDL_LoadFile("/proc/self/smaps", NULL);
+    for (line = smaps; line && *line; line = SDL_strchr(line, '\n') ? SDL_strchr(line, '\n') + 1 : NULL)
+    {
+        char *end;
+        const Uint64 start = SDL_strtoull(line, &end, 16);
+        const Uint64 stop = *end == '-' ? SDL_strtoull(end + 1, NULL, 16) : 0;
+        if (stop && start <= (Uint64)(size_t)arena->base && (Uint64)(size_t)arena->base < stop)
+        {
+            huge = proc_kb_(line, "AnonHugePages:");
+            break;
+        }
+    }
+    SDL_free(smaps);
+    return SDL_min(huge, arena->size);
+#else
+    (void)arena;
+    return 0;
+#endif
+}
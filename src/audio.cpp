@@ -0,0 +1,342 @@
+/*
+ * 音效混音实现
+ * 单生产者单消费者无锁队列 + 预生成 PCM + SIMD 混音，
+ * 统计信息通过顺序锁（seqlock）发布，读写双方都不阻塞
+ */
+
+#include "audio.h"
+#include "snake.h"
+
+#define MIXER_FREQ 48000     /* 采样率 */
+#define MIXER_CHUNK 256      /* 每次混音的采样帧数 */
+#define MIXER_MAX_VOICES 8   /* 同时播放的音效数量上限 */
+#define MIXER_QUEUE_SIZE 64  /* 事件队列容量（2的幂） */
+#define MIXER_GAIN 0.35f     /* 音效生成时的幅度 */
+#define MIXER_PI 3.14159265358979323846
+
+/* 正在播放的音效 */
+typedef struct
+{
+    const float *pcm; /* 预生成的 PCM 数据 */
+    int frames;       /* 总帧数 */
+    int pos;          /* 已播放的帧数 */
+} MixerVoice;
+
+struct SnakeMixer
+{
+    SDL_AudioStream *stream;              /* SDL 音频流（回调模式） */
+    float *pcm[SNAKE_SOUND_COUNT];        /* 预生成的音效数据 */
+    int pcm_frames[SNAKE_SOUND_COUNT];    /* 音效帧数 */
+
+    /* 无锁事件队列：游戏线程写 head，音频线程写 tail */
+    Uint8 queue[MIXER_QUEUE_SIZE];
+    SDL_AtomicInt queue_head;
+    SDL_AtomicInt queue_tail;
+    Uint32 dropped;                       /* 队列已满时丢弃的请求（只由游戏线程访问） */
+
+    /* 以下字段只由音频线程访问 */
+    MixerVoice voices[MIXER_MAX_VOICES];
+    int voice_count;
+    float mix[MIXER_CHUNK];               /* 混音缓冲区 */
+    SnakeMixerStats local;                /* 音频线程内部的统计 */
+
+    /* 发布给游戏线程的统计快照 */
+    SDL_AtomicInt stats_seq;              /* 顺序锁计数，奇数表示正在写入 */
+    SnakeMixerStats published;
+};
+
+/* 生成一段频率线性滑动、幅度线性衰减的正弦音效 */
+static float *synth_sweep_(int frames, double freq_start, double freq_end)
+{
+    float *pcm = (float *)SDL_malloc(frames * sizeof(float));
+    double phase = 0.0;
+    int i;
+    if (!pcm)
+    {
+        return NULL;
+    }
+    for (i = 0; i < frames; i++)
+    {
+        const double t = (double)i / frames;
+        const double freq = freq_start + (freq_end - freq_start) * t;
+        pcm[i] = (float)(SDL_sin(phase) * (1.0 - t)) * MIXER_GAIN;
+        phase += 2.0 * MIXER_PI * freq / MIXER_FREQ;
+    }
+    return pcm;
+}
+
+/* 把 src 累加到 dst（每次处理4个采样） */
+static void mix_add_(float *dst, const float *src, int count)
+{
+    int i = 0;
+#if defined(SDL_SSE_INTRINSICS)
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+    }
+#elif defined(SDL_NEON_INTRINSICS)
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vld1q_f32(src + i)));
+    }
+#endif
+    for (; i < count; i++)
+    {
+        dst[i] += src[i];
+    }
+}
+
+/* 把混音结果限制在 [-1, 1] 内，返回限制前的峰值幅度 */
+static float clamp_and_peak_(float *buf, int count)
+{
+    float peak = 0.0f;
+    int i = 0;
+#if defined(SDL_SSE_INTRINSICS)
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 minus_one = _mm_set1_ps(-1.0f);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    __m128 peak4 = _mm_setzero_ps();
+    float lanes[4];
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 v = _mm_loadu_ps(buf + i);
+        peak4 = _mm_max_ps(peak4, _mm_andnot_ps(sign, v));
+        _mm_storeu_ps(buf + i, _mm_min_ps(one, _mm_max_ps(minus_one, v)));
+    }
+    _mm_storeu_ps(lanes, peak4);
+    peak = SDL_max(SDL_max(lanes[0], lanes[1]), SDL_max(lanes[2], lanes[3]));
+#elif defined(SDL_NEON_INTRINSICS)
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t minus_one = vdupq_n_f32(-1.0f);
+    float32x4_t peak4 = vdupq_n_f32(0.0f);
+    float lanes[4];
+    for (; i + 4 <= count; i += 4)
+    {
+        const float32x4_t v = vld1q_f32(buf + i);
+        peak4 = vmaxq_f32(peak4, vabsq_f32(v));
+        vst1q_f32(buf + i, vminq_f32(one, vmaxq_f32(minus_one, v)));
+    }
+    vst1q_f32(lanes, peak4);
+    peak = SDL_max(SDL_max(lanes[0], lanes[1]), SDL_max(lanes[2], lanes[3]));
+#endif
+    for (; i < count; i++)
+    {
+        const float v = buf[i];
+        peak = SDL_max(peak, SDL_fabsf(v));
+        buf[i] = SDL_clamp(v, -1.0f, 1.0f);
+    }
+    return peak;
+}
+
+/* 开始播放音效，声部已满时替换播放进度最靠后的声部 */
+static void start_voice_(SnakeMixer *m, int sound)
+{
+    MixerVoice *voice;
+    if (m->voice_count < MIXER_MAX_VOICES)
+    {
+        voice = &m->voices[m->voice_count++];
+    }
+    else
+    {
+        int i;
+        voice = &m->voices[0];
+        for (i = 1; i < MIXER_MAX_VOICES; i++)
+        {
+            if (m->voices[i].pos > voice->pos)
+            {
+                voice = &m->voices[i];
+            }
+        }
+    }
+    voice->pcm = m->pcm[sound];
+    voice->frames = m->pcm_frames[sound];
+    voice->pos = 0;
+    ++m->local.sounds_played;
+}
+
+/* 音频线程：取出队列中的全部事件 */
+static void drain_events_(SnakeMixer *m)
+{
+    Uint32 tail = (Uint32)SDL_GetAtomicInt(&m->queue_tail);
+    const Uint32 head = (Uint32)SDL_GetAtomicInt(&m->queue_head);
+    SDL_MemoryBarrierAcquire(); /* 读取 head 之后才能读取对应的队列元素 */
+    while (tail != head)
+    {
+        start_voice_(m, m->queue[tail & (MIXER_QUEUE_SIZE - 1)]);
+        ++tail;
+    }
+    SDL_SetAtomicInt(&m->queue_tail, (int)tail);
+}
+
+/* 音频线程：混音一段数据到 m->mix */
+static void mix_chunk_(SnakeMixer *m, int frames)
+{
+    int i = 0;
+    SDL_memset(m->mix, 0, frames * sizeof(float));
+    while (i < m->voice_count)
+    {
+        MixerVoice *voice = &m->voices[i];
+        const int count = SDL_min(frames, voice->frames - voice->pos);
+        mix_add_(m->mix, voice->pcm + voice->pos, count);
+        voice->pos += count;
+        if (voice->pos >= voice->frames)
+        {
+            *voice = m->voices[--m->voice_count]; /* 播放结束，用最后一个声部填补 */
+            continue;
+        }
+        ++i;
+    }
+    m->local.peak = SDL_max(m->local.peak, clamp_and_peak_(m->mix, frames));
+}
+
+/* 音频线程：发布统计快照 */
+static void publish_stats_(SnakeMixer *m)
+{
+    SDL_AddAtomicInt(&m->stats_seq, 1);
+    SDL_MemoryBarrierRelease();
+    m->published = m->local;
+    SDL_MemoryBarrierRelease();
+    SDL_AddAtomicInt(&m->stats_seq, 1);
+}
+
+/* SDL 音频流回调（在音频线程中执行） */
+static void SDLCALL mixer_callback_(void *userdata, SDL_AudioStream *stream, int additional_amount, int total_amount)
+{
+    SnakeMixer *m = (SnakeMixer *)userdata;
+    const Uint64 start = SDL_GetPerformanceCounter();
+    int frames = additional_amount / (int)sizeof(float);
+    Uint64 busy_ns;
+    (void)total_amount;
+
+    drain_events_(m);
+    while (frames > 0)
+    {
+        const int n = SDL_min(frames, MIXER_CHUNK);
+        mix_chunk_(m, n);
+        SDL_PutAudioStreamData(stream, m->mix, n * (int)sizeof(float));
+        m->local.frames += n;
+        frames -= n;
+    }
+
+    busy_ns = (SDL_GetPerformanceCounter() - start) * SDL_NS_PER_SECOND / SDL_GetPerformanceFrequency();
+    ++m->local.callbacks;
+    m->local.busy_ns += busy_ns;
+    m->local.max_busy_ns = SDL_max(m->local.max_busy_ns, busy_ns);
+    publish_stats_(m);
+}
+
+SnakeMixer *snake_mixer_open(void)
+{
+    SDL_AudioSpec spec;
+    SnakeMixer *m = (SnakeMixer *)SDL_calloc(1, sizeof(SnakeMixer));
+    int i;
+
+    if (!m)
+    {
+        return NULL;
+    }
+
+    /* 预生成全部音效，音频线程只读取这些数据 */
+    m->pcm_frames[SNAKE_SOUND_EAT] = MIXER_FREQ * 90 / 1000;
+    m->pcm[SNAKE_SOUND_EAT] = synth_sweep_(m->pcm_frames[SNAKE_SOUND_EAT], 660.0, 990.0);
+    m->pcm_frames[SNAKE_SOUND_TURN] = MIXER_FREQ * 25 / 1000;
+    m->pcm[SNAKE_SOUND_TURN] = synth_sweep_(m->pcm_frames[SNAKE_SOUND_TURN], 330.0, 300.0);
+    m->pcm_frames[SNAKE_SOUND_DEATH] = MIXER_FREQ * 450 / 1000;
+    m->pcm[SNAKE_SOUND_DEATH] = synth_sweep_(m->pcm_frames[SNAKE_SOUND_DEATH], 440.0, 110.0);
+    for (i = 0; i < SNAKE_SOUND_COUNT; i++)
+    {
+        if (!m->pcm[i])
+        {
+            snake_mixer_close(m);
+            return NULL;
+        }
+    }
+
+    spec.format = SDL_AUDIO_F32;
+    spec.channels = 1;
+    spec.freq = MIXER_FREQ;
+    m->stream = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, mixer_callback_, m);
+    if (!m->stream)
+    {
+        snake_mixer_close(m);
+        return NULL;
+    }
+    SDL_ResumeAudioStreamDevice(m->stream);
+    return m;
+}
+
+void snake_mixer_close(SnakeMixer *mixer)
+{
+    int i;
+    if (!mixer)
+    {
+        return;
+    }
+    if (mixer->stream)
+    {
+        SDL_DestroyAudioStream(mixer->stream); /* 返回后回调不会再被调用 */
+    }
+    for (i = 0; i < SNAKE_SOUND_COUNT; i++)
+    {
+        SDL_free(mixer->pcm[i]);
+    }
+    SDL_free(mixer);
+}
+
+bool snake_mixer_play(SnakeMixer *mixer, SnakeSound sound)
+{
+    Uint32 head;
+    Uint32 tail;
+    if (!mixer)
+    {
+        return false;
+    }
+    head = (Uint32)SDL_GetAtomicInt(&mixer->queue_head);
+    tail = (Uint32)SDL_GetAtomicInt(&mixer->queue_tail);
+    if (head - tail >= MIXER_QUEUE_SIZE)
+    {
+        ++mixer->dropped;
+        return false;
+    }
+    mixer->queue[head & (MIXER_QUEUE_SIZE - 1)] = (Uint8)sound;
+    SDL_MemoryBarrierRelease(); /* 队列元素必须先于 head 可见 */
+    SDL_SetAtomicInt(&mixer->queue_head, (int)(head + 1));
+    return true;
+}
+
+int snake_mixer_play_events(SnakeMixer *mixer, Uint8 events)
+{
+    int queued = 0;
+    if (events & SNAKE_EVENT_DIED)
+    {
+        return snake_mixer_play(mixer, SNAKE_SOUND_DEATH);
+    }
+    if (events & (SNAKE_EVENT_ATE | SNAKE_EVENT_PICKUP | SNAKE_EVENT_WON))
+    {
+        queued += snake_mixer_play(mixer, SNAKE_SOUND_EAT);
+    }
+    if (events & SNAKE_EVENT_TURNED)
+    {
+        queued += snake_mixer_play(mixer, SNAKE_SOUND_TURN);
+    }
+    return queued;
+}
+
+void snake_mixer_get_stats(SnakeMixer *mixer, SnakeMixerStats *stats)
+{
+    int before;
+    int after;
+    do
+    {
+        before = SDL_GetAtomicInt(&mixer->stats_seq);
+        SDL_MemoryBarrierAcquire();
+        *stats = mixer->published;
+        SDL_MemoryBarrierAcquire();
+        after = SDL_GetAtomicInt(&mixer->stats_seq);
+    } while ((before & 1) != 0 || before != after);
+}
+
+Uint32 snake_mixer_dropped(const SnakeMixer *mixer)
+{
+    return mixer ? mixer->dropped : 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * 音效混音检查
+ * 在 dummy 音频驱动上运行真实的音频线程和回调，不需要声卡；
+ * 事件经由游戏循环使用的 snake_mixer_play_events 转换为音效
+ */
+
+#include "headless.h"
+#include "audio.h"
+#include "snake.h"
+
+#define AUDIO_CHECK_TICKS 240         /* 模拟的 tick 数 */
+#define AUDIO_CHECK_TICK_DELAY_MS 4   /* 每个 tick 之间的等待时间 */
+#define AUDIO_CHECK_DRAIN_MS 800      /* 结束后等待音频线程消费剩余事件的时间 */
+
+SDL_AppResult snake_audio_check(int argc, char *argv[])
+{
+    SnakeMixerStats stats;
+    SnakeMixer *mixer;
+    SnakeContext ctx;
+    Uint64 rng = 7;
+    Uint32 requested = 0;
+    double audio_ns;
+    bool ok = true;
+    int tick;
+
+    (void)argc;
+    (void)argv;
+
+    SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+    if (!SDL_Init(SDL_INIT_AUDIO))
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "audio-check: %s", SDL_GetError());
+        return SDL_APP_FAILURE;
+    }
+    mixer = snake_mixer_open();
+    if (!mixer)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "audio-check: cannot open mixer: %s", SDL_GetError());
+        SDL_Quit();
+        return SDL_APP_FAILURE;
+    }
+
+    /* 随机转向的对局，产生转向、进食和死亡音效 */
+    snake_initialize_seeded(&ctx, 7);
+    for (tick = 0; tick < AUDIO_CHECK_TICKS; tick++)
+    {
+        if (SDL_rand_r(&rng, 3) == 0)
+        {
+            snake_redir(&ctx, (SnakeDirection)SDL_rand_r(&rng, 4));
+        }
+        snake_step(&ctx);
+        requested += (Uint32)snake_mixer_play_events(mixer, ctx.events); /* 与游戏循环相同的事件到音效映射 */
+        SDL_Delay(AUDIO_CHECK_TICK_DELAY_MS);
+    }
+    SDL_Delay(AUDIO_CHECK_DRAIN_MS);
+
+    snake_mixer_get_stats(mixer, &stats);
+    audio_ns = (double)stats.frames * SDL_NS_PER_SECOND / 48000.0;
+    SDL_Log("audio-check: driver=%s callbacks=%llu frames=%llu sounds=%u/%u dropped=%u peak=%.3f",
+            SDL_GetCurrentAudioDriver(), (unsigned long long)stats.callbacks,
+            (unsigned long long)stats.frames, stats.sounds_played, requested,
+            snake_mixer_dropped(mixer), stats.peak);
+    SDL_Log("audio-check: mixer cpu %.3f ms total, %.2f us/callback avg, %.2f us max, %.4f%% of audio time",
+            stats.busy_ns / 1e6,
+            stats.callbacks ? stats.busy_ns / 1e3 / stats.callbacks : 0.0,
+            stats.max_busy_ns / 1e3,
+            audio_ns > 0.0 ? 100.0 * stats.busy_ns / audio_ns : 0.0);
+
+    if (stats.callbacks == 0 || stats.frames == 0)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "audio-check: audio callback never ran");
+        ok = false;
+    }
+    if (requested == 0 || stats.sounds_played != requested)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "audio-check: %u sounds requested but %u played",
+                     requested, stats.sounds_played);
+        ok = false;
+    }
+    if (stats.peak <= 0.0f)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "audio-check: mixer produced silence");
+        ok = false;
+    }
+
+    snake_mixer_close(mixer);
+    SDL_Quit();
+    return ok ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+}
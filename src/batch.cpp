@@ -0,0 +1,125 @@
+/*
+ * 批量推进实现
+ */
+
+#include "batch.h"
+
+/* 预取提示，只影响缓存，不影响结果 */
+#if defined(__GNUC__) || defined(__clang__)
+#define BATCH_PREFETCH(p) __builtin_prefetch((p), 1, 3)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define BATCH_PREFETCH(p) _mm_prefetch((const char *)(p), _MM_HINT_T0)
+#else
+#define BATCH_PREFETCH(p) ((void)(p))
+#endif
+
+/* 第一阶段：预取地址固定的部分，即计数器和蛇所在的第一条缓存行，
+ * 以及实体数量和到期堆顶（每 tick 检查）
+ */
+static void prefetch_hot_(const SnakeContext *ctx)
+{
+    BATCH_PREFETCH(ctx);
+    BATCH_PREFETCH(&ctx->entities);
+}
+
+/* 第二阶段：第一条缓存行已经到达，按蛇头蛇尾坐标预取 snake_step 要读写的格子、
+ * 所在行的占用位图和归属
+ */
+static void prefetch_cells_(const SnakeContext *ctx)
+{
+    int i;
+    for (i = 0; i < ctx->player_count; i++)
+    {
+        const SnakePlayer *snake = &ctx->players[i];
+        BATCH_PREFETCH(&ctx->cells[SHIFT(snake->head_xpos, snake->head_ypos) / 8]);
+        BATCH_PREFETCH(&ctx->cells[SHIFT(snake->tail_xpos, snake->tail_ypos) / 8]);
+        BATCH_PREFETCH(&ctx->occupied_rows[(int)snake->head_ypos]);
+        BATCH_PREFETCH(&ctx->occupied_rows[(int)snake->tail_ypos]);
+        BATCH_PREFETCH(&ctx->owner[snake->head_xpos + snake->head_ypos * SNAKE_GAME_WIDTH]);
+        BATCH_PREFETCH(&ctx->owner[snake->tail_xpos + snake->tail_ypos * SNAKE_GAME_WIDTH]);
+    }
+}
+
+static void step_one_(SnakeContext *ctx, const Uint8 *turns, int i)
+{
+    if (turns && turns[i] != SNAKE_BATCH_NO_TURN)
+    {
+        snake_redir(ctx, (SnakeDirection)turns[i]);
+    }
+    snake_step(ctx);
+}
+
+void snake_batch_init(SnakeContext *games, int count, Uint64 seed)
+{
+    int i;
+    for (i = 0; i < count; i++)
+    {
+        snake_initialize_seeded(&games[i], seed + (Uint64)i);
+    }
+}
+
+SnakeContext *snake_batch_alloc(int count, Uint64 seed)
+{
+    SnakeContext *games = (SnakeContext *)SDL_aligned_alloc(SNAKE_CACHE_LINE, (size_t)count * sizeof(SnakeContext));
+    if (games)
+    {
+        snake_batch_init(games, count, seed);
+    }
+    return games;
+}
+
+void snake_batch_free(SnakeContext *games)
+{
+    SDL_aligned_free(games);
+}
+
+void snake_step_batch(SnakeContext *games, const Uint8 *turns, int count)
+{
+    int i;
+    for (i = 0; i < count; i++)
+    {
+        step_one_(&games[i], turns, i);
+    }
+}
+
+void snake_step_batch_pipelined(SnakeContext *games, const Uint8 *turns, int count, int distance)
+{
+    int i;
+
+    if (distance <= 0)
+    {
+        snake_step_batch(games, turns, count);
+        return;
+    }
+    /* 填充流水线 */
+    for (i = 0; i < SDL_min(2 * distance, count); i++)
+    {
+        prefetch_hot_(&games[i]);
+    }
+    for (i = 0; i < SDL_min(distance, count); i++)
+    {
+        prefetch_cells_(&games[i]);
+    }
+    for (i = 0; i < count; i++)
+    {
+        if (i + 2 * distance < count)
+        {
+            prefetch_hot_(&games[i + 2 * distance]);
+        }
+        if (i + distance < count)
+        {
+            prefetch_cells_(&games[i + distance]);
+        }
+        step_one_(&games[i], turns, i);
+    }
+}
+
+void snake_batch_random_turns(Uint8 *turns, int count, Uint64 *rng)
+{
+    int i;
+    for (i = 0; i < count; i++)
+    {
+        turns[i] = SDL_rand_r(rng, SNAKE_BATCH_TURN_CHANCE) == 0 ? (Uint8)SDL_rand_r(rng, 4) : SNAKE_BATCH_NO_TURN;
+    }
+}
@@ -0,0 +1,222 @@
+/*
+ * 批量推进基准测试
+ * 以不同的批量大小连续推进多局游戏，批量从装得进 L1 到远超 L3，
+ * 报告逐局推进和各预取距离下流水线推进的每次 snake_step 平均耗时、
+ * 普通页和大页内存区的耗时，以及状态结构中每 tick 访问的字段所在的缓存行
+ */
+
+#include "headless.h"
+#include "batch.h"
+#include "arena.h"
+
+#define BATCH_BENCH_STEPS (4U * 1024U * 1024U) /* 每种批量大小推进的总 tick 数 */
+#define BATCH_BENCH_SEED 0xBA7C4
+#define BATCH_BENCH_LAYOUT_TICKS 100000      /* 统计写入缓存行数的 tick 数 */
+
+/* 比较的预取距离，第一项 0 为逐局推进 */
+static const int default_distances_[] = {0, 1, 2, 4, 8, 16};
+
+static const int batch_sizes_[] = {16, 512, 8192, 131072}; /* 约 48 KiB、1.5 MiB、24 MiB、384 MiB */
+
+/* 字节区间 [offset, offset + size) 跨越的缓存行数 */
+static int lines_(size_t offset, size_t size)
+{
+    return (int)((offset + size - 1) / SNAKE_CACHE_LINE - offset / SNAKE_CACHE_LINE + 1);
+}
+
+/* 输出状态结构的布局，并逐行比较推进前后的状态，统计每 tick 平均写入的缓存行数
+ * （与计时不同，这个数字不受机器负载影响，可以直接比较不同布局）
+ */
+static void report_layout_(Uint64 *rng)
+{
+    const size_t hot_end = offsetof(SnakeContext, players) + sizeof(SnakePlayer);
+    SnakeContext *games = snake_batch_alloc(2, BATCH_BENCH_SEED);
+    Uint64 dirty = 0;
+    int tick;
+    size_t line;
+
+    SDL_Log("batch-bench: SnakeContext %u bytes (%u cache lines); counters and player 1 in %d line(s), cells at +%u in %d line(s)",
+            (unsigned)sizeof(SnakeContext), (unsigned)((sizeof(SnakeContext) + SNAKE_CACHE_LINE - 1) / SNAKE_CACHE_LINE),
+            lines_(0, hot_end), (unsigned)offsetof(SnakeContext, cells),
+            lines_(offsetof(SnakeContext, cells), sizeof(((SnakeContext *)NULL)->cells)));
+    if (!games)
+    {
+        return;
+    }
+    for (tick = 0; tick < BATCH_BENCH_LAYOUT_TICKS; tick++)
+    {
+        Uint8 turn;
+        snake_batch_random_turns(&turn, 1, rng);
+        games[1] = games[0];
+        snake_step_batch(&games[0], &turn, 1);
+        for (line = 0; line < sizeof(SnakeContext); line += SNAKE_CACHE_LINE)
+        {
+            const size_t size = SDL_min((size_t)SNAKE_CACHE_LINE, sizeof(SnakeContext) - line);
+            dirty += SDL_memcmp((const Uint8 *)&games[0] + line, (const Uint8 *)&games[1] + line, size) != 0;
+        }
+    }
+    SDL_Log("batch-bench: %.2f cache lines written per step", (double)dirty / BATCH_BENCH_LAYOUT_TICKS);
+    snake_batch_free(games);
+}
+
+/* 以指定的预取距离推进已初始化的一批游戏（0 为逐局推进），返回每次 snake_step 的平均纳秒数，
+ * 所有局最终状态的校验和写入 checksum；失败时返回负数
+ */
+static double run_(SnakeContext *games, int count, Uint32 steps, int distance, Uint32 *checksum)
+{
+    Uint8 *turns = (Uint8 *)SDL_malloc((size_t)count);
+    const Uint32 rounds = SDL_max(steps / (Uint32)count, 1U);
+    Uint64 rng = BATCH_BENCH_SEED; /* 每种方式使用相同的输入序列 */
+    Uint64 elapsed = 0;
+    Uint32 round;
+    int i;
+
+    if (!games || !turns)
+    {
+        SDL_free(turns);
+        return -1.0;
+    }
+    snake_step_batch(games, NULL, count); /* 预热：分配页面、填充缓存和 TLB */
+    for (round = 0; round < rounds; round++)
+    {
+        Uint64 start;
+        snake_batch_random_turns(turns, count, &rng);
+        start = SDL_GetTicksNS();
+        snake_step_batch_pipelined(games, turns, count, distance);
+        elapsed += SDL_GetTicksNS() - start;
+    }
+    *checksum = 0;
+    for (i = 0; i < count; i++)
+    {
+        *checksum = snake_checksum_roll(*checksum, &games[i]);
+    }
+    SDL_free(turns);
+    return (double)elapsed / ((double)rounds * count);
+}
+
+/* 用各种页面类型的内存区推进同一批游戏（逐局推进，TLB 缺失不被预取掩盖），
+ * 报告实际得到的页面大小和耗时；结果与 expected 不一致时返回 false
+ */
+static bool run_pages_(int count, Uint32 steps, Uint32 expected)
+{
+    char line[512];
+    int p;
+
+    SDL_snprintf(line, sizeof(line), "%6d games pages:", count);
+    for (p = 0; p < SNAKE_ARENA_PAGES_COUNT; p++)
+    {
+        SnakeArena arena;
+        char name[64];
+        Uint32 checksum;
+        double ns;
+        size_t huge;
+
+        if (!snake_arena_create(&arena, (size_t)count * sizeof(SnakeContext), (SnakeArenaPages)p))
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_TEST, "batch-bench: %s", SDL_GetError());
+            return false;
+        }
+        snake_batch_init((SnakeContext *)arena.base, count, BATCH_BENCH_SEED);
+        ns = run_((SnakeContext *)arena.base, count, steps, 0, &checksum);
+        huge = snake_arena_huge_bytes(&arena);
+        /* 请求的页面类型不可用时显示退回到的类型 */
+        if (arena.pages != (SnakeArenaPages)p)
+        {
+            SDL_snprintf(name, sizeof(name), "%s -> %s", snake_arena_pages_name((SnakeArenaPages)p), snake_arena_pages_name(arena.pages));
+        }
+        else
+        {
+            SDL_snprintf(name, sizeof(name), "%s", snake_arena_pages_name(arena.pages));
+        }
+        SDL_snprintf(line + SDL_strlen(line), sizeof(line) - SDL_strlen(line), "%s %s %.1f ns/step (%u KiB pages, %.0f%% huge)",
+                     p == 0 ? "" : ",", name, ns, (unsigned)(arena.page_size / 1024), 100.0 * huge / arena.size);
+        snake_arena_destroy(&arena);
+        if (checksum != expected)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_TEST, "batch-bench: %s pages changed the result of %d games",
+                         snake_arena_pages_name((SnakeArenaPages)p), count);
+            return false;
+        }
+    }
+    SDL_Log("batch-bench: %s", line);
+    return true;
+}
+
+SDL_AppResult snake_batch_bench(int argc, char *argv[])
+{
+    Uint32 steps = BATCH_BENCH_STEPS;
+    Uint64 rng = BATCH_BENCH_SEED;
+    int distances[SDL_arraysize(default_distances_)];
+    int distance_count = (int)SDL_arraysize(default_distances_);
+    size_t b;
+    int i;
+
+    SDL_memcpy(distances, default_distances_, sizeof(distances));
+    for (i = 1; i < argc; i++)
+    {
+        if (SDL_strcmp(argv[i], "--batch-steps") == 0 && i + 1 < argc)
+        {
+            steps = (Uint32)SDL_strtoul(argv[++i], NULL, 10);
+        }
+        else if (SDL_strcmp(argv[i], "--prefetch-distance") == 0 && i + 1 < argc)
+        {
+            distances[1] = SDL_atoi(argv[++i]); /* 只比较逐局推进和指定的距离 */
+            distance_count = 2;
+        }
+    }
+
+    report_layout_(&rng);
+    for (b = 0; b < SDL_arraysize(batch_sizes_); b++)
+    {
+        const int count = batch_sizes_[b];
+        Uint32 expected = 0;
+        double plain_ns = 0.0;
+        double best_ns = 0.0;
+        int best_distance = 0;
+        char line[256];
+
+        SDL_snprintf(line, sizeof(line), "%6d games (%7.1f KiB)", count, (double)count * sizeof(SnakeContext) / 1024.0);
+        for (i = 0; i < distance_count; i++)
+        {
+            SnakeContext *games = snake_batch_alloc(count, BATCH_BENCH_SEED);
+            Uint32 checksum;
+            const double ns = run_(games, count, steps, distances[i], &checksum);
+            snake_batch_free(games);
+            if (ns < 0.0)
+            {
+                SDL_LogError(SDL_LOG_CATEGORY_TEST, "batch-bench: cannot allocate %d games", count);
+                return SDL_APP_FAILURE;
+            }
+            if (i == 0)
+            {
+                expected = checksum;
+                plain_ns = ns;
+            }
+            else if (checksum != expected)
+            {
+                SDL_LogError(SDL_LOG_CATEGORY_TEST, "batch-bench: prefetch distance %d changed the result of %d games",
+                             distances[i], count);
+                return SDL_APP_FAILURE;
+            }
+            if (i == 0 || ns < best_ns)
+            {
+                best_ns = ns;
+                best_distance = distances[i];
+            }
+            if (i == 0)
+            {
+                SDL_snprintf(line + SDL_strlen(line), sizeof(line) - SDL_strlen(line), " plain %.1f", ns);
+            }
+            else
+            {
+                SDL_snprintf(line + SDL_strlen(line), sizeof(line) - SDL_strlen(line), ", k=%d %.1f", distances[i], ns);
+            }
+        }
+        SDL_Log("batch-bench: %s ns/step; best k=%d (%.2fx)", line, best_distance, best_ns > 0.0 ? plain_ns / best_ns : 0.0);
+        if (!run_pages_(count, steps, expected))
+        {
+            return SDL_APP_FAILURE;
+        }
+    }
+    return SDL_APP_SUCCESS;
+}
@@ -0,0 +1,372 @@
+/*
+ * 分歧定位工具
+ * 同一回放在两个版本（或两种配置）下运行结果不一致时，比较每个 tick 的滚动校验和，
+ * 找到第一个出现差异的 tick，再从它之前的关键帧重新模拟到这个 tick，逐格报告这个 tick 的变化；
+ * 回放文件由 SnakeContext 布局不同的版本记录时，输入和校验和仍然可用，重新模拟从头开始
+ *
+ *   --bisect-record <path>   用当前版本运行随机回放，保存关键帧和校验和
+ *   --bisect <a> [<b>]       比较两个回放文件；只给出一个文件时与当前版本重新运行的结果比较
+ */
+
+#include "headless.h"
+#include "replay.h"
+
+#define BISECT_DEFAULT_TICKS 100000U /* 随机回放的默认长度 */
+#define BISECT_DEFAULT_SEED 0xB15EC7
+#define BISECT_TURN_CHANCE 4         /* 每个 tick 转向的概率为 1/4 */
+
+/* 记录参考回放 */
+static SDL_AppResult record_(const char *path, Uint32 ticks, Uint64 seed)
+{
+    SnakeReplayInput *inputs = (SnakeReplayInput *)SDL_malloc((ticks ? ticks : 1) * sizeof(SnakeReplayInput));
+    SnakeReplayArchive archive;
+    SnakeReplay replay;
+    bool ok;
+
+    if (!inputs)
+    {
+        return SDL_APP_FAILURE;
+    }
+    replay.name = "bisect";
+    replay.seed = seed;
+    replay.ticks = ticks;
+    replay.inputs = inputs;
+    replay.input_count = snake_replay_random_inputs(inputs, ticks, seed, BISECT_TURN_CHANCE);
+
+    ok = snake_replay_build_keyframes(&archive, &replay, SNAKE_REPLAY_KEYFRAME_INTERVAL) &&
+         snake_replay_save(&archive, path);
+    if (ok)
+    {
+        SDL_Log("bisect: recorded %u ticks (seed %" SDL_PRIu64 ", final checksum %08x) to %s",
+                ticks, seed, archive.checksums[ticks], path);
+    }
+    else
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "bisect: cannot record %s: %s", path, SDL_GetError());
+    }
+    snake_replay_close(&archive);
+    SDL_free(inputs);
+    return ok ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+}
+
+/* 两份回放必须是同一局游戏（种子、长度、输入和关键帧间隔都相同） */
+static bool same_replay_(const SnakeReplayArchive *a, const SnakeReplayArchive *b)
+{
+    return a->replay.seed == b->replay.seed && a->replay.ticks == b->replay.ticks &&
+           a->replay.input_count == b->replay.input_count &&
+           a->keyframe_interval == b->keyframe_interval &&
+           SDL_memcmp(a->replay.inputs, b->replay.inputs, a->replay.input_count * sizeof(SnakeReplayInput)) == 0;
+}
+
+/* 报告两个实体存储中第一个不同的食物、拾取物或特效（按稠密下标比较）和到期堆 */
+static void report_entities_(const SnakeEntities *a, const SnakeEntities *b, const char *name_a, const char *name_b)
+{
+    int i;
+
+    if (SDL_memcmp(a->count, b->count, sizeof(a->count)) != 0)
+    {
+        SDL_Log("bisect:   entities (food, pickups, effects): %s %u/%u/%u, %s %u/%u/%u", name_a,
+                a->count[SNAKE_ENTITY_FOOD], a->count[SNAKE_ENTITY_PICKUP], a->count[SNAKE_ENTITY_EFFECT], name_b,
+                b->count[SNAKE_ENTITY_FOOD], b->count[SNAKE_ENTITY_PICKUP], b->count[SNAKE_ENTITY_EFFECT]);
+    }
+    for (i = 0; i < SDL_min(a->count[SNAKE_ENTITY_FOOD], b->count[SNAKE_ENTITY_FOOD]); i++)
+    {
+        if (a->food_x[i] != b->food_x[i] || a->food_y[i] != b->food_y[i] ||
+            a->food_value[i] != b->food_value[i] || a->food_lifetime[i] != b->food_lifetime[i])
+        {
+            SDL_Log("bisect:   food %d: %s (%u,%u) value %u lifetime %u, %s (%u,%u) value %u lifetime %u", i,
+                    name_a, a->food_x[i], a->food_y[i], a->food_value[i], a->food_lifetime[i],
+                    name_b, b->food_x[i], b->food_y[i], b->food_value[i], b->food_lifetime[i]);
+            break;
+        }
+    }
+    for (i = 0; i < SDL_min(a->count[SNAKE_ENTITY_PICKUP], b->count[SNAKE_ENTITY_PICKUP]); i++)
+    {
+        if (a->pickup_x[i] != b->pickup_x[i] || a->pickup_y[i] != b->pickup_y[i] ||
+            a->pickup_value[i] != b->pickup_value[i] || a->pickup_lifetime[i] != b->pickup_lifetime[i])
+        {
+            SDL_Log("bisect:   pickup %d: %s (%u,%u) value %u lifetime %u, %s (%u,%u) value %u lifetime %u", i,
+                    name_a, a->pickup_x[i], a->pickup_y[i], a->pickup_value[i], a->pickup_lifetime[i],
+                    name_b, b->pickup_x[i], b->pickup_y[i], b->pickup_value[i], b->pickup_lifetime[i]);
+            break;
+        }
+    }
+    for (i = 0; i < SDL_min(a->count[SNAKE_ENTITY_EFFECT], b->count[SNAKE_ENTITY_EFFECT]); i++)
+    {
+        if (a->effect_x[i] != b->effect_x[i] || a->effect_y[i] != b->effect_y[i] ||
+            a->effect_ticks_left[i] != b->effect_ticks_left[i])
+        {
+            SDL_Log("bisect:   effect %d: %s (%u,%u) %u ticks left, %s (%u,%u) %u ticks left", i,
+                    name_a, a->effect_x[i], a->effect_y[i], a->effect_ticks_left[i],
+                    name_b, b->effect_x[i], b->effect_y[i], b->effect_ticks_left[i]);
+            break;
+        }
+    }
+    if (a->expiry_count != b->expiry_count ||
+        SDL_memcmp(a->expiry, b->expiry, a->expiry_count * sizeof(SnakeExpiry)) != 0)
+    {
+        SDL_Log("bisect:   expiry heaps differ: %s %u entries, %s %u entries", name_a, a->expiry_count,
+                name_b, b->expiry_count);
+    }
+}
+
+/* 报告两个状态中不同的字段和格子 */
+static void report_differences_(const SnakeContext *a, const SnakeContext *b, const char *name_a, const char *name_b)
+{
+    int differing_cells = 0;
+    int first_x = -1;
+    int first_y = -1;
+    int x;
+    int y;
+    int i;
+
+    if (a->tick != b->tick)
+    {
+        SDL_Log("bisect:   tick: %s %u, %s %u", name_a, a->tick, name_b, b->tick);
+    }
+    if (a->rng_state != b->rng_state)
+    {
+        SDL_Log("bisect:   rng_state: %s %016" SDL_PRIx64 ", %s %016" SDL_PRIx64, name_a, a->rng_state, name_b, b->rng_state);
+    }
+    if (a->occupied_cells != b->occupied_cells)
+    {
+        SDL_Log("bisect:   occupied_cells: %s %u, %s %u", name_a, a->occupied_cells, name_b, b->occupied_cells);
+    }
+    for (i = 0; i < SDL_max(a->player_count, b->player_count); i++)
+    {
+        const SnakePlayer *pa = &a->players[i];
+        const SnakePlayer *pb = &b->players[i];
+        if (pa->head_xpos != pb->head_xpos || pa->head_ypos != pb->head_ypos ||
+            pa->tail_xpos != pb->tail_xpos || pa->tail_ypos != pb->tail_ypos ||
+            pa->next_dir != pb->next_dir || pa->alive != pb->alive || pa->score != pb->score)
+        {
+            SDL_Log("bisect:   player %d: %s head (%d,%d) tail (%d,%d) dir %d score %u, %s head (%d,%d) tail (%d,%d) dir %d score %u",
+                    i + 1, name_a, pa->head_xpos, pa->head_ypos, pa->tail_xpos, pa->tail_ypos, pa->next_dir, pa->score,
+                    name_b, pb->head_xpos, pb->head_ypos, pb->tail_xpos, pb->tail_ypos, pb->next_dir, pb->score);
+        }
+    }
+    for (y = 0; y < (int)SNAKE_GAME_HEIGHT; y++)
+    {
+        for (x = 0; x < (int)SNAKE_GAME_WIDTH; x++)
+        {
+            if (snake_cell_at(a, (char)x, (char)y) != snake_cell_at(b, (char)x, (char)y))
+            {
+                if (differing_cells++ == 0)
+                {
+                    first_x = x;
+                    first_y = y;
+                }
+            }
+        }
+    }
+    if (differing_cells > 0)
+    {
+        SDL_Log("bisect:   %d cells differ, first at (%d,%d): %s %d, %s %d", differing_cells, first_x, first_y,
+                name_a, snake_cell_at(a, (char)first_x, (char)first_y), name_b, snake_cell_at(b, (char)first_x, (char)first_y));
+    }
+    for (i = 0; i < (int)SNAKE_MATRIX_SIZE; i++)
+    {
+        const SnakeCell ct = snake_cell_at(a, (char)(i % SNAKE_GAME_WIDTH), (char)(i / SNAKE_GAME_WIDTH));
+        if (ct >= SNAKE_CELL_SRIGHT && ct <= SNAKE_CELL_SDOWN &&
+            ct == snake_cell_at(b, (char)(i % SNAKE_GAME_WIDTH), (char)(i / SNAKE_GAME_WIDTH)) && a->owner[i] != b->owner[i])
+        {
+            SDL_Log("bisect:   owner of (%d,%d): %s player %d, %s player %d", i % (int)SNAKE_GAME_WIDTH,
+                    i / (int)SNAKE_GAME_WIDTH, name_a, a->owner[i] + 1, name_b, b->owner[i] + 1);
+            break;
+        }
+    }
+    report_entities_(&a->entities, &b->entities, name_a, name_b);
+}
+
+/* 报告当前版本在一个 tick 中改变的玩家、随机数状态、实体数量和格子 */
+static void report_step_(const SnakeContext *before, const SnakeContext *after)
+{
+    int x;
+    int y;
+    int i;
+
+    for (i = 0; i < after->player_count; i++)
+    {
+        const SnakePlayer *pb = &before->players[i];
+        const SnakePlayer *pa = &after->players[i];
+        SDL_Log("bisect:   player %d: head (%d,%d) -> (%d,%d), tail (%d,%d) -> (%d,%d), dir %d, score %u -> %u%s",
+                i + 1, pb->head_xpos, pb->head_ypos, pa->head_xpos, pa->head_ypos, pb->tail_xpos, pb->tail_ypos,
+                pa->tail_xpos, pa->tail_ypos, pa->next_dir, pb->score, pa->score,
+                pb->alive == pa->alive ? "" : (pa->alive ? ", respawned" : ", died"));
+    }
+    if (before->rng_state != after->rng_state)
+    {
+        SDL_Log("bisect:   rng_state: %016" SDL_PRIx64 " -> %016" SDL_PRIx64, before->rng_state, after->rng_state);
+    }
+    if (SDL_memcmp(before->entities.count, after->entities.count, sizeof(before->entities.count)) != 0)
+    {
+        SDL_Log("bisect:   entities (food, pickups, effects): %u/%u/%u -> %u/%u/%u",
+                before->entities.count[SNAKE_ENTITY_FOOD], before->entities.count[SNAKE_ENTITY_PICKUP],
+                before->entities.count[SNAKE_ENTITY_EFFECT], after->entities.count[SNAKE_ENTITY_FOOD],
+                after->entities.count[SNAKE_ENTITY_PICKUP], after->entities.count[SNAKE_ENTITY_EFFECT]);
+    }
+    for (y = 0; y < (int)SNAKE_GAME_HEIGHT; y++)
+    {
+        for (x = 0; x < (int)SNAKE_GAME_WIDTH; x++)
+        {
+            const SnakeCell from = snake_cell_at(before, (char)x, (char)y);
+            const SnakeCell to = snake_cell_at(after, (char)x, (char)y);
+            if (from != to)
+            {
+                SDL_Log("bisect:   cell (%d,%d): %d -> %d", x, y, from, to);
+            }
+        }
+    }
+}
+
+/* 定位第一个分歧 tick 中的差异
+ * 两份回放在 tick - 1 之前的校验和一致，因此从不晚于 tick - 1 的关键帧开始用当前版本重新模拟到 tick - 1
+ * （快照不可用时从头模拟），再执行分歧的这个 tick，逐格报告它改变了什么，并指出当前版本与哪一方一致；
+ * 分歧 tick 恰好是关键帧且两边的快照都可用时，直接比较两边在这个 tick 的完整状态
+ */
+static void report_tick_(SnakeReplayArchive *a, SnakeReplayArchive *b, Uint32 tick,
+                         const char *name_a, const char *name_b)
+{
+    SnakeReplayPlayer player_a;
+    SnakeReplayPlayer player_b;
+    SnakeContext *before = (SnakeContext *)SDL_aligned_alloc(SNAKE_CACHE_LINE, sizeof(SnakeContext));
+    SnakeContext *after = (SnakeContext *)SDL_aligned_alloc(SNAKE_CACHE_LINE, sizeof(SnakeContext));
+    const char *match;
+    Uint32 rolling;
+
+    SDL_zero(player_a);
+    SDL_zero(player_b);
+    if (!before || !after)
+    {
+        goto done;
+    }
+    if (tick % a->keyframe_interval == 0 && a->snapshots && b->snapshots)
+    {
+        if (snake_replay_seek(&player_a, a, before, tick) && snake_replay_seek(&player_b, b, after, tick))
+        {
+            SDL_Log("bisect: state at tick %u (keyframe):", tick);
+            report_differences_(before, after, name_a, name_b);
+        }
+        goto done;
+    }
+    if (tick == 0)
+    {
+        SDL_Log("bisect: the initial states differ (seed %" SDL_PRIu64 ") and the snapshots cannot be compared", a->replay.seed);
+        goto done;
+    }
+    if (!snake_replay_seek(&player_a, a, before, tick - 1))
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "bisect: %s", SDL_GetError());
+        goto done;
+    }
+    *after = *before;
+    snake_replay_step(&player_a, after);
+    rolling = snake_checksum_roll(a->checksums[tick - 1], after);
+    match = rolling == a->checksums[tick] ? name_a : (rolling == b->checksums[tick] ? name_b : "neither side");
+    SDL_Log("bisect: re-simulated from tick %u; at tick %u this build (checksum %08x) matches %s, events %02x:",
+            a->snapshots ? (tick - 1) / a->keyframe_interval * a->keyframe_interval : 0U, tick, rolling, match,
+            after->events);
+    report_step_(before, after);
+
+done:
+    SDL_aligned_free(after);
+    SDL_aligned_free(before);
+}
+
+/* 比较两份回放的校验和，返回第一个不同的 tick，完全一致时返回 ticks + 1 */
+static Uint32 first_divergence_(const SnakeReplayArchive *a, const SnakeReplayArchive *b)
+{
+    Uint32 tick;
+    for (tick = 0; tick <= a->replay.ticks; tick++)
+    {
+        if (a->checksums[tick] != b->checksums[tick])
+        {
+            break;
+        }
+    }
+    return tick;
+}
+
+SDL_AppResult snake_bisect(int argc, char *argv[])
+{
+    const char *record_path = NULL;
+    const char *paths[2] = {NULL, NULL};
+    const char *other_name;
+    Uint32 ticks = BISECT_DEFAULT_TICKS;
+    Uint64 seed = BISECT_DEFAULT_SEED;
+    SnakeReplayArchive recorded;
+    SnakeReplayArchive other;
+    Uint32 tick;
+    bool ok = false;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (SDL_strcmp(argv[i], "--bisect-record") == 0 && i + 1 < argc)
+        {
+            record_path = argv[++i];
+        }
+        else if (SDL_strcmp(argv[i], "--bisect") == 0 && i + 1 < argc)
+        {
+            paths[0] = argv[++i];
+            if (i + 1 < argc && SDL_strncmp(argv[i + 1], "--", 2) != 0)
+            {
+                paths[1] = argv[++i];
+            }
+        }
+        else if (SDL_strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+        {
+            ticks = (Uint32)SDL_strtoul(argv[++i], NULL, 10);
+        }
+        else if (SDL_strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = SDL_strtoull(argv[++i], NULL, 0);
+        }
+    }
+
+    if (record_path)
+    {
+        return record_(record_path, ticks, seed);
+    }
+    if (!paths[0])
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "bisect: usage: --bisect-record <path> | --bisect <a> [<b>]");
+        return SDL_APP_FAILURE;
+    }
+
+    other_name = paths[1] ? paths[1] : "this build";
+    SDL_zero(other);
+    if (!snake_replay_open(&recorded, paths[0]))
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "bisect: %s", SDL_GetError());
+        return SDL_APP_FAILURE;
+    }
+    /* 另一方：第二个文件，或用当前版本重新运行同一回放 */
+    if (paths[1] ? !snake_replay_open(&other, paths[1])
+                 : !snake_replay_build_keyframes(&other, &recorded.replay, recorded.keyframe_interval))
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "bisect: %s", SDL_GetError());
+        goto done;
+    }
+    if (!same_replay_(&recorded, &other))
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "bisect: %s and %s are not the same replay", paths[0], other_name);
+        goto done;
+    }
+
+    tick = first_divergence_(&recorded, &other);
+    if (tick > recorded.replay.ticks)
+    {
+        SDL_Log("bisect: no divergence in %u ticks (final checksum %08x)", recorded.replay.ticks,
+                recorded.checksums[recorded.replay.ticks]);
+        ok = true;
+        goto done;
+    }
+    SDL_Log("bisect: first diverging tick %u (checksum %08x vs %08x)", tick, recorded.checksums[tick], other.checksums[tick]);
+    report_tick_(&recorded, &other, tick, paths[0], other_name);
+
+done:
+    snake_replay_close(&other);
+    snake_replay_close(&recorded);
+    return ok ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+}
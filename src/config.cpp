@@ -0,0 +1,68 @@
+/*
+ * 配置文件实现
+ */
+
+#include "config.h"
+
+/* 去掉字符串首尾的空白，返回新的起始位置 */
+static char *trim_(char *s)
+{
+    char *end;
+    while (*s == ' ' || *s == '\t')
+    {
+        ++s;
+    }
+    end = s + SDL_strlen(s);
+    while (end > s && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r'))
+    {
+        --end;
+    }
+    *end = '\0';
+    return s;
+}
+
+bool snake_config_load(const char *path, SnakeConfigFunc func, void *userdata)
+{
+    char *text = (char *)SDL_LoadFile(path, NULL); /* SDL_LoadFile 保证以 '\0' 结尾 */
+    char *line;
+    int line_number = 0;
+
+    if (!text)
+    {
+        return false;
+    }
+
+    line = text;
+    while (line)
+    {
+        char *next = SDL_strchr(line, '\n');
+        char *eq;
+        if (next)
+        {
+            *next++ = '\0';
+        }
+        ++line_number;
+
+        line = trim_(line);
+        if (*line != '\0' && *line != '#')
+        {
+            eq = SDL_strchr(line, '=');
+            if (!eq)
+            {
+                SDL_Log("config: %s:%d: expected 'key = value'", path, line_number);
+            }
+            else
+            {
+                *eq = '\0';
+                if (!func(userdata, trim_(line), trim_(eq + 1)))
+                {
+                    SDL_Log("config: %s:%d: ignoring '%s'", path, line_number, trim_(line));
+                }
+            }
+        }
+        line = next;
+    }
+
+    SDL_free(text);
+    return true;
+}
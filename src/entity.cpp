@@ -0,0 +1,324 @@
+/*
+ * 实体存储实现
+ * 句柄表 + 每种实体一组稠密组件数组，删除时用末尾元素填补空位
+ */
+
+#include "entity.h"
+
+#define SLOT_FREE SNAKE_ENTITY_KIND_COUNT /* 空闲槽位的种类标记 */
+#define ENTITY_SLOT(h) ((h) & 0xFFFFU)
+#define ENTITY_GENERATION(h) ((h) >> 16)
+
+/* 一种实体的组件数组视图 */
+typedef struct
+{
+    Uint8 *x;
+    Uint8 *y;
+    Uint8 *value;
+    Uint8 *slot;
+    Uint16 *lifetime; /* 特效没有存活时间组件，为 NULL */
+    Uint8 capacity;
+} ComponentArrays;
+
+/* 获取指定种类实体的组件数组 */
+static ComponentArrays components_(SnakeEntities *e, int kind)
+{
+    ComponentArrays c;
+    switch (kind)
+    {
+    case SNAKE_ENTITY_FOOD:
+        c.x = e->food_x;
+        c.y = e->food_y;
+        c.value = e->food_value;
+        c.slot = e->food_slot;
+        c.lifetime = e->food_lifetime;
+        c.capacity = SNAKE_MAX_FOODS;
+        break;
+    case SNAKE_ENTITY_PICKUP:
+        c.x = e->pickup_x;
+        c.y = e->pickup_y;
+        c.value = e->pickup_value;
+        c.slot = e->pickup_slot;
+        c.lifetime = e->pickup_lifetime;
+        c.capacity = SNAKE_MAX_PICKUPS;
+        break;
+    default:
+        c.x = e->effect_x;
+        c.y = e->effect_y;
+        c.value = e->effect_ticks_left;
+        c.slot = e->effect_slot;
+        c.lifetime = NULL;
+        c.capacity = SNAKE_MAX_EFFECTS;
+        break;
+    }
+    return c;
+}
+
+/* 槽位代数加一，跳过 0 以保证 SNAKE_ENTITY_INVALID 永远无效 */
+static void bump_generation_(SnakeEntities *e, int slot)
+{
+    if (++e->generation[slot] == 0)
+    {
+        e->generation[slot] = 1;
+    }
+}
+
+/* 由槽位生成句柄 */
+static SnakeEntity make_handle_(const SnakeEntities *e, int slot)
+{
+    return (SnakeEntity)slot | ((SnakeEntity)e->generation[slot] << 16);
+}
+
+void snake_entities_clear(SnakeEntities *e)
+{
+    int i;
+    for (i = 0; i < SNAKE_MAX_ENTITIES; i++)
+    {
+        bump_generation_(e, i);
+        e->kind[i] = SLOT_FREE;
+        e->free_slots[i] = (Uint8)(SNAKE_MAX_ENTITIES - 1 - i); /* 先分配低编号槽位 */
+    }
+    e->free_count = SNAKE_MAX_ENTITIES;
+    SDL_zeroa(e->count);
+    SDL_memset(e->cell_slot, SNAKE_ENTITY_NO_SLOT, sizeof(e->cell_slot));
+    e->expiry_count = 0;
+}
+
+SnakeEntity snake_entity_create(SnakeEntities *e, SnakeEntityKind kind, char x, char y, Uint8 value)
+{
+    ComponentArrays c = components_(e, kind);
+    int slot;
+    int index;
+
+    if (e->count[kind] >= c.capacity || e->free_count == 0)
+    {
+        return SNAKE_ENTITY_INVALID;
+    }
+    slot = e->free_slots[--e->free_count];
+    index = e->count[kind]++;
+    c.x[index] = (Uint8)x;
+    c.y[index] = (Uint8)y;
+    c.value[index] = value;
+    c.slot[index] = (Uint8)slot;
+    if (c.lifetime)
+    {
+        c.lifetime[index] = 0;
+    }
+    e->kind[slot] = (Uint8)kind;
+    e->dense[slot] = (Uint8)index;
+    if (kind != SNAKE_ENTITY_EFFECT)
+    {
+        e->cell_slot[x + y * SNAKE_GAME_WIDTH] = (Uint8)slot;
+    }
+    return make_handle_(e, slot);
+}
+
+bool snake_entity_alive(const SnakeEntities *e, SnakeEntity entity)
+{
+    const Uint32 slot = ENTITY_SLOT(entity);
+    return slot < SNAKE_MAX_ENTITIES &&
+           e->kind[slot] != SLOT_FREE &&
+           e->generation[slot] == ENTITY_GENERATION(entity);
+}
+
+/* 释放槽位：把稠密数组末尾的实体移到被删除的位置 */
+static void remove_slot_(SnakeEntities *e, int slot)
+{
+    const int kind = e->kind[slot];
+    const int index = e->dense[slot];
+    ComponentArrays c = components_(e, kind);
+    const int last = --e->count[kind];
+
+    if (kind != SNAKE_ENTITY_EFFECT)
+    {
+        e->cell_slot[c.x[index] + c.y[index] * SNAKE_GAME_WIDTH] = SNAKE_ENTITY_NO_SLOT;
+    }
+    if (index != last)
+    {
+        c.x[index] = c.x[last];
+        c.y[index] = c.y[last];
+        c.value[index] = c.value[last];
+        c.slot[index] = c.slot[last];
+        if (c.lifetime)
+        {
+            c.lifetime[index] = c.lifetime[last];
+        }
+        e->dense[c.slot[index]] = (Uint8)index;
+    }
+    e->kind[slot] = SLOT_FREE;
+    bump_generation_(e, slot);
+    e->free_slots[e->free_count++] = (Uint8)slot;
+}
+
+void snake_entity_destroy(SnakeEntities *e, SnakeEntity entity)
+{
+    if (snake_entity_alive(e, entity))
+    {
+        remove_slot_(e, (int)ENTITY_SLOT(entity));
+    }
+}
+
+SnakeEntity snake_entity_at(const SnakeEntities *e, char x, char y)
+{
+    const Uint8 slot = e->cell_slot[x + y * SNAKE_GAME_WIDTH];
+    if (slot == SNAKE_ENTITY_NO_SLOT)
+    {
+        return SNAKE_ENTITY_INVALID;
+    }
+    return make_handle_(e, slot);
+}
+
+SnakeEntityKind snake_entity_kind(const SnakeEntities *e, SnakeEntity entity)
+{
+    return (SnakeEntityKind)e->kind[ENTITY_SLOT(entity)];
+}
+
+Uint8 snake_entity_value(const SnakeEntities *e, SnakeEntity entity)
+{
+    const Uint32 slot = ENTITY_SLOT(entity);
+    ComponentArrays c = components_((SnakeEntities *)e, e->kind[slot]);
+    return c.value[e->dense[slot]];
+}
+
+void snake_entity_position(const SnakeEntities *e, SnakeEntity entity, char *x, char *y)
+{
+    const Uint32 slot = ENTITY_SLOT(entity);
+    ComponentArrays c = components_((SnakeEntities *)e, e->kind[slot]);
+    *x = (char)c.x[e->dense[slot]];
+    *y = (char)c.y[e->dense[slot]];
+}
+
+void snake_entity_move(SnakeEntities *e, SnakeEntity entity, char x, char y)
+{
+    const Uint32 slot = ENTITY_SLOT(entity);
+    const int index = e->dense[slot];
+    ComponentArrays c = components_(e, e->kind[slot]);
+    e->cell_slot[c.x[index] + c.y[index] * SNAKE_GAME_WIDTH] = SNAKE_ENTITY_NO_SLOT;
+    c.x[index] = (Uint8)x;
+    c.y[index] = (Uint8)y;
+    e->cell_slot[x + y * SNAKE_GAME_WIDTH] = (Uint8)slot;
+}
+
+Uint16 snake_entity_lifetime(const SnakeEntities *e, SnakeEntity entity)
+{
+    const Uint32 slot = ENTITY_SLOT(entity);
+    ComponentArrays c = components_((SnakeEntities *)e, e->kind[slot]);
+    return c.lifetime ? c.lifetime[e->dense[slot]] : 0;
+}
+
+/* 到期堆：上浮 */
+static void expiry_sift_up_(SnakeEntities *e, int i)
+{
+    const SnakeExpiry item = e->expiry[i];
+    while (i > 0)
+    {
+        const int parent = (i - 1) / 2;
+        if (e->expiry[parent].due_tick <= item.due_tick)
+        {
+            break;
+        }
+        e->expiry[i] = e->expiry[parent];
+        i = parent;
+    }
+    e->expiry[i] = item;
+}
+
+/* 到期堆：下沉 */
+static void expiry_sift_down_(SnakeEntities *e, int i)
+{
+    const SnakeExpiry item = e->expiry[i];
+    const int count = e->expiry_count;
+    while (true)
+    {
+        int child = i * 2 + 1;
+        if (child >= count)
+        {
+            break;
+        }
+        if (child + 1 < count && e->expiry[child + 1].due_tick < e->expiry[child].due_tick)
+        {
+            ++child;
+        }
+        if (item.due_tick <= e->expiry[child].due_tick)
+        {
+            break;
+        }
+        e->expiry[i] = e->expiry[child];
+        i = child;
+    }
+    e->expiry[i] = item;
+}
+
+/* 丢弃已失效实体的记录并重建堆
+ * 每个存活实体最多只有一条记录，因此清理后一定有空位
+ */
+static void expiry_purge_(SnakeEntities *e)
+{
+    int n = 0;
+    int i;
+    for (i = 0; i < e->expiry_count; i++)
+    {
+        if (snake_entity_alive(e, e->expiry[i].entity))
+        {
+            e->expiry[n++] = e->expiry[i];
+        }
+    }
+    e->expiry_count = (Uint8)n;
+    for (i = n / 2 - 1; i >= 0; i--)
+    {
+        expiry_sift_down_(e, i);
+    }
+}
+
+void snake_entity_set_lifetime(SnakeEntities *e, SnakeEntity entity, Uint16 lifetime, Uint32 now)
+{
+    const Uint32 slot = ENTITY_SLOT(entity);
+    ComponentArrays c = components_(e, e->kind[slot]);
+    if (!c.lifetime)
+    {
+        return;
+    }
+    c.lifetime[e->dense[slot]] = lifetime;
+    if (lifetime == 0)
+    {
+        return;
+    }
+    if (e->expiry_count >= SNAKE_MAX_EXPIRIES)
+    {
+        expiry_purge_(e);
+    }
+    e->expiry[e->expiry_count].due_tick = now + lifetime;
+    e->expiry[e->expiry_count].entity = entity;
+    expiry_sift_up_(e, e->expiry_count++);
+}
+
+SnakeEntity snake_entities_pop_expired(SnakeEntities *e, Uint32 now)
+{
+    while (e->expiry_count > 0 && e->expiry[0].due_tick <= now)
+    {
+        const SnakeEntity entity = e->expiry[0].entity;
+        e->expiry[0] = e->expiry[--e->expiry_count];
+        if (e->expiry_count > 0)
+        {
+            expiry_sift_down_(e, 0);
+        }
+        if (snake_entity_alive(e, entity))
+        {
+            return entity;
+        }
+    }
+    return SNAKE_ENTITY_INVALID;
+}
+
+void snake_entities_tick(SnakeEntities *e)
+{
+    int i;
+    /* 倒序遍历，删除时移入的末尾元素已经处理过 */
+    for (i = e->count[SNAKE_ENTITY_EFFECT] - 1; i >= 0; i--)
+    {
+        if (--e->effect_ticks_left[i] == 0)
+        {
+            remove_slot_(e, e->effect_slot[i]);
+        }
+    }
+}
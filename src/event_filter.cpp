@@ -0,0 +1,151 @@
+/*
+ * 事件过滤实现
+ * SDL 在调用过滤器之前已经更新了键盘、鼠标和手柄的内部状态，
+ * 丢弃事件不会影响 SDL_GetKeyboardState 等状态查询
+ */
+
+#include "event_filter.h"
+
+/* 事件类别名称 */
+static const char *const event_category_names[SNAKE_EVENT_CATEGORY_COUNT] = {
+    "quit",
+    "window",
+    "key-down",
+    "key-repeat",
+    "key-up",
+    "text",
+    "mouse",
+    "touch",
+    "joystick",
+    "gamepad",
+    "gamepad-other",
+    "sensor",
+    "other"};
+
+/* 需要丢弃的事件类别；窗口等事件照常通过，渲染器等 SDL 内部模块还要使用 */
+static const bool drop_category[SNAKE_EVENT_CATEGORY_COUNT] = {
+    false, /* quit */
+    false, /* window */
+    false, /* key-down */
+    true,  /* key-repeat */
+    true,  /* key-up */
+    true,  /* text */
+    true,  /* mouse */
+    true,  /* touch */
+    true,  /* joystick */
+    false, /* gamepad */
+    true,  /* gamepad-other */
+    true,  /* sensor */
+    false  /* other */
+};
+
+const char *snake_event_category_name(SnakeEventCategory category)
+{
+    if ((unsigned)category >= SNAKE_EVENT_CATEGORY_COUNT)
+    {
+        return "unknown";
+    }
+    return event_category_names[category];
+}
+
+SnakeEventCategory snake_event_category(const SDL_Event *event)
+{
+    const Uint32 type = event->type;
+    switch (type)
+    {
+    case SDL_EVENT_QUIT:
+        return SNAKE_EVENT_CATEGORY_QUIT;
+    case SDL_EVENT_KEY_DOWN:
+        return event->key.repeat ? SNAKE_EVENT_CATEGORY_KEY_REPEAT : SNAKE_EVENT_CATEGORY_KEY_DOWN;
+    case SDL_EVENT_KEY_UP:
+        return SNAKE_EVENT_CATEGORY_KEY_UP;
+    case SDL_EVENT_TEXT_EDITING:
+    case SDL_EVENT_TEXT_INPUT:
+    case SDL_EVENT_TEXT_EDITING_CANDIDATES:
+        return SNAKE_EVENT_CATEGORY_TEXT;
+    case SDL_EVENT_MOUSE_MOTION:
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+    case SDL_EVENT_MOUSE_BUTTON_UP:
+    case SDL_EVENT_MOUSE_WHEEL:
+        return SNAKE_EVENT_CATEGORY_MOUSE;
+    case SDL_EVENT_FINGER_DOWN:
+    case SDL_EVENT_FINGER_UP:
+    case SDL_EVENT_FINGER_MOTION:
+    case SDL_EVENT_FINGER_CANCELED:
+        return SNAKE_EVENT_CATEGORY_TOUCH;
+    case SDL_EVENT_GAMEPAD_ADDED:
+    case SDL_EVENT_GAMEPAD_REMOVED:
+    case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
+    case SDL_EVENT_GAMEPAD_AXIS_MOTION:
+        return SNAKE_EVENT_CATEGORY_GAMEPAD;
+    case SDL_EVENT_GAMEPAD_BUTTON_UP:
+    case SDL_EVENT_GAMEPAD_TOUCHPAD_DOWN:
+    case SDL_EVENT_GAMEPAD_TOUCHPAD_MOTION:
+    case SDL_EVENT_GAMEPAD_TOUCHPAD_UP:
+    case SDL_EVENT_GAMEPAD_SENSOR_UPDATE:
+        return SNAKE_EVENT_CATEGORY_GAMEPAD_OTHER;
+    case SDL_EVENT_SENSOR_UPDATE:
+        return SNAKE_EVENT_CATEGORY_SENSOR;
+    }
+    if (type < SDL_EVENT_DISPLAY_FIRST)
+    {
+        return SNAKE_EVENT_CATEGORY_QUIT; /* 应用生命周期事件 */
+    }
+    if (type <= SDL_EVENT_WINDOW_LAST)
+    {
+        return SNAKE_EVENT_CATEGORY_WINDOW;
+    }
+    if (type >= SDL_EVENT_JOYSTICK_AXIS_MOTION && type <= SDL_EVENT_JOYSTICK_UPDATE_COMPLETE)
+    {
+        return SNAKE_EVENT_CATEGORY_JOYSTICK;
+    }
+    if (type >= SDL_EVENT_PEN_PROXIMITY_IN && type <= SDL_EVENT_PEN_AXIS)
+    {
+        return SNAKE_EVENT_CATEGORY_TOUCH;
+    }
+    return SNAKE_EVENT_CATEGORY_OTHER;
+}
+
+/* SDL 事件过滤器：返回 false 的事件不会进入队列，也不会传给 SDL_AppEvent */
+static bool SDLCALL event_filter_(void *userdata, SDL_Event *event)
+{
+    SnakeEventStats *stats = (SnakeEventStats *)userdata;
+    const SnakeEventCategory category = snake_event_category(event);
+    if (drop_category[category])
+    {
+        SDL_AddAtomicInt(&stats->dropped[category], 1);
+        return false;
+    }
+    SDL_AddAtomicInt(&stats->passed[category], 1);
+    return true;
+}
+
+void snake_event_filter_install(SnakeEventStats *stats)
+{
+    SDL_SetEventFilter(event_filter_, stats);
+}
+
+void snake_event_filter_remove(void)
+{
+    SDL_SetEventFilter(NULL, NULL);
+}
+
+void snake_event_stats_log(SnakeEventStats *stats)
+{
+    int total_passed = 0;
+    int total_dropped = 0;
+    int i;
+    for (i = 0; i < SNAKE_EVENT_CATEGORY_COUNT; i++)
+    {
+        const int passed = SDL_GetAtomicInt(&stats->passed[i]);
+        const int dropped = SDL_GetAtomicInt(&stats->dropped[i]);
+        if (passed + dropped > 0)
+        {
+            SDL_Log("events: %-13s passed %8d dropped %8d", event_category_names[i], passed, dropped);
+        }
+        total_passed += passed;
+        total_dropped += dropped;
+    }
+    SDL_Log("events: %d queued, %d dropped (%.1f%% of traffic removed)", total_passed, total_dropped,
+            total_passed + total_dropped > 0 ? 100.0 * total_dropped / (total_passed + total_dropped) : 0.0);
+}
@@ -0,0 +1,216 @@
+/*
+ * 经验回放缓冲区实现
+ * 转移按加入顺序保存在环形数组中，第 i 个转移的下一个观察是第 i + 1 个位置的帧；
+ * 求和树的叶子数取不小于容量的 2 的幂，tree[1] 为所有优先级之和，叶子从 tree[leaves] 开始，
+ * 不能采样的位置（空位和最新的转移）优先级为 0
+ */
+
+#include "experience.h"
+
+struct SnakeExperience
+{
+    Uint32 capacity;
+    Uint32 leaves;            /* 求和树的叶子数 */
+    Uint32 next;              /* 下一次加入的位置 */
+    Uint32 count;             /* 已保存的转移数量（不超过容量） */
+    float alpha;
+    double max_priority;      /* 目前见过的最大优先级 */
+    double newest_priority;   /* 最新转移的优先级，等到下一次加入之后写入求和树 */
+    Uint8 *frames;            /* [capacity][SNAKE_CELLS_BYTES] 每个转移执行动作之前的场地 */
+    Uint8 *actions;
+    float *rewards;
+    Uint8 *dones;
+    double *tree;             /* [2 * leaves] */
+};
+
+/* 设置一个叶子的优先级并重新计算到根的各级和（重新求和而不是加差值，不会累积舍入误差） */
+static void set_priority_(SnakeExperience *exp, Uint32 index, double priority)
+{
+    Uint32 node = exp->leaves + index;
+    exp->tree[node] = priority;
+    for (node >>= 1; node > 0; node >>= 1)
+    {
+        exp->tree[node] = exp->tree[2 * node] + exp->tree[2 * node + 1];
+    }
+}
+
+/* 找到前缀和区间包含 u 的叶子；舍入使 u 落到和为 0 的子树时改走另一侧，保证结果的优先级大于 0 */
+static Uint32 find_(const SnakeExperience *exp, double u)
+{
+    Uint32 node = 1;
+    while (node < exp->leaves)
+    {
+        const Uint32 left = 2 * node;
+        if ((u < exp->tree[left] || exp->tree[left + 1] <= 0.0) && exp->tree[left] > 0.0)
+        {
+            node = left;
+        }
+        else
+        {
+            u -= exp->tree[left];
+            node = left + 1;
+        }
+    }
+    return node - exp->leaves;
+}
+
+/* 最新的转移（还没有下一个观察） */
+static Uint32 newest_(const SnakeExperience *exp)
+{
+    return (exp->next + exp->capacity - 1) % exp->capacity;
+}
+
+SnakeExperience *snake_experience_create(Uint32 capacity, float alpha)
+{
+    SnakeExperience *exp;
+    Uint32 leaves = 1;
+
+    if (capacity < 2 || capacity > 0x80000000U)
+    {
+        SDL_InvalidParamError("capacity");
+        return NULL;
+    }
+    while (leaves < capacity)
+    {
+        leaves *= 2;
+    }
+    exp = (SnakeExperience *)SDL_calloc(1, sizeof(SnakeExperience));
+    if (!exp)
+    {
+        return NULL;
+    }
+    exp->capacity = capacity;
+    exp->leaves = leaves;
+    exp->alpha = alpha;
+    exp->max_priority = 1.0;
+    exp->frames = (Uint8 *)SDL_malloc((size_t)capacity * SNAKE_CELLS_BYTES);
+    exp->actions = (Uint8 *)SDL_malloc(capacity);
+    exp->rewards = (float *)SDL_malloc((size_t)capacity * sizeof(float));
+    exp->dones = (Uint8 *)SDL_malloc(capacity);
+    exp->tree = (double *)SDL_calloc(2 * (size_t)leaves, sizeof(double));
+    if (!exp->frames || !exp->actions || !exp->rewards || !exp->dones || !exp->tree)
+    {
+        snake_experience_destroy(exp);
+        return NULL;
+    }
+    return exp;
+}
+
+void snake_experience_destroy(SnakeExperience *exp)
+{
+    if (!exp)
+    {
+        return;
+    }
+    SDL_free(exp->tree);
+    SDL_free(exp->dones);
+    SDL_free(exp->rewards);
+    SDL_free(exp->actions);
+    SDL_free(exp->frames);
+    SDL_free(exp);
+}
+
+void snake_experience_add(SnakeExperience *exp, const unsigned char *obs, Uint8 action, float reward, bool done)
+{
+    const Uint32 slot = exp->next;
+
+    /* 上一个转移有了下一个观察，可以采样了 */
+    if (exp->count > 0)
+    {
+        set_priority_(exp, newest_(exp), exp->newest_priority);
+    }
+    SDL_memcpy(exp->frames + (size_t)slot * SNAKE_CELLS_BYTES, obs, SNAKE_CELLS_BYTES);
+    exp->actions[slot] = action;
+    exp->rewards[slot] = reward;
+    exp->dones[slot] = done;
+    set_priority_(exp, slot, 0.0); /* 覆盖的旧转移一并移出求和树 */
+    exp->newest_priority = exp->max_priority;
+
+    exp->next = (slot + 1) % exp->capacity;
+    exp->count = SDL_min(exp->count + 1, exp->capacity);
+}
+
+Uint32 snake_experience_size(const SnakeExperience *exp)
+{
+    return exp->count > 0 ? exp->count - 1 : 0;
+}
+
+size_t snake_experience_bytes(const SnakeExperience *exp)
+{
+    return sizeof(SnakeExperience) +
+           (size_t)exp->capacity * (SNAKE_CELLS_BYTES + sizeof(Uint8) + sizeof(float) + sizeof(Uint8)) +
+           2 * (size_t)exp->leaves * sizeof(double);
+}
+
+void snake_experience_decode(const unsigned char *cells, float *out)
+{
+    Uint32 i;
+    for (i = 0; i < SNAKE_MATRIX_SIZE; i++)
+    {
+        const Uint32 bit = i * SNAKE_CELL_MAX_BITS;
+        const Uint32 byte = bit / 8;
+        const Uint32 pair = cells[byte] | (byte + 1 < SNAKE_CELLS_BYTES ? (Uint32)cells[byte + 1] << 8 : 0U);
+        out[i] = (float)((pair >> (bit % 8)) & THREE_BITS);
+    }
+}
+
+Uint32 snake_experience_sample(SnakeExperience *exp, Uint32 count, float beta, Uint64 *rng, SnakeExperienceBatch *batch)
+{
+    const double total = exp->tree[1];
+    const Uint32 size = snake_experience_size(exp);
+    float max_weight = 0.0f;
+    double segment;
+    Uint32 k;
+
+    if (total <= 0.0 || count == 0)
+    {
+        return 0;
+    }
+    segment = total / count;
+
+    /* 分层采样：把总和分为 count 段，每段内均匀取一个点 */
+    for (k = 0; k < count; k++)
+    {
+        const double u = SDL_min((k + (double)SDL_randf_r(rng)) * segment, total);
+        const Uint32 index = find_(exp, u);
+        const Uint32 next = (index + 1) % exp->capacity;
+
+        batch->indices[k] = index;
+        batch->actions[k] = exp->actions[index];
+        batch->rewards[k] = exp->rewards[index];
+        batch->dones[k] = exp->dones[index];
+        snake_experience_decode(exp->frames + (size_t)index * SNAKE_CELLS_BYTES, batch->obs + (size_t)k * SNAKE_MATRIX_SIZE);
+        snake_experience_decode(exp->frames + (size_t)next * SNAKE_CELLS_BYTES, batch->next_obs + (size_t)k * SNAKE_MATRIX_SIZE);
+        if (batch->weights)
+        {
+            /* (N * P(i)) ^ -beta */
+            const double p = exp->tree[exp->leaves + index] / total;
+            batch->weights[k] = (float)SDL_pow(size * p, -beta);
+            max_weight = SDL_max(max_weight, batch->weights[k]);
+        }
+    }
+    if (batch->weights && max_weight > 0.0f)
+    {
+        for (k = 0; k < count; k++)
+        {
+            batch->weights[k] /= max_weight;
+        }
+    }
+    return count;
+}
+
+void snake_experience_update(SnakeExperience *exp, const Uint32 *indices, const float *errors, Uint32 count)
+{
+    Uint32 k;
+    for (k = 0; k < count; k++)
+    {
+        const double priority = SDL_pow(SDL_fabs(errors[k]) + SNAKE_EXPERIENCE_PRIORITY_EPSILON, exp->alpha);
+        /* 采样之后又加入了转移时，这个位置可能已被最新的转移覆盖，它还不能采样 */
+        if (indices[k] >= exp->count || indices[k] == newest_(exp))
+        {
+            continue;
+        }
+        exp->max_priority = SDL_max(exp->max_priority, priority);
+        set_priority_(exp, indices[k], priority);
+    }
+}
@@ -0,0 +1,203 @@
+/*
+ * 经验回放缓冲区检查
+ * 用随机对局填满缓冲区（绕过一圈以上），同时按朴素的方式（每格一个浮点数，观察和下一个观察各存一份）
+ * 保存同样的转移作为参照：
+ *   采样解码的每个转移必须与参照一致，且不会采到还没有下一个观察的最新转移；
+ *   把一个转移的优先级设为其他转移的 1000 倍，它被采样的比例必须接近理论值；
+ *   每个转移占用的内存至少比朴素保存少 10 倍
+ */
+
+#include "headless.h"
+#include "batch.h"
+#include "experience.h"
+#include "trajectory.h"
+
+#define EXPERIENCE_CHECK_CAPACITY 16384   /* 默认容量 */
+#define EXPERIENCE_CHECK_LAPS 3           /* 加入的转移数为容量的几倍 */
+#define EXPERIENCE_CHECK_BATCH 64
+#define EXPERIENCE_CHECK_BATCHES 256      /* 与参照比较的批数 */
+#define EXPERIENCE_CHECK_DRAWS 200000     /* 检查优先级比例的采样数 */
+#define EXPERIENCE_CHECK_BOOST 1000.0     /* 高优先级转移的倍数 */
+#define EXPERIENCE_CHECK_TOLERANCE 0.1    /* 采样比例与理论值的相对误差上限 */
+#define EXPERIENCE_CHECK_MIN_RATIO 10.0   /* 内存至少减少的倍数 */
+#define EXPERIENCE_CHECK_ALPHA 0.6f
+#define EXPERIENCE_CHECK_BETA 0.4f
+
+/* 朴素保存的转移 */
+typedef struct
+{
+    float obs[SNAKE_MATRIX_SIZE];
+    float next_obs[SNAKE_MATRIX_SIZE];
+    Uint8 action;
+    float reward;
+    Uint8 done;
+} NaiveTransition;
+
+/* 一批采样结果的存储 */
+typedef struct
+{
+    float obs[EXPERIENCE_CHECK_BATCH][SNAKE_MATRIX_SIZE];
+    float next_obs[EXPERIENCE_CHECK_BATCH][SNAKE_MATRIX_SIZE];
+    Uint8 actions[EXPERIENCE_CHECK_BATCH];
+    float rewards[EXPERIENCE_CHECK_BATCH];
+    Uint8 dones[EXPERIENCE_CHECK_BATCH];
+    Uint32 indices[EXPERIENCE_CHECK_BATCH];
+    float weights[EXPERIENCE_CHECK_BATCH];
+} BatchStorage;
+
+/* 用随机对局填充缓冲区和参照 */
+static void fill_(SnakeExperience *exp, NaiveTransition *naive, Uint32 capacity, SnakeContext *ctx, Uint64 *rng)
+{
+    Uint32 tick;
+
+    snake_initialize_seeded(ctx, *rng);
+    for (tick = 0; tick < capacity * EXPERIENCE_CHECK_LAPS; tick++)
+    {
+        NaiveTransition *ref = &naive[tick % capacity];
+        const SnakePlayer prev = ctx->players[0];
+        unsigned char obs[SNAKE_CELLS_BYTES];
+        Uint8 turn;
+        bool done;
+
+        SDL_memcpy(obs, ctx->cells, sizeof(obs));
+        snake_batch_random_turns(&turn, 1, rng);
+        if (turn != SNAKE_BATCH_NO_TURN)
+        {
+            snake_redir(ctx, (SnakeDirection)turn);
+        }
+        ref->action = ctx->players[0].next_dir != prev.next_dir ? (Uint8)ctx->players[0].next_dir : SNAKE_TRAJECTORY_NO_ACTION;
+        snake_step(ctx);
+        ref->reward = snake_trajectory_reward(ctx, &prev, &done);
+        ref->done = done;
+        snake_experience_decode(obs, ref->obs);
+        snake_experience_decode(ctx->cells, ref->next_obs);
+        snake_experience_add(exp, obs, ref->action, ref->reward, done);
+    }
+}
+
+SDL_AppResult snake_experience_check(int argc, char *argv[])
+{
+    Uint32 capacity = EXPERIENCE_CHECK_CAPACITY;
+    SnakeExperience *exp = NULL;
+    NaiveTransition *naive = NULL;
+    BatchStorage *storage = (BatchStorage *)SDL_malloc(sizeof(BatchStorage));
+    SnakeContext *ctx = (SnakeContext *)SDL_aligned_alloc(SNAKE_CACHE_LINE, sizeof(SnakeContext));
+    SnakeExperienceBatch batch;
+    Uint64 rng = 0xE9E7;
+    Uint64 start;
+    Uint64 sample_ns = 0;
+    Uint32 newest;
+    Uint32 boosted;
+    Uint32 hits = 0;
+    Uint32 draws = 0;
+    double ratio;
+    double expected;
+    float boosted_error;
+    Uint32 b;
+    Uint32 k;
+    bool ok = false;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (SDL_strcmp(argv[i], "--experience-capacity") == 0 && i + 1 < argc)
+        {
+            capacity = (Uint32)SDL_strtoul(argv[++i], NULL, 10);
+        }
+    }
+    capacity = SDL_max(capacity, 2U);
+    naive = (NaiveTransition *)SDL_malloc((size_t)capacity * sizeof(NaiveTransition));
+    exp = snake_experience_create(capacity, EXPERIENCE_CHECK_ALPHA);
+    if (!storage || !ctx || !naive || !exp)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "experience-check: out of memory");
+        goto done;
+    }
+    batch.obs = &storage->obs[0][0];
+    batch.next_obs = &storage->next_obs[0][0];
+    batch.actions = storage->actions;
+    batch.rewards = storage->rewards;
+    batch.dones = storage->dones;
+    batch.indices = storage->indices;
+    batch.weights = storage->weights;
+
+    start = SDL_GetTicksNS();
+    fill_(exp, naive, capacity, ctx, &rng);
+    SDL_Log("experience-check: added %u transitions in %.1f ms (%.0f ns each)", capacity * EXPERIENCE_CHECK_LAPS,
+            (SDL_GetTicksNS() - start) / 1e6, (double)(SDL_GetTicksNS() - start) / (capacity * EXPERIENCE_CHECK_LAPS));
+    if (snake_experience_size(exp) != capacity - 1)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "experience-check: %u transitions can be sampled, expected %u",
+                     snake_experience_size(exp), capacity - 1);
+        goto done;
+    }
+
+    /* 内存 */
+    ratio = (double)capacity * sizeof(NaiveTransition) / snake_experience_bytes(exp);
+    SDL_Log("experience-check: %.1f bytes per transition, naive float storage %u bytes (%.1fx smaller)",
+            (double)snake_experience_bytes(exp) / capacity, (unsigned)sizeof(NaiveTransition), ratio);
+    if (ratio < EXPERIENCE_CHECK_MIN_RATIO)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "experience-check: only %.1fx smaller than naive storage", ratio);
+        goto done;
+    }
+
+    /* 采样解码与参照比较 */
+    newest = (capacity * EXPERIENCE_CHECK_LAPS - 1) % capacity;
+    for (b = 0; b < EXPERIENCE_CHECK_BATCHES; b++)
+    {
+        start = SDL_GetTicksNS();
+        snake_experience_sample(exp, EXPERIENCE_CHECK_BATCH, EXPERIENCE_CHECK_BETA, &rng, &batch);
+        sample_ns += SDL_GetTicksNS() - start;
+        for (k = 0; k < EXPERIENCE_CHECK_BATCH; k++)
+        {
+            const Uint32 index = storage->indices[k];
+            const NaiveTransition *ref = &naive[index];
+            if (index == newest || index >= capacity ||
+                SDL_memcmp(storage->obs[k], ref->obs, sizeof(ref->obs)) != 0 ||
+                SDL_memcmp(storage->next_obs[k], ref->next_obs, sizeof(ref->next_obs)) != 0 ||
+                storage->actions[k] != ref->action || storage->rewards[k] != ref->reward || storage->dones[k] != ref->done)
+            {
+                SDL_LogError(SDL_LOG_CATEGORY_TEST, "experience-check: sampled transition %u does not match", index);
+                goto done;
+            }
+        }
+    }
+    SDL_Log("experience-check: %d batches of %d match the reference, %.2f us per batch (sample and decode)",
+            EXPERIENCE_CHECK_BATCHES, EXPERIENCE_CHECK_BATCH, sample_ns / 1e3 / EXPERIENCE_CHECK_BATCHES);
+
+    /* 优先级比例：误差为 0 的转移优先级为 epsilon ^ alpha，一个转移为其 1000 倍 */
+    for (k = 0; k < capacity; k++)
+    {
+        const float zero = 0.0f;
+        snake_experience_update(exp, &k, &zero, 1);
+    }
+    boosted = (newest + capacity / 2) % capacity;
+    boosted_error = (float)(SNAKE_EXPERIENCE_PRIORITY_EPSILON * SDL_pow(EXPERIENCE_CHECK_BOOST, 1.0 / EXPERIENCE_CHECK_ALPHA) -
+                            SNAKE_EXPERIENCE_PRIORITY_EPSILON);
+    snake_experience_update(exp, &boosted, &boosted_error, 1);
+    while (draws < EXPERIENCE_CHECK_DRAWS)
+    {
+        snake_experience_sample(exp, EXPERIENCE_CHECK_BATCH, EXPERIENCE_CHECK_BETA, &rng, &batch);
+        for (k = 0; k < EXPERIENCE_CHECK_BATCH; k++)
+        {
+            hits += storage->indices[k] == boosted;
+        }
+        draws += EXPERIENCE_CHECK_BATCH;
+    }
+    expected = EXPERIENCE_CHECK_BOOST / (capacity - 2 + EXPERIENCE_CHECK_BOOST);
+    SDL_Log("experience-check: boosted transition sampled %.4f of the time, expected %.4f", (double)hits / draws, expected);
+    if (SDL_fabs((double)hits / draws / expected - 1.0) > EXPERIENCE_CHECK_TOLERANCE)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "experience-check: sampling does not follow the priorities");
+        goto done;
+    }
+    ok = true;
+
+done:
+    snake_experience_destroy(exp);
+    SDL_free(naive);
+    SDL_aligned_free(ctx);
+    SDL_free(storage);
+    return ok ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+}
@@ -0,0 +1,147 @@
+/*
+ * 回退历史实现
+ * 记录格式：[长度 u16] { [偏移 u16] [字节数 u8] [旧值...] }* [长度 u16]，
+ * 首尾都保存长度，既可以从最旧一端丢弃，也可以从最新一端回退
+ */
+
+#include "history.h"
+
+#define HISTORY_MASK (SNAKE_HISTORY_BYTES - 1)
+#define HISTORY_MERGE_GAP 4  /* 相距不超过此字节数的变化合并为一段（段头占 3 字节） */
+#define HISTORY_MAX_RUN 255  /* 单段的最大字节数 */
+
+SDL_COMPILE_TIME_ASSERT(history_bytes_pow2, (SNAKE_HISTORY_BYTES & HISTORY_MASK) == 0);
+SDL_COMPILE_TIME_ASSERT(history_offset_fits, sizeof(SnakeContext) <= 0xFFFF);
+
+/* 从环形缓冲区的 pos 处读取 size 字节（可能跨越末尾） */
+static void ring_read_(const SnakeHistory *history, Uint32 pos, void *dst, Uint32 size)
+{
+    const Uint32 index = pos & HISTORY_MASK;
+    const Uint32 first = SDL_min(size, SNAKE_HISTORY_BYTES - index);
+    SDL_memcpy(dst, history->ring + index, first);
+    SDL_memcpy((Uint8 *)dst + first, history->ring, size - first);
+}
+
+/* 向环形缓冲区的 pos 处写入 size 字节（可能跨越末尾） */
+static void ring_write_(SnakeHistory *history, Uint32 pos, const void *src, Uint32 size)
+{
+    const Uint32 index = pos & HISTORY_MASK;
+    const Uint32 first = SDL_min(size, SNAKE_HISTORY_BYTES - index);
+    SDL_memcpy(history->ring + index, src, first);
+    SDL_memcpy(history->ring, (const Uint8 *)src + first, size - first);
+}
+
+static Uint16 ring_read16_(const SnakeHistory *history, Uint32 pos)
+{
+    Uint16 v;
+    ring_read_(history, pos, &v, sizeof(v));
+    return v;
+}
+
+void snake_history_reset(SnakeHistory *history, const SnakeContext *ctx)
+{
+    history->head = 0;
+    history->tail = 0;
+    history->count = 0;
+    history->shadow = *ctx;
+}
+
+void snake_history_record(SnakeHistory *history, const SnakeContext *ctx)
+{
+    Uint8 *old = (Uint8 *)&history->shadow;
+    const Uint8 *cur = (const Uint8 *)ctx;
+    Uint8 *out = history->scratch;
+    Uint32 size = 2;
+    Uint16 size16;
+    size_t i = 0;
+
+    while (i < sizeof(SnakeContext))
+    {
+        size_t start;
+        size_t end;
+        size_t j;
+        Uint64 a;
+        Uint64 b;
+
+        /* 大部分字节不变，先按 8 字节跳过 */
+        if (i + sizeof(Uint64) <= sizeof(SnakeContext))
+        {
+            SDL_memcpy(&a, old + i, sizeof(a));
+            SDL_memcpy(&b, cur + i, sizeof(b));
+            if (a == b)
+            {
+                i += sizeof(Uint64);
+                continue;
+            }
+        }
+        if (old[i] == cur[i])
+        {
+            ++i;
+            continue;
+        }
+
+        /* 找到一段变化 [start, end)，中间允许少量未变的字节 */
+        start = i;
+        end = i + 1;
+        for (j = end; j < sizeof(SnakeContext) && j - start < HISTORY_MAX_RUN && j - end < HISTORY_MERGE_GAP; j++)
+        {
+            if (old[j] != cur[j])
+            {
+                end = j + 1;
+            }
+        }
+
+        out[size++] = (Uint8)(start & 0xFF);
+        out[size++] = (Uint8)(start >> 8);
+        out[size++] = (Uint8)(end - start);
+        SDL_memcpy(out + size, old + start, end - start);
+        size += (Uint32)(end - start);
+        SDL_memcpy(old + start, cur + start, end - start);
+        i = end;
+    }
+    size += 2;
+    size16 = (Uint16)size;
+    SDL_memcpy(out, &size16, sizeof(size16));
+    SDL_memcpy(out + size - 2, &size16, sizeof(size16));
+
+    /* 空间不足时丢弃最旧的记录 */
+    while (SNAKE_HISTORY_BYTES - (history->head - history->tail) < size)
+    {
+        history->tail += ring_read16_(history, history->tail);
+        --history->count;
+    }
+    ring_write_(history, history->head, out, size);
+    history->head += size;
+    ++history->count;
+}
+
+int snake_history_rewind(SnakeHistory *history, SnakeContext *ctx, int ticks)
+{
+    Uint8 *state = (Uint8 *)&history->shadow;
+    int rewound = 0;
+
+    while (rewound < ticks && history->count > 0)
+    {
+        const Uint32 size = ring_read16_(history, history->head - 2);
+        const Uint32 end = history->head - 2;
+        Uint32 pos = history->head - size + 2;
+
+        while (pos != end)
+        {
+            Uint8 header[3];
+            ring_read_(history, pos, header, sizeof(header));
+            ring_read_(history, pos + 3, state + (header[0] | (header[1] << 8)), header[2]);
+            pos += 3 + header[2];
+        }
+        history->head -= size;
+        --history->count;
+        ++rewound;
+    }
+    *ctx = history->shadow;
+    return rewound;
+}
+
+Uint32 snake_history_bytes(const SnakeHistory *history)
+{
+    return history->head - history->tail;
+}
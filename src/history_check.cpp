@@ -0,0 +1,86 @@
+/*
+ * 回退检查
+ * 以默认速度模拟十分钟的随机对局，同时记录回退历史和每个 tick 的完整状态，
+ * 再逐段回退并与完整状态比较
+ */
+
+#include "headless.h"
+#include "batch.h"
+#include "history.h"
+
+#define REWIND_CHECK_TICKS (10 * 60 * 1000 / STEP_RATE_IN_MILLISECONDS) /* 十分钟 */
+#define REWIND_CHECK_STEP 60        /* 每次回退的 tick 数 */
+
+SDL_AppResult snake_rewind_check(int argc, char *argv[])
+{
+    SnakeHistory *history = (SnakeHistory *)SDL_aligned_alloc(SNAKE_CACHE_LINE, sizeof(SnakeHistory));
+    SnakeContext *states = (SnakeContext *)SDL_aligned_alloc(SNAKE_CACHE_LINE, (REWIND_CHECK_TICKS + 1) * sizeof(SnakeContext));
+    SnakeContext *ctx = (SnakeContext *)SDL_aligned_alloc(SNAKE_CACHE_LINE, sizeof(SnakeContext));
+    Uint64 rng = 0x4E3D;
+    Uint64 rewind_ns = 0;
+    Uint64 max_rewind_ns = 0;
+    Uint32 history_bytes;
+    int rewinds = 0;
+    int tick;
+    bool ok = false;
+
+    (void)argc;
+    (void)argv;
+    if (!history || !states || !ctx)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "rewind-check: out of memory");
+        goto done;
+    }
+
+    snake_initialize_seeded(ctx, rng);
+    snake_history_reset(history, ctx);
+    states[0] = *ctx;
+    for (tick = 1; tick <= REWIND_CHECK_TICKS; tick++)
+    {
+        Uint8 turn;
+        snake_batch_random_turns(&turn, 1, &rng);
+        if (turn != SNAKE_BATCH_NO_TURN)
+        {
+            snake_redir(ctx, (SnakeDirection)turn);
+        }
+        snake_step(ctx);
+        snake_history_record(history, ctx);
+        states[tick] = *ctx;
+    }
+    history_bytes = snake_history_bytes(history);
+    if (history->count != REWIND_CHECK_TICKS)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "rewind-check: history kept only %u of %d ticks in %u KiB",
+                     history->count, REWIND_CHECK_TICKS, SNAKE_HISTORY_BYTES / 1024);
+        goto done;
+    }
+
+    /* 从最新的 tick 一路回退到开头，states[tick] 为执行 tick 次 snake_step 之后的状态 */
+    tick = REWIND_CHECK_TICKS;
+    while (tick > 0)
+    {
+        const Uint64 start = SDL_GetTicksNS();
+        const int rewound = snake_history_rewind(history, ctx, REWIND_CHECK_STEP);
+        const Uint64 elapsed = SDL_GetTicksNS() - start;
+        rewind_ns += elapsed;
+        max_rewind_ns = SDL_max(max_rewind_ns, elapsed);
+        ++rewinds;
+        tick -= rewound;
+        if (rewound == 0 || SDL_memcmp(ctx, &states[tick], sizeof(SnakeContext)) != 0)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_TEST, "rewind-check: state mismatch after rewinding to tick %d", tick);
+            goto done;
+        }
+    }
+
+    SDL_Log("rewind-check: %d ticks of history in %.1f KiB (%.1f bytes/tick), %d-tick rewind avg %.2f us max %.2f us",
+            REWIND_CHECK_TICKS, history_bytes / 1024.0, (double)history_bytes / REWIND_CHECK_TICKS,
+            REWIND_CHECK_STEP, rewind_ns / 1e3 / rewinds, max_rewind_ns / 1e3);
+    ok = true;
+
+done:
+    SDL_aligned_free(ctx);
+    SDL_aligned_free(states);
+    SDL_aligned_free(history);
+    return ok ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+}
@@ -0,0 +1,380 @@
+/*
+ * 输入实现
+ * 按键绑定表、手柄到移动方向的映射、手柄热插拔，以及 tick 边界的状态采样
+ */
+
+#include "input.h"
+
+/* 输入方式名称，用于命令行参数 */
+static const char *const input_mode_names[SNAKE_INPUT_MODE_COUNT] = {
+    "events",
+    "sampled"};
+
+/* 十字键按钮对应的方向，下标为 SnakeDirection */
+static const SDL_GamepadButton dpad_buttons[4] = {
+    SDL_GAMEPAD_BUTTON_DPAD_RIGHT,
+    SDL_GAMEPAD_BUTTON_DPAD_UP,
+    SDL_GAMEPAD_BUTTON_DPAD_LEFT,
+    SDL_GAMEPAD_BUTTON_DPAD_DOWN};
+
+/* 动作名称，用于配置文件 */
+static const char *const action_names[SNAKE_ACTION_COUNT] = {
+    "none",
+    "right",
+    "up",
+    "left",
+    "down",
+    "reset",
+    "pause",
+    "faster",
+    "slower",
+    "rewind",
+    "quit"};
+
+/* 每个玩家默认的转向按键，顺序为 SnakeDirection */
+static const SDL_Scancode default_turn_keys[SNAKE_MAX_PLAYERS][4] = {
+    {SDL_SCANCODE_RIGHT, SDL_SCANCODE_UP, SDL_SCANCODE_LEFT, SDL_SCANCODE_DOWN},
+    {SDL_SCANCODE_D, SDL_SCANCODE_W, SDL_SCANCODE_A, SDL_SCANCODE_S},
+    {SDL_SCANCODE_L, SDL_SCANCODE_I, SDL_SCANCODE_J, SDL_SCANCODE_K},
+    {SDL_SCANCODE_KP_6, SDL_SCANCODE_KP_8, SDL_SCANCODE_KP_4, SDL_SCANCODE_KP_5}};
+
+const char *snake_input_mode_name(SnakeInputMode mode)
+{
+    if ((unsigned)mode >= SNAKE_INPUT_MODE_COUNT)
+    {
+        return "unknown";
+    }
+    return input_mode_names[mode];
+}
+
+SnakeInputMode snake_input_mode_from_name(const char *name)
+{
+    int i;
+    for (i = 0; i < SNAKE_INPUT_MODE_COUNT; i++)
+    {
+        if (SDL_strcmp(name, input_mode_names[i]) == 0)
+        {
+            return (SnakeInputMode)i;
+        }
+    }
+    return SNAKE_INPUT_MODE_COUNT;
+}
+
+const char *snake_action_name(SnakeAction action)
+{
+    if ((unsigned)action >= SNAKE_ACTION_COUNT)
+    {
+        return "unknown";
+    }
+    return action_names[action];
+}
+
+void snake_input_init(SnakeInput *input, SnakeInputMode mode)
+{
+    SDL_zerop(input);
+    input->mode = mode;
+    snake_input_bind_defaults(input);
+}
+
+void snake_input_quit(SnakeInput *input)
+{
+    int i;
+    for (i = 0; i < input->gamepad_count; i++)
+    {
+        SDL_CloseGamepad(input->gamepads[i]);
+        input->gamepads[i] = NULL;
+    }
+    input->gamepad_count = 0;
+}
+
+void snake_input_bind_defaults(SnakeInput *input)
+{
+    int player;
+    int dir;
+    SDL_memset(input->bindings, 0, sizeof(input->bindings));
+    for (player = 0; player < SNAKE_MAX_PLAYERS; player++)
+    {
+        for (dir = 0; dir < 4; dir++)
+        {
+            snake_input_bind(input, default_turn_keys[player][dir], (SnakeAction)(SNAKE_ACTION_RIGHT + dir), player);
+        }
+    }
+    snake_input_bind(input, SDL_SCANCODE_R, SNAKE_ACTION_RESET, 0);
+    snake_input_bind(input, SDL_SCANCODE_P, SNAKE_ACTION_PAUSE, 0);
+    snake_input_bind(input, SDL_SCANCODE_EQUALS, SNAKE_ACTION_FASTER, 0);
+    snake_input_bind(input, SDL_SCANCODE_MINUS, SNAKE_ACTION_SLOWER, 0);
+    snake_input_bind(input, SDL_SCANCODE_BACKSPACE, SNAKE_ACTION_REWIND, 0);
+    snake_input_bind(input, SDL_SCANCODE_ESCAPE, SNAKE_ACTION_QUIT, 0);
+    snake_input_bind(input, SDL_SCANCODE_Q, SNAKE_ACTION_QUIT, 0);
+}
+
+void snake_input_bind(SnakeInput *input, SDL_Scancode key_code, SnakeAction action, int player)
+{
+    if ((unsigned)key_code < SDL_SCANCODE_COUNT)
+    {
+        input->bindings[key_code] = action == SNAKE_ACTION_NONE ? 0 : SNAKE_BINDING(action, player);
+    }
+}
+
+bool snake_input_bind_named(SnakeInput *input, const char *key_name, const char *value)
+{
+    const SDL_Scancode key_code = SDL_GetScancodeFromName(key_name);
+    const char *colon = SDL_strchr(value, ':');
+    const size_t name_length = colon ? (size_t)(colon - value) : SDL_strlen(value);
+    int player = 1;
+    int i;
+
+    if (key_code == SDL_SCANCODE_UNKNOWN)
+    {
+        return false;
+    }
+    if (colon)
+    {
+        player = SDL_atoi(colon + 1);
+        if (player < 1 || player > SNAKE_MAX_PLAYERS)
+        {
+            return false;
+        }
+    }
+    for (i = 0; i < SNAKE_ACTION_COUNT; i++)
+    {
+        if (SDL_strlen(action_names[i]) == name_length && SDL_strncmp(value, action_names[i], name_length) == 0)
+        {
+            snake_input_bind(input, key_code, (SnakeAction)i, player - 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+int snake_input_stick_direction(Sint16 x, Sint16 y)
+{
+    const int ax = SDL_abs((int)x);
+    const int ay = SDL_abs((int)y);
+    if (SDL_max(ax, ay) < SNAKE_INPUT_STICK_DEADZONE)
+    {
+        return SNAKE_INPUT_NO_DIRECTION;
+    }
+    if (ax >= ay)
+    {
+        return x > 0 ? SNAKE_DIR_RIGHT : SNAKE_DIR_LEFT;
+    }
+    return y > 0 ? SNAKE_DIR_DOWN : SNAKE_DIR_UP; /* Y 轴向下为正 */
+}
+
+/* 左摇杆当前的方向 */
+static int gamepad_stick_direction_(SDL_Gamepad *gamepad)
+{
+    return snake_input_stick_direction(SDL_GetGamepadAxis(gamepad, SDL_GAMEPAD_AXIS_LEFTX),
+                                       SDL_GetGamepadAxis(gamepad, SDL_GAMEPAD_AXIS_LEFTY));
+}
+
+/* 查找已打开的手柄，找不到时返回 -1 */
+static int find_gamepad_(const SnakeInput *input, SDL_JoystickID id)
+{
+    int i;
+    for (i = 0; i < input->gamepad_count; i++)
+    {
+        if (SDL_GetGamepadID(input->gamepads[i]) == id)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/* 打开新连接的手柄 */
+static void add_gamepad_(SnakeInput *input, SDL_JoystickID id)
+{
+    SDL_Gamepad *gamepad;
+    if (find_gamepad_(input, id) >= 0)
+    {
+        return;
+    }
+    if (input->gamepad_count >= SNAKE_INPUT_MAX_GAMEPADS)
+    {
+        SDL_Log("input: ignoring gamepad %u, %d already open", (unsigned)id, input->gamepad_count);
+        return;
+    }
+    gamepad = SDL_OpenGamepad(id);
+    if (!gamepad)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_INPUT, "input: cannot open gamepad %u: %s", (unsigned)id, SDL_GetError());
+        return;
+    }
+    input->gamepads[input->gamepad_count] = gamepad;
+    input->stick_dir[input->gamepad_count] = SNAKE_INPUT_NO_DIRECTION;
+    ++input->gamepad_count;
+    SDL_Log("input: gamepad connected: %s", SDL_GetGamepadName(gamepad));
+}
+
+/* 关闭已拔出的手柄，用最后一个手柄填补空位 */
+static void remove_gamepad_(SnakeInput *input, SDL_JoystickID id)
+{
+    const int i = find_gamepad_(input, id);
+    if (i < 0)
+    {
+        return;
+    }
+    SDL_CloseGamepad(input->gamepads[i]);
+    --input->gamepad_count;
+    input->gamepads[i] = input->gamepads[input->gamepad_count];
+    input->stick_dir[i] = input->stick_dir[input->gamepad_count];
+    input->gamepads[input->gamepad_count] = NULL;
+    SDL_Log("input: gamepad %u disconnected", (unsigned)id);
+}
+
+void snake_input_queue_turn(SnakeInput *input, int player, SnakeDirection dir)
+{
+    SnakeTurnQueue *queue;
+    if (player < 0 || player >= SNAKE_MAX_PLAYERS)
+    {
+        return;
+    }
+    queue = &input->queues[player];
+    /* 队列已满或与最后一个转向相同时丢弃 */
+    if (queue->count >= SNAKE_INPUT_QUEUE_SIZE ||
+        (queue->count > 0 && queue->dirs[(queue->head + queue->count - 1) % SNAKE_INPUT_QUEUE_SIZE] == dir))
+    {
+        return;
+    }
+    queue->dirs[(queue->head + queue->count) % SNAKE_INPUT_QUEUE_SIZE] = (Uint8)dir;
+    ++queue->count;
+}
+
+/* 手柄对应的玩家：按连接顺序分配，手柄多于玩家时循环分配 */
+static int gamepad_player_(const SnakeContext *ctx, int gamepad)
+{
+    return gamepad % ctx->player_count;
+}
+
+void snake_input_handle_event(SnakeInput *input, const SnakeContext *ctx, const SDL_Event *event)
+{
+    int i;
+    int dir;
+    switch (event->type)
+    {
+    case SDL_EVENT_GAMEPAD_ADDED:
+        add_gamepad_(input, event->gdevice.which);
+        break;
+    case SDL_EVENT_GAMEPAD_REMOVED:
+        remove_gamepad_(input, event->gdevice.which);
+        break;
+    case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
+        i = find_gamepad_(input, event->gbutton.which);
+        if (input->mode != SNAKE_INPUT_EVENTS || i < 0)
+        {
+            break;
+        }
+        for (dir = 0; dir < 4; dir++)
+        {
+            if (event->gbutton.button == dpad_buttons[dir])
+            {
+                snake_input_queue_turn(input, gamepad_player_(ctx, i), (SnakeDirection)dir);
+            }
+        }
+        break;
+    case SDL_EVENT_GAMEPAD_AXIS_MOTION:
+        if (input->mode != SNAKE_INPUT_EVENTS ||
+            (event->gaxis.axis != SDL_GAMEPAD_AXIS_LEFTX && event->gaxis.axis != SDL_GAMEPAD_AXIS_LEFTY))
+        {
+            break;
+        }
+        /* 只在摇杆离开死区或换到另一个方向时转向，避免每个轴事件都重复转向 */
+        i = find_gamepad_(input, event->gaxis.which);
+        if (i < 0)
+        {
+            break;
+        }
+        dir = gamepad_stick_direction_(input->gamepads[i]);
+        if (dir != input->stick_dir[i] && dir != SNAKE_INPUT_NO_DIRECTION)
+        {
+            snake_input_queue_turn(input, gamepad_player_(ctx, i), (SnakeDirection)dir);
+        }
+        input->stick_dir[i] = dir;
+        break;
+    }
+}
+
+/* 事件方式：每个玩家从队列中取出转向，直到方向真正改变或队列为空
+ * 两个 tick 之间连续按下的转向会在之后的 tick 中依次生效，不会互相覆盖
+ */
+static void apply_queued_turns_(SnakeInput *input, SnakeContext *ctx)
+{
+    int player;
+    for (player = 0; player < ctx->player_count; player++)
+    {
+        SnakeTurnQueue *const queue = &input->queues[player];
+        const char before = ctx->players[player].next_dir;
+        while (queue->count > 0 && ctx->players[player].next_dir == before)
+        {
+            snake_player_redir(ctx, player, (SnakeDirection)queue->dirs[queue->head]);
+            queue->head = (Uint8)((queue->head + 1) % SNAKE_INPUT_QUEUE_SIZE);
+            --queue->count;
+        }
+    }
+}
+
+/* 采样方式：读取键盘和手柄的当前状态 */
+static void sample_held_turns_(SnakeInput *input, SnakeContext *ctx)
+{
+    int key_count;
+    const bool *keys = SDL_GetKeyboardState(&key_count);
+    unsigned held[SNAKE_MAX_PLAYERS] = {0}; /* 每个玩家按住的方向（位掩码，位下标为 SnakeDirection） */
+    int player;
+    int i;
+    int dir;
+
+    for (i = 0; i < key_count; i++)
+    {
+        const SnakeBinding binding = input->bindings[i];
+        if (keys[i] && SNAKE_ACTION_IS_TURN(SNAKE_BINDING_ACTION(binding)))
+        {
+            held[SNAKE_BINDING_PLAYER(binding)] |= 1U << SNAKE_ACTION_DIRECTION(SNAKE_BINDING_ACTION(binding));
+        }
+    }
+    for (i = 0; i < input->gamepad_count; i++)
+    {
+        player = gamepad_player_(ctx, i);
+        for (dir = 0; dir < 4; dir++)
+        {
+            if (SDL_GetGamepadButton(input->gamepads[i], dpad_buttons[dir]))
+            {
+                held[player] |= 1U << dir;
+            }
+        }
+        dir = gamepad_stick_direction_(input->gamepads[i]);
+        if (dir != SNAKE_INPUT_NO_DIRECTION)
+        {
+            held[player] |= 1U << dir;
+        }
+    }
+
+    /* 同时按住多个方向时优先转向：跳过当前方向，取第一个允许的方向 */
+    for (player = 0; player < ctx->player_count; player++)
+    {
+        for (dir = 0; dir < 4; dir++)
+        {
+            if ((held[player] & (1U << dir)) && dir != ctx->players[player].next_dir)
+            {
+                snake_player_redir(ctx, player, (SnakeDirection)dir);
+                if (ctx->players[player].next_dir == dir)
+                {
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void snake_input_tick(SnakeInput *input, SnakeContext *ctx)
+{
+    if (input->mode == SNAKE_INPUT_SAMPLED)
+    {
+        sample_held_turns_(input, ctx);
+    }
+    else
+    {
+        apply_queued_turns_(input, ctx);
+    }
+}
@@ -0,0 +1,194 @@
+/*
+ * LZ 压缩实现
+ * 压缩端用 4 字节哈希表查找最近一次出现的位置（单候选、贪心匹配），
+ * 解压端逐字节检查边界，损坏的数据不会越界读写
+ */
+
+#include "lz.h"
+
+#define LZ_MIN_MATCH 4        /* 最短匹配长度 */
+#define LZ_MAX_OFFSET 65535   /* 最大匹配距离 */
+#define LZ_HASH_BITS 12       /* 哈希表大小为 2^12 */
+#define LZ_LAST_LITERALS 5    /* 数据末尾至少保留的字面量字节数 */
+
+static Uint32 read32_(const Uint8 *p)
+{
+    Uint32 v;
+    SDL_memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static Uint32 hash_(Uint32 v)
+{
+    return (v * 2654435761U) >> (32 - LZ_HASH_BITS);
+}
+
+/* 写出长度的扩展字节（长度已减去 15） */
+static Uint8 *write_length_(Uint8 *op, const Uint8 *end, int length)
+{
+    while (length >= 255)
+    {
+        if (op >= end)
+        {
+            return NULL;
+        }
+        *op++ = 255;
+        length -= 255;
+    }
+    if (op >= end)
+    {
+        return NULL;
+    }
+    *op++ = (Uint8)length;
+    return op;
+}
+
+/* 写出一个序列：字面量 [literal, literal + literal_length)，随后是匹配（match_length 为 0 表示最后一个序列） */
+static Uint8 *write_sequence_(Uint8 *op, const Uint8 *end, const Uint8 *literal, int literal_length,
+                              int offset, int match_length)
+{
+    Uint8 *token = op++;
+    const int match_code = match_length ? match_length - LZ_MIN_MATCH : 0;
+
+    if (token >= end)
+    {
+        return NULL;
+    }
+    *token = (Uint8)((SDL_min(literal_length, 15) << 4) | SDL_min(match_code, 15));
+    if (literal_length >= 15 && !(op = write_length_(op, end, literal_length - 15)))
+    {
+        return NULL;
+    }
+    if (end - op < literal_length)
+    {
+        return NULL;
+    }
+    SDL_memcpy(op, literal, literal_length);
+    op += literal_length;
+    if (match_length == 0)
+    {
+        return op;
+    }
+    if (end - op < 2)
+    {
+        return NULL;
+    }
+    *op++ = (Uint8)(offset & 0xFF);
+    *op++ = (Uint8)(offset >> 8);
+    if (match_code >= 15)
+    {
+        return write_length_(op, end, match_code - 15);
+    }
+    return op;
+}
+
+int snake_lz_compress(const Uint8 *src, int size, Uint8 *dst, int capacity)
+{
+    Uint32 table[1 << LZ_HASH_BITS]; /* 位置 + 1，0 表示空 */
+    const Uint8 *end = dst + capacity;
+    const int match_limit = size - LZ_LAST_LITERALS;
+    Uint8 *op = dst;
+    int anchor = 0;
+    int ip = 0;
+
+    SDL_zeroa(table);
+    while (ip + LZ_MIN_MATCH <= match_limit)
+    {
+        const Uint32 sequence = read32_(src + ip);
+        const Uint32 h = hash_(sequence);
+        const int ref = (int)table[h] - 1;
+        int length;
+
+        table[h] = (Uint32)ip + 1;
+        if (ref < 0 || ip - ref > LZ_MAX_OFFSET || read32_(src + ref) != sequence)
+        {
+            ++ip;
+            continue;
+        }
+
+        length = LZ_MIN_MATCH;
+        while (ip + length < match_limit && src[ref + length] == src[ip + length])
+        {
+            ++length;
+        }
+        op = write_sequence_(op, end, src + anchor, ip - anchor, ip - ref, length);
+        if (!op)
+        {
+            return 0;
+        }
+        ip += length;
+        anchor = ip;
+    }
+
+    op = write_sequence_(op, end, src + anchor, size - anchor, 0, 0);
+    return op ? (int)(op - dst) : 0;
+}
+
+/* 读取长度的扩展字节，数据不完整时返回 -1 */
+static int read_length_(const Uint8 **ip, const Uint8 *end, int length)
+{
+    Uint8 b;
+    do
+    {
+        if (*ip >= end)
+        {
+            return -1;
+        }
+        b = *(*ip)++;
+        length += b;
+    } while (b == 255);
+    return length;
+}
+
+int snake_lz_decompress(const Uint8 *src, int size, Uint8 *dst, int capacity)
+{
+    const Uint8 *ip = src;
+    const Uint8 *end = src + size;
+    int op = 0;
+
+    while (ip < end)
+    {
+        const Uint8 token = *ip++;
+        int literal_length = token >> 4;
+        int match_length = (token & 0x0F) + LZ_MIN_MATCH;
+        int offset;
+
+        if (literal_length == 15 && (literal_length = read_length_(&ip, end, literal_length)) < 0)
+        {
+            return -1;
+        }
+        if (end - ip < literal_length || capacity - op < literal_length)
+        {
+            return -1;
+        }
+        SDL_memcpy(dst + op, ip, literal_length);
+        ip += literal_length;
+        op += literal_length;
+        if (ip == end)
+        {
+            break; /* 最后一个序列 */
+        }
+
+        if (end - ip < 2)
+        {
+            return -1;
+        }
+        offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (match_length == 15 + LZ_MIN_MATCH && (match_length = read_length_(&ip, end, match_length)) < 0)
+        {
+            return -1;
+        }
+        if (offset == 0 || offset > op || capacity - op < match_length)
+        {
+            return -1;
+        }
+        /* 匹配可能与输出重叠（offset < match_length），逐字节复制 */
+        while (match_length-- > 0)
+        {
+            dst[op] = dst[op - offset];
+            ++op;
+        }
+    }
+    return op;
+}
@@ -11,293 +11,185 @@
 #define SDL_MAIN_USE_CALLBACKS 1 /* 使用回调方式替代main函数 */
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_main.h>
-
-/* 游戏基本参数设置 */
-#define STEP_RATE_IN_MILLISECONDS 125 /* 游戏更新时间步长（毫秒） */
-#define SNAKE_BLOCK_SIZE_IN_PIXELS 24 /* 蛇身方块大小（像素） */
-#define SDL_WINDOW_WIDTH (SNAKE_BLOCK_SIZE_IN_PIXELS * SNAKE_GAME_WIDTH)
-#define SDL_WINDOW_HEIGHT (SNAKE_BLOCK_SIZE_IN_PIXELS * SNAKE_GAME_HEIGHT)
-
-/* 游戏场地大小设置 */
-#define SNAKE_GAME_WIDTH 24U  /* 游戏场地宽度（格子数） */
-#define SNAKE_GAME_HEIGHT 18U /* 游戏场地高度（格子数） */
-#define SNAKE_MATRIX_SIZE (SNAKE_GAME_WIDTH * SNAKE_GAME_HEIGHT)
-
-/* 位操作相关的常量定义 */
-#define THREE_BITS 0x7U /* 用于位操作的3位掩码，用于提取单元格状态 */
-#define SHIFT(x, y) (((x) + ((y) * SNAKE_GAME_WIDTH)) * SNAKE_CELL_MAX_BITS)
-
-/* 单元格状态枚举
- * 使用3位二进制表示不同的单元格状态
- * 0: 空单元格
- * 1-4: 蛇身体（不同方向）
- * 5: 食物
- */
-typedef enum
-{
-    SNAKE_CELL_NOTHING = 0U, /* 空单元格 */
-    SNAKE_CELL_SRIGHT = 1U,  /* 蛇身体向右 */
-    SNAKE_CELL_SUP = 2U,     /* 蛇身体向上 */
-    SNAKE_CELL_SLEFT = 3U,   /* 蛇身体向左 */
-    SNAKE_CELL_SDOWN = 4U,   /* 蛇身体向下 */
-    SNAKE_CELL_FOOD = 5U     /* 食物 */
-} SnakeCell;
-
-#define SNAKE_CELL_MAX_BITS 3U /* 表示一个单元格状态所需的位数 */
-
-/* 蛇的移动方向枚举 */
-typedef enum
-{
-    SNAKE_DIR_RIGHT, /* 向右移动 */
-    SNAKE_DIR_UP,    /* 向上移动 */
-    SNAKE_DIR_LEFT,  /* 向左移动 */
-    SNAKE_DIR_DOWN   /* 向下移动 */
-} SnakeDirection;
-
-/* 蛇的状态上下文结构
- * 使用位压缩存储游戏场地状态，每个单元格用3位表示
+#include "snake.h"
+#include "render.h"
+#include "headless.h"
+#include "script.h"
+#include "audio.h"
+#include "input.h"
+#include "event_filter.h"
+#include "config.h"
+#include "history.h"
+#include "timing.h"
+#include "thread_policy.h"
+#include "trajectory.h"
+
+#define MIN_STEP_RATE_IN_MILLISECONDS 40  /* 加速的下限 */
+#define MAX_STEP_RATE_IN_MILLISECONDS 500 /* 减速的上限 */
+#define DEFAULT_FRAME_RATE 60             /* 读取不到显示器刷新率时的帧率 */
+
+/* 应用程序状态结构
+ * 按访问频率排列：每帧都读写的计时和开关放在第一条缓存行，游戏状态从缓存行边界开始，
+ * 只在创建、销毁和少数事件中使用的 SDL 句柄放在最后
  */
 typedef struct
 {
-    unsigned char cells[(SNAKE_MATRIX_SIZE * SNAKE_CELL_MAX_BITS) / 8U]; /* 游戏场地状态数组 */
-    char head_xpos;           /* 蛇头X坐标 */
-    char head_ypos;           /* 蛇头Y坐标 */
-    char tail_xpos;           /* 蛇尾X坐标 */
-    char tail_ypos;           /* 蛇尾Y坐标 */
-    char next_dir;            /* 下一步移动方向 */
-    char inhibit_tail_step;   /* 抑制蛇尾移动的计数器（用于实现蛇身增长） */
-    unsigned occupied_cells;   /* 已占用的单元格数量 */
-} SnakeContext;
-
-/* 应用程序状态结构 */
-typedef struct
-{
+    /* 热数据：每帧访问 */
+    Uint64 frame_ns;          /* 关闭垂直同步时的帧间隔（纳秒），0 表示不限帧率 */
+    int vsync;                /* 垂直同步模式（SDL_SetRenderVSync 的参数），非 0 时由呈现控制节奏 */
+    bool paused;              /* 是否暂停 */
+    SnakeRenderStrategy render_strategy; /* 画面渲染策略 */
+    SnakeMixer *mixer;        /* 音效混音器（没有音频设备时为 NULL） */
+    SnakeTrajectoryWriter *trajectory; /* 轨迹数据集写入端（没有 --trajectory 时为 NULL） */
+    SnakeTickClock clock;     /* tick 定时器，周期可以用按键调节 */
+    SnakePresentStats present; /* 呈现间隔和掉帧统计 */
+    SnakeContext snake_ctx;   /* 蛇的游戏状态 */
+    SnakeInput input;         /* 键盘和手柄输入 */
+    SnakeScriptScheduler scripts; /* 协程脚本调度器 */
+    SnakeHistory history;     /* 回退历史 */
+
+    /* 冷数据 */
+    SnakeEventStats event_stats; /* 事件过滤统计 */
+    SnakeThreadPolicy thread_policy; /* 主线程（模拟和渲染）的 CPU 绑定和优先级 */
     SDL_Window *window;      /* SDL窗口对象 */
     SDL_Renderer *renderer;   /* SDL渲染器对象 */
-    SnakeContext snake_ctx;   /* 蛇的游戏状态 */
-    Uint64 last_step;         /* 上一次更新的时间戳 */
 } AppState;
 
-/* 获取指定位置的单元格状态
- * 使用位操作从压缩存储中提取单元格信息
- */
-SnakeCell snake_cell_at(const SnakeContext *ctx, char x, char y)
-{
-    const int shift = SHIFT(x, y);
-    unsigned short range;
-    SDL_memcpy(&range, ctx->cells + (shift / 8), sizeof(range));
-    return (SnakeCell)((range >> (shift % 8)) & THREE_BITS);
-}
-
-/* 设置矩形的屏幕坐标
- * 将游戏坐标转换为屏幕像素坐标
- */
-static void set_rect_xy_(SDL_FRect *r, short x, short y)
-{
-    r->x = (float)(x * SNAKE_BLOCK_SIZE_IN_PIXELS);
-    r->y = (float)(y * SNAKE_BLOCK_SIZE_IN_PIXELS);
-}
-
-/* 设置指定位置的单元格状态
- * 使用位操作更新压缩存储中的单元格信息
- */
-static void put_cell_at_(SnakeContext *ctx, char x, char y, SnakeCell ct)
-{
-    const int shift = SHIFT(x, y);
-    const int adjust = shift % 8;
-    unsigned char *const pos = ctx->cells + (shift / 8);
-    unsigned short range;
-    SDL_memcpy(&range, pos, sizeof(range));
-    range &= ~(THREE_BITS << adjust); /* 清除原有状态 */
-    range |= (ct & THREE_BITS) << adjust; /* 设置新状态 */
-    SDL_memcpy(pos, &range, sizeof(range));
-}
-
-/* 检查游戏场地是否已满 */
-static int are_cells_full_(SnakeContext *ctx)
-{
-    return ctx->occupied_cells == SNAKE_GAME_WIDTH * SNAKE_GAME_HEIGHT;
-}
-
-/* 在空闲位置生成新的食物
- * 使用随机数选择位置，确保不与蛇身重叠
+/* 处理键盘事件
+ * 通过绑定表把扫描码映射为动作（转向写入玩家的队列，由 snake_input_tick 在 tick 边界应用）
  */
-static void new_food_pos_(SnakeContext *ctx)
+static SDL_AppResult handle_key_event_(AppState *as, SDL_Scancode key_code)
 {
-    while (true)
+    const SnakeBinding binding = as->input.bindings[key_code];
+    const SnakeAction action = SNAKE_BINDING_ACTION(binding);
+    switch (action)
     {
-        const char x = (char)SDL_rand(SNAKE_GAME_WIDTH);
-        const char y = (char)SDL_rand(SNAKE_GAME_HEIGHT);
-        if (snake_cell_at(ctx, x, y) == SNAKE_CELL_NOTHING)
+    /* 退出游戏 */
+    case SNAKE_ACTION_QUIT:
+        return SDL_APP_SUCCESS;
+    /* 重新开始游戏 */
+    case SNAKE_ACTION_RESET:
+        snake_initialize(&as->snake_ctx);
+        snake_history_reset(&as->history, &as->snake_ctx);
+        break;
+    /* 暂停和调速 */
+    case SNAKE_ACTION_PAUSE:
+        as->paused = !as->paused;
+        break;
+    case SNAKE_ACTION_FASTER:
+        snake_clock_scale(&as->clock, 4, 5, SDL_MS_TO_NS(MIN_STEP_RATE_IN_MILLISECONDS), SDL_MS_TO_NS(MAX_STEP_RATE_IN_MILLISECONDS));
+        break;
+    case SNAKE_ACTION_SLOWER:
+        snake_clock_scale(&as->clock, 5, 4, SDL_MS_TO_NS(MIN_STEP_RATE_IN_MILLISECONDS), SDL_MS_TO_NS(MAX_STEP_RATE_IN_MILLISECONDS));
+        break;
+    /* 回退并暂停，按 P 从回退后的位置继续 */
+    case SNAKE_ACTION_REWIND:
+        snake_history_rewind(&as->history, &as->snake_ctx, SNAKE_HISTORY_REWIND_TICKS);
+        as->paused = true;
+        break;
+    /* 控制蛇的移动方向 */
+    case SNAKE_ACTION_RIGHT:
+    case SNAKE_ACTION_UP:
+    case SNAKE_ACTION_LEFT:
+    case SNAKE_ACTION_DOWN:
+        if (as->input.mode == SNAKE_INPUT_EVENTS)
         {
-            put_cell_at_(ctx, x, y, SNAKE_CELL_FOOD);
-            break;
+            snake_input_queue_turn(&as->input, SNAKE_BINDING_PLAYER(binding), SNAKE_ACTION_DIRECTION(action));
         }
+        break;
+    default:
+        break;
     }
+    return SDL_APP_CONTINUE;
 }
 
-/* 游戏初始化函数
- * 设置蛇的初始状态和位置，生成初始食物
+/* 配置项处理：
+ *   bind.<按键名> = <动作>[:<玩家>]
+ *   tick_rate = <每秒 tick 数>（可以是小数，范围与加速、减速的上下限相同）
+ *   vsync = on | off | adaptive（默认 off）
+ *   frame_cap = <每秒帧数>（只在关闭垂直同步时生效，0 表示不限帧率，默认为显示器的刷新率）
+ *   thread.cpus = <CPU 列表>，thread.priority = low | normal | high | time_critical（主线程）
  */
-void snake_initialize(SnakeContext *ctx)
+static bool apply_config_(void *userdata, const char *key, const char *value)
 {
-    int i;
-    SDL_zeroa(ctx->cells);
-    /* 设置蛇的初始位置（中心点） */
-    ctx->head_xpos = ctx->tail_xpos = SNAKE_GAME_WIDTH / 2;
-    ctx->head_ypos = ctx->tail_ypos = SNAKE_GAME_HEIGHT / 2;
-    ctx->next_dir = SNAKE_DIR_RIGHT; /* 初始移动方向为右 */
-    ctx->inhibit_tail_step = ctx->occupied_cells = 4;
-    --ctx->occupied_cells;
-    put_cell_at_(ctx, ctx->tail_xpos, ctx->tail_ypos, SNAKE_CELL_SRIGHT);
-    /* 生成初始食物 */
-    for (i = 0; i < 4; i++)
+    AppState *as = (AppState *)userdata;
+    if (SDL_strncmp(key, "bind.", 5) == 0)
     {
-        new_food_pos_(ctx);
-        ++ctx->occupied_cells;
+        return snake_input_bind_named(&as->input, key + 5, value);
     }
-}
-
-/* 改变蛇的移动方向
- * 检查是否允许改变方向（不允许180度转弯）
- */
-void snake_redir(SnakeContext *ctx, SnakeDirection dir)
-{
-    SnakeCell ct = snake_cell_at(ctx, ctx->head_xpos, ctx->head_ypos);
-    /* 检查是否允许改变方向（不允许180度转弯） */
-    if ((dir == SNAKE_DIR_RIGHT && ct != SNAKE_CELL_SLEFT) ||
-        (dir == SNAKE_DIR_UP && ct != SNAKE_CELL_SDOWN) ||
-        (dir == SNAKE_DIR_LEFT && ct != SNAKE_CELL_SRIGHT) ||
-        (dir == SNAKE_DIR_DOWN && ct != SNAKE_CELL_SUP))
+    if (SDL_strncmp(key, "thread.", 7) == 0)
     {
-        ctx->next_dir = dir;
+        return snake_thread_policy_set(&as->thread_policy, key + 7, value);
     }
-}
-
-/* 处理坐标环绕（穿墙）
- * 当坐标超出边界时进行环绕处理
- */
-static void wrap_around_(char *val, char max)
-{
-    if (*val < 0)
+    if (SDL_strcmp(key, "tick_rate") == 0)
     {
-        *val = max - 1;
+        const double hz = SDL_strtod(value, NULL);
+        if (hz < 1000.0 / MAX_STEP_RATE_IN_MILLISECONDS || hz > 1000.0 / MIN_STEP_RATE_IN_MILLISECONDS)
+        {
+            return false;
+        }
+        snake_clock_set_rate(&as->clock, hz);
+        return true;
     }
-    else if (*val > max - 1)
+    if (SDL_strcmp(key, "vsync") == 0)
     {
-        *val = 0;
+        if (SDL_strcmp(value, "on") == 0)
+        {
+            as->vsync = 1;
+        }
+        else if (SDL_strcmp(value, "off") == 0)
+        {
+            as->vsync = SDL_RENDERER_VSYNC_DISABLED;
+        }
+        else if (SDL_strcmp(value, "adaptive") == 0)
+        {
+            as->vsync = SDL_RENDERER_VSYNC_ADAPTIVE;
+        }
+        else
+        {
+            return false;
+        }
+        return true;
     }
+    if (SDL_strcmp(key, "frame_cap") == 0)
+    {
+        const double hz = SDL_strtod(value, NULL);
+        if (hz < 0.0)
+        {
+            return false;
+        }
+        as->frame_ns = hz > 0.0 ? (Uint64)(SDL_NS_PER_SECOND / hz) : 0;
+        return true;
+    }
+    return false;
 }
 
-/* 更新蛇的状态
- * 处理蛇的移动、碰撞检测和食物收集
- */
-void snake_step(SnakeContext *ctx)
+/* 画面节奏模式的名称 */
+static const char *pacing_name_(const AppState *as)
 {
-    const SnakeCell dir_as_cell = (SnakeCell)(ctx->next_dir + 1);
-    SnakeCell ct;
-    char prev_xpos;
-    char prev_ypos;
-    /* 移动蛇尾 */
-    if (--ctx->inhibit_tail_step == 0)
-    {
-        ++ctx->inhibit_tail_step;
-        ct = snake_cell_at(ctx, ctx->tail_xpos, ctx->tail_ypos);
-        put_cell_at_(ctx, ctx->tail_xpos, ctx->tail_ypos, SNAKE_CELL_NOTHING);
-        switch (ct)
-        {
-        case SNAKE_CELL_SRIGHT:
-            ctx->tail_xpos++;
-            break;
-        case SNAKE_CELL_SUP:
-            ctx->tail_ypos--;
-            break;
-        case SNAKE_CELL_SLEFT:
-            ctx->tail_xpos--;
-            break;
-        case SNAKE_CELL_SDOWN:
-            ctx->tail_ypos++;
-            break;
-        default:
-            break;
-        }
-        wrap_around_(&ctx->tail_xpos, SNAKE_GAME_WIDTH);
-        wrap_around_(&ctx->tail_ypos, SNAKE_GAME_HEIGHT);
-    }
-    /* 移动蛇头 */
-    prev_xpos = ctx->head_xpos;
-    prev_ypos = ctx->head_ypos;
-    switch (ctx->next_dir)
-    {
-    case SNAKE_DIR_RIGHT:
-        ++ctx->head_xpos;
-        break;
-    case SNAKE_DIR_UP:
-        --ctx->head_ypos;
-        break;
-    case SNAKE_DIR_LEFT:
-        --ctx->head_xpos;
-        break;
-    case SNAKE_DIR_DOWN:
-        ++ctx->head_ypos;
-        break;
-    }
-    wrap_around_(&ctx->head_xpos, SNAKE_GAME_WIDTH);
-    wrap_around_(&ctx->head_ypos, SNAKE_GAME_HEIGHT);
-    /* 碰撞检测 */
-    ct = snake_cell_at(ctx, ctx->head_xpos, ctx->head_ypos);
-    if (ct != SNAKE_CELL_NOTHING && ct != SNAKE_CELL_FOOD)
+    switch (as->vsync)
     {
-        snake_initialize(ctx); /* 碰到蛇身，游戏重置 */
-        return;
-    }
-    put_cell_at_(ctx, prev_xpos, prev_ypos, dir_as_cell);
-    put_cell_at_(ctx, ctx->head_xpos, ctx->head_ypos, dir_as_cell);
-    if (ct == SNAKE_CELL_FOOD)
-    {
-        if (are_cells_full_(ctx))
-        {
-            snake_initialize(ctx); /* 游戏胜利，重置游戏 */
-            return;
-        }
-        new_food_pos_(ctx);        /* 生成新的食物 */
-        ++ctx->inhibit_tail_step;  /* 延迟蛇尾移动，实现蛇身增长 */
-        ++ctx->occupied_cells;
+    case SDL_RENDERER_VSYNC_DISABLED:
+        return as->frame_ns ? "frame cap" : "uncapped";
+    case SDL_RENDERER_VSYNC_ADAPTIVE:
+        return "adaptive vsync";
+    default:
+        return "vsync";
     }
 }
 
-/* 处理键盘事件
- * 包括游戏控制和蛇的方向控制
+/* 设置画面节奏：开启垂直同步时由 SDL_RenderPresent 等待刷新，
+ * 驱动不支持自适应垂直同步时退回普通垂直同步，都不支持时退回按帧率上限睡眠
  */
-static SDL_AppResult handle_key_event_(SnakeContext *ctx, SDL_Scancode key_code)
+static void apply_pacing_(AppState *as, Uint64 refresh_ns)
 {
-    switch (key_code)
+    if (as->vsync != SDL_RENDERER_VSYNC_DISABLED && !SDL_SetRenderVSync(as->renderer, as->vsync))
     {
-    /* 退出游戏 */
-    case SDL_SCANCODE_ESCAPE:
-    case SDL_SCANCODE_Q:
-        return SDL_APP_SUCCESS;
-    /* 重新开始游戏 */
-    case SDL_SCANCODE_R:
-        snake_initialize(ctx);
-        break;
-    /* 控制蛇的移动方向 */
-    case SDL_SCANCODE_RIGHT:
-        snake_redir(ctx, SNAKE_DIR_RIGHT);
-        break;
-    case SDL_SCANCODE_UP:
-        snake_redir(ctx, SNAKE_DIR_UP);
-        break;
-    case SDL_SCANCODE_LEFT:
-        snake_redir(ctx, SNAKE_DIR_LEFT);
-        break;
-    case SDL_SCANCODE_DOWN:
-        snake_redir(ctx, SNAKE_DIR_DOWN);
-        break;
-    default:
-        break;
+        SDL_Log("VSync mode %d unavailable: %s", as->vsync, SDL_GetError());
+        as->vsync = as->vsync == SDL_RENDERER_VSYNC_ADAPTIVE && SDL_SetRenderVSync(as->renderer, 1) ? 1 : SDL_RENDERER_VSYNC_DISABLED;
     }
-    return SDL_APP_CONTINUE;
+    /* 垂直同步时每次刷新应呈现一次，否则每个帧间隔呈现一次 */
+    snake_present_stats_init(&as->present, as->vsync != SDL_RENDERER_VSYNC_DISABLED ? refresh_ns : as->frame_ns);
 }
 
 /* 游戏主循环更新函数
@@ -307,46 +199,80 @@ SDL_AppResult SDL_AppIterate(void *appstate)
 {
     AppState *as = (AppState *)appstate;
     SnakeContext *ctx = &as->snake_ctx;
-    const Uint64 now = SDL_GetTicks();
-    SDL_FRect r;
-    unsigned i;
-    unsigned j;
-    int ct;
+    const Uint64 now = SDL_GetTicksNS();
+    Uint64 wake;
+    Uint64 after;
+    const char *text;
+    char scores[64];
+    int i;
 
     /* 根据时间步长更新游戏状态 */
-    while ((now - as->last_step) >= STEP_RATE_IN_MILLISECONDS)
+    if (as->paused)
+    {
+        snake_clock_restart(&as->clock, now);
+    }
+    while (snake_clock_tick(&as->clock, now))
     {
+        unsigned char obs[SNAKE_TRAJECTORY_OBS_BYTES];
+        const SnakePlayer prev = ctx->players[0];
+        Uint8 action;
+
+        if (as->trajectory)
+        {
+            SDL_memcpy(obs, ctx->cells, sizeof(obs)); /* 执行 tick 之前的场地 */
+        }
+        snake_script_tick(&as->scripts); /* 在 tick 边界恢复到期的脚本 */
+        snake_input_tick(&as->input, ctx); /* 在 tick 边界应用转向 */
+        /* 玩家1 的动作：这个 tick 实际采用的转向 */
+        action = ctx->players[0].next_dir != prev.next_dir ? (Uint8)ctx->players[0].next_dir : SNAKE_TRAJECTORY_NO_ACTION;
         snake_step(ctx);
-        as->last_step += STEP_RATE_IN_MILLISECONDS;
+        if (as->trajectory)
+        {
+            bool done;
+            const float reward = snake_trajectory_reward(ctx, &prev, &done);
+            snake_trajectory_writer_record(as->trajectory, obs, action, reward, done);
+        }
+        snake_history_record(&as->history, ctx);
+        snake_mixer_play_events(as->mixer, ctx->events); /* 只写入无锁队列，不阻塞 */
     }
 
     /* 渲染游戏画面 */
-    r.w = r.h = SNAKE_BLOCK_SIZE_IN_PIXELS;
-    SDL_SetRenderDrawColor(as->renderer, 0, 0, 0, SDL_ALPHA_OPAQUE); /* 设置背景色为黑色 */
-    SDL_RenderClear(as->renderer);
-
-    /* 遍历并渲染游戏场地 */
-    for (i = 0; i < SNAKE_GAME_WIDTH; i++)
+    snake_render(as->renderer, ctx, as->render_strategy);
+    if (ctx->player_count > 1)
     {
-        for (j = 0; j < SNAKE_GAME_HEIGHT; j++)
-        {
-            ct = snake_cell_at(ctx, i, j);
-            if (ct == SNAKE_CELL_NOTHING)
-                continue;
-            set_rect_xy_(&r, i, j);
-            if (ct == SNAKE_CELL_FOOD)
-                SDL_SetRenderDrawColor(as->renderer, 80, 80, 255, SDL_ALPHA_OPAQUE); /* 食物为蓝色 */
-            else                                                                     /* body */
-                SDL_SetRenderDrawColor(as->renderer, 0, 128, 0, SDL_ALPHA_OPAQUE);   /* 蛇身为绿色 */
-            SDL_RenderFillRect(as->renderer, &r);
+        /* 多人模式下在底部显示各玩家得分 */
+        scores[0] = '\0';
+        for (i = 0; i < ctx->player_count; i++)
+        {
+            SDL_snprintf(scores + SDL_strlen(scores), sizeof(scores) - SDL_strlen(scores), "P%d %u  ", i + 1, ctx->players[i].score);
         }
+        SDL_SetRenderDrawColor(as->renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
+        SDL_RenderDebugText(as->renderer, 8.0f, SDL_WINDOW_HEIGHT - 28.0f, scores);
+    }
+    text = snake_script_text(&as->scripts);
+    if (text)
+    {
+        SDL_SetRenderDrawColor(as->renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
+        SDL_RenderDebugText(as->renderer, 8.0f, 8.0f, text); /* 脚本提示文字 */
+    }
+    if (as->paused)
+    {
+        SDL_SetRenderDrawColor(as->renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
+        SDL_RenderDebugText(as->renderer, 8.0f, SDL_WINDOW_HEIGHT - 16.0f, "Paused");
     }
-
-    /* 渲染蛇头（黄色） */
-    SDL_SetRenderDrawColor(as->renderer, 255, 255, 0, SDL_ALPHA_OPAQUE);
-    set_rect_xy_(&r, ctx->head_xpos, ctx->head_ypos);
-    SDL_RenderFillRect(as->renderer, &r);
     SDL_RenderPresent(as->renderer);
+    after = SDL_GetTicksNS();
+    snake_present_stats_record(&as->present, after);
+
+    /* 垂直同步时呈现已经等到了刷新；否则睡到下一个 tick 或下一帧（以先到者为准），不空转 */
+    if (as->vsync == SDL_RENDERER_VSYNC_DISABLED && as->frame_ns != 0)
+    {
+        wake = SDL_min(snake_clock_due(&as->clock), now + as->frame_ns);
+        if (wake > after)
+        {
+            SDL_DelayPrecise(wake - after);
+        }
+    }
     return SDL_APP_CONTINUE;
 }
 
@@ -367,7 +293,116 @@ static const struct
  */
 SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
 {
+    SnakeRenderStrategy render_strategy = SNAKE_RENDER_PER_CELL;
+    SnakeInputMode input_mode = SNAKE_INPUT_EVENTS;
+    int players = 1;
+    const char *script = NULL;
+    const char *config_path = NULL;
+    const char *trajectory_path = NULL;
+    const SDL_DisplayMode *mode;
+    Uint64 refresh_ns;
     size_t i;
+    int arg;
+
+    /* 解析命令行参数，无窗口模式直接运行并返回结果 */
+    for (arg = 1; arg < argc; arg++)
+    {
+        if (SDL_strcmp(argv[arg], "--render-check") == 0)
+        {
+            return snake_render_check(argc, argv);
+        }
+        else if (SDL_strcmp(argv[arg], "--audio-check") == 0)
+        {
+            return snake_audio_check(argc, argv);
+        }
+        else if (SDL_strcmp(argv[arg], "--seek-check") == 0)
+        {
+            return snake_seek_check(argc, argv);
+        }
+        else if (SDL_strcmp(argv[arg], "--stream-check") == 0)
+        {
+            return snake_stream_check(argc, argv);
+        }
+        else if (SDL_strcmp(argv[arg], "--bisect") == 0 || SDL_strcmp(argv[arg], "--bisect-record") == 0)
+        {
+            return snake_bisect(argc, argv);
+        }
+        else if (SDL_strcmp(argv[arg], "--stress") == 0)
+        {
+            return snake_stress(argc, argv);
+        }
+        else if (SDL_strcmp(argv[arg], "--rewind-check") == 0)
+        {
+            return snake_rewind_check(argc, argv);
+        }
+        else if (SDL_strcmp(argv[arg], "--batch-bench") == 0)
+        {
+            return snake_batch_bench(argc, argv);
+        }
+        else if (SDL_strcmp(argv[arg], "--shard-bench") == 0)
+        {
+            return snake_shard_bench(argc, argv);
+        }
+        else if (SDL_strcmp(argv[arg], "--timing-check") == 0)
+        {
+            return snake_timing_check(argc, argv);
+        }
+        else if (SDL_strcmp(argv[arg], "--trajectory-check") == 0)
+        {
+            return snake_trajectory_check(argc, argv);
+        }
+        else if (SDL_strcmp(argv[arg], "--experience-check") == 0)
+        {
+            return snake_experience_check(argc, argv);
+        }
+        else if (SDL_strcmp(argv[arg], "--crop-check") == 0)
+        {
+            return snake_crop_check(argc, argv);
+        }
+        else if (SDL_strcmp(argv[arg], "--features-check") == 0)
+        {
+            return snake_features_check(argc, argv);
+        }
+        else if (SDL_strcmp(argv[arg], "--trajectory") == 0 && arg + 1 < argc)
+        {
+            trajectory_path = argv[++arg];
+        }
+        else if (SDL_strcmp(argv[arg], "--render") == 0 && arg + 1 < argc)
+        {
+            render_strategy = snake_render_strategy_from_name(argv[++arg]);
+            if (render_strategy == SNAKE_RENDER_STRATEGY_COUNT)
+            {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unknown render strategy '%s'", argv[arg]);
+                return SDL_APP_FAILURE;
+            }
+        }
+        else if (SDL_strcmp(argv[arg], "--input") == 0 && arg + 1 < argc)
+        {
+            input_mode = snake_input_mode_from_name(argv[++arg]);
+            if (input_mode == SNAKE_INPUT_MODE_COUNT)
+            {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Unknown input mode '%s'", argv[arg]);
+                return SDL_APP_FAILURE;
+            }
+        }
+        else if (SDL_strcmp(argv[arg], "--players") == 0 && arg + 1 < argc)
+        {
+            players = SDL_atoi(argv[++arg]);
+            if (players < 1 || players > SNAKE_MAX_PLAYERS)
+            {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Player count must be 1 to %d", SNAKE_MAX_PLAYERS);
+                return SDL_APP_FAILURE;
+            }
+        }
+        else if (SDL_strcmp(argv[arg], "--config") == 0 && arg + 1 < argc)
+        {
+            config_path = argv[++arg];
+        }
+        else if (SDL_strcmp(argv[arg], "--script") == 0 && arg + 1 < argc)
+        {
+            script = argv[++arg];
+        }
+    }
 
     /* 设置应用程序元数据 */
     if (!SDL_SetAppMetadata("Example Snake game", "1.0", "com.example.Snake"))
@@ -384,21 +419,25 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
         }
     }
 
-    /* 初始化SDL视频子系统 */
-    if (!SDL_Init(SDL_INIT_VIDEO))
+    /* 初始化SDL视频和手柄子系统 */
+    if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMEPAD))
     {
         return SDL_APP_FAILURE;
     }
 
     /* 分配应用程序状态内存 */
-    AppState *as = (AppState *)SDL_calloc(1, sizeof(AppState));
+    AppState *as = (AppState *)SDL_aligned_alloc(SNAKE_CACHE_LINE, sizeof(AppState));
     if (!as)
     {
         return SDL_APP_FAILURE;
     }
+    SDL_zerop(as);
 
     *appstate = as;
 
+    /* 在事件进入队列之前丢弃游戏不需要的事件 */
+    snake_event_filter_install(&as->event_stats);
+
     /* 创建窗口和渲染器 */
     if (!SDL_CreateWindowAndRenderer("examples/demo/snake", SDL_WINDOW_WIDTH, SDL_WINDOW_HEIGHT, 0, &as->window, &as->renderer))
     {
@@ -406,9 +445,69 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
     }
 
     /* 初始化游戏状态 */
-    snake_initialize(&as->snake_ctx);
+    as->render_strategy = render_strategy;
+    snake_clock_init(&as->clock, SDL_MS_TO_NS(STEP_RATE_IN_MILLISECONDS), 0);
+    snake_input_init(&as->input, input_mode);
+
+    /* 默认关闭垂直同步，两次 tick 之间按显示器的刷新率渲染和处理事件 */
+    mode = SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(as->window));
+    refresh_ns = SDL_NS_PER_SECOND / DEFAULT_FRAME_RATE;
+    if (mode && mode->refresh_rate > 0.0f)
+    {
+        refresh_ns = (Uint64)(SDL_NS_PER_SECOND / mode->refresh_rate);
+    }
+    as->frame_ns = refresh_ns;
+    as->vsync = SDL_RENDERER_VSYNC_DISABLED;
+    snake_thread_policy_init(&as->thread_policy);
+
+    /* 加载配置文件：默认配置文件不存在时使用默认设置，指定的配置文件必须存在 */
+    if (!snake_config_load(config_path ? config_path : SNAKE_CONFIG_DEFAULT_PATH, apply_config_, as) && config_path)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Cannot load config '%s': %s", config_path, SDL_GetError());
+        return SDL_APP_FAILURE;
+    }
+    apply_pacing_(as, refresh_ns);
+    if (as->thread_policy.cpu_count > 0 || as->thread_policy.set_priority)
+    {
+        snake_thread_policy_apply(&as->thread_policy, -1, "main"); /* 失败时按系统默认继续运行 */
+    }
+    snake_initialize_seeded(&as->snake_ctx, SDL_GetPerformanceCounter());
+    if (players > 1)
+    {
+        snake_set_player_count(&as->snake_ctx, players);
+    }
+    snake_history_reset(&as->history, &as->snake_ctx);
+
+    /* 导出轨迹数据集 */
+    if (trajectory_path)
+    {
+        as->trajectory = snake_trajectory_writer_open(trajectory_path);
+        if (!as->trajectory)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Cannot record trajectory '%s': %s", trajectory_path, SDL_GetError());
+            return SDL_APP_FAILURE;
+        }
+    }
 
-    as->last_step = SDL_GetTicks();
+    /* 启动命令行指定的脚本 */
+    snake_script_init(&as->scripts, &as->snake_ctx);
+    if (script && !snake_script_start_named(&as->scripts, script))
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Cannot start script '%s'", script);
+        return SDL_APP_FAILURE;
+    }
+
+    /* 打开音效，失败时继续无声运行 */
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO))
+    {
+        as->mixer = snake_mixer_open();
+    }
+    if (!as->mixer)
+    {
+        SDL_Log("Audio disabled: %s", SDL_GetError());
+    }
+
+    snake_clock_restart(&as->clock, SDL_GetTicksNS());
 
     return SDL_APP_CONTINUE;
 }
@@ -418,13 +517,24 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
  */
 SDL_AppResult SDL_AppEvent(void *appstate, SDL_Event *event)
 {
-    SnakeContext *ctx = &((AppState *)appstate)->snake_ctx;
+    AppState *as = (AppState *)appstate;
+    SnakeContext *ctx = &as->snake_ctx;
     switch (event->type)
     {
     case SDL_EVENT_QUIT:
         return SDL_APP_SUCCESS;
     case SDL_EVENT_KEY_DOWN:
-        return handle_key_event_(ctx, event->key.scancode);
+        if (event->key.repeat)
+        {
+            break; /* 自动重复通常已被事件过滤器丢弃 */
+        }
+        return handle_key_event_(as, event->key.scancode);
+    case SDL_EVENT_GAMEPAD_ADDED:
+    case SDL_EVENT_GAMEPAD_REMOVED:
+    case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
+    case SDL_EVENT_GAMEPAD_AXIS_MOTION:
+        snake_input_handle_event(&as->input, ctx, event);
+        break;
     }
     return SDL_APP_CONTINUE;
 }
@@ -437,8 +547,34 @@ void SDL_AppQuit(void *appstate, SDL_AppResult result)
     if (appstate != NULL)
     {
         AppState *as = (AppState *)appstate;
+        snake_script_quit(&as->scripts);
+        snake_input_quit(&as->input);
+        snake_event_filter_remove();
+        snake_event_stats_log(&as->event_stats);
+        snake_histogram_log(&as->clock.jitter, "tick jitter");
+        SDL_Log("tick jitter: %.2f%% of ticks within %.1f ms of schedule",
+                100.0 * snake_histogram_fraction_below(&as->clock.jitter, SNAKE_TICK_JITTER_TARGET_NS),
+                SNAKE_TICK_JITTER_TARGET_NS / 1e6);
+        snake_present_stats_log(&as->present, pacing_name_(as));
+        if (as->trajectory)
+        {
+            SnakeTrajectoryWriterStats stats;
+            const bool written = snake_trajectory_writer_close(as->trajectory, &stats);
+            SDL_Log("trajectory: %" SDL_PRIu64 " rows in %u chunks, %.1f MiB%s", stats.rows, stats.chunks,
+                    stats.bytes / (1024.0 * 1024.0), written ? "" : " (write failed)");
+        }
+        if (as->mixer)
+        {
+            SnakeMixerStats stats;
+            snake_mixer_get_stats(as->mixer, &stats);
+            SDL_Log("audio: %u sounds, %u dropped, mixer cpu %.2f us/callback avg, %.2f us max",
+                    stats.sounds_played, snake_mixer_dropped(as->mixer),
+                    stats.callbacks ? stats.busy_ns / 1e3 / stats.callbacks : 0.0,
+                    stats.max_busy_ns / 1e3);
+            snake_mixer_close(as->mixer);
+        }
         SDL_DestroyRenderer(as->renderer);
         SDL_DestroyWindow(as->window);
-        SDL_free(as);
+        SDL_aligned_free(as);
     }
 }
\ No newline at end of file
@@ -0,0 +1,135 @@
+/*
+ * 合法动作掩码和危险特征实现
+ * 每局先建立食物位图（按实体坐标，只有几十项），蛇身位图为行占用位图去掉食物；
+ * 水平射线把蛇头所在行循环右移到蛇头右侧的格子为第 0 位，向右找最低位、向左找最高位；
+ * 竖直和斜向射线逐行取出蛇头上下第 k 行中对应的一位，拼成射线位图后找最低位
+ */
+
+#include "move_features.h"
+
+#define FEATURE_ROW_MASK ((1U << SNAKE_GAME_WIDTH) - 1U)
+#define FEATURE_COLUMN_RAY ((int)SNAKE_GAME_HEIGHT - 1)/* 竖直和斜向射线的长度 */
+
+/* 每个方向的坐标增量（屏幕坐标，y 向下） */
+static const int step_x_[4] = {1, 0, -1, 0};
+static const int step_y_[4] = {0, -1, 0, 1};
+
+/* 最低位为 1 的位序号（v 不为 0） */
+static int lowest_bit_(Uint32 v)
+{
+    return SDL_MostSignificantBitIndex32(v & (~v + 1));
+}
+
+/* 射线位图中最近的一格（第 0 位为第 1 格） */
+static Uint8 nearest_(Uint32 ray)
+{
+    return ray ? (Uint8)(lowest_bit_(ray) + 1) : (Uint8)SNAKE_RAY_NONE;
+}
+
+/* 把一行循环右移，使第 x + 1 列成为第 0 位（去掉绕回到蛇头本身的一位） */
+static Uint32 row_after_(Uint32 row, int x)
+{
+    const int shift = (x + 1) % (int)SNAKE_GAME_WIDTH;
+    const Uint32 rotated = ((row >> shift) | (row << (SNAKE_GAME_WIDTH - shift))) & FEATURE_ROW_MASK;
+    return rotated & (FEATURE_ROW_MASK >> 1);
+}
+
+static void rays_(const Uint32 *rows, int x, int y, Uint8 *rays)
+{
+    const Uint32 row = row_after_(rows[y], x);
+    Uint32 up = 0;
+    Uint32 up_right = 0;
+    Uint32 up_left = 0;
+    Uint32 down = 0;
+    Uint32 down_right = 0;
+    Uint32 down_left = 0;
+    int k;
+
+    /* 水平：向右为最低位，向左为最高位（第 W - 2 位是蛇头左侧的一格） */
+    rays[SNAKE_RAY_RIGHT] = nearest_(row);
+    rays[SNAKE_RAY_LEFT] = row ? (Uint8)(SNAKE_GAME_WIDTH - 1 - SDL_MostSignificantBitIndex32(row)) : (Uint8)SNAKE_RAY_NONE;
+
+    /* 竖直和斜向：第 k 格位于蛇头上下第 k 行 */
+    for (k = 1; k <= FEATURE_COLUMN_RAY; k++)
+    {
+        const Uint32 above = rows[(y - k + (int)SNAKE_GAME_HEIGHT) % (int)SNAKE_GAME_HEIGHT];
+        const Uint32 below = rows[(y + k) % (int)SNAKE_GAME_HEIGHT];
+        const int right = (x + k) % (int)SNAKE_GAME_WIDTH;
+        const int left = (x - k + (int)SNAKE_GAME_WIDTH) % (int)SNAKE_GAME_WIDTH;
+        up |= ((above >> x) & 1U) << (k - 1);
+        up_right |= ((above >> right) & 1U) << (k - 1);
+        up_left |= ((above >> left) & 1U) << (k - 1);
+        down |= ((below >> x) & 1U) << (k - 1);
+        down_right |= ((below >> right) & 1U) << (k - 1);
+        down_left |= ((below >> left) & 1U) << (k - 1);
+    }
+    rays[SNAKE_RAY_UP] = nearest_(up);
+    rays[SNAKE_RAY_UP_RIGHT] = nearest_(up_right);
+    rays[SNAKE_RAY_UP_LEFT] = nearest_(up_left);
+    rays[SNAKE_RAY_DOWN] = nearest_(down);
+    rays[SNAKE_RAY_DOWN_RIGHT] = nearest_(down_right);
+    rays[SNAKE_RAY_DOWN_LEFT] = nearest_(down_left);
+}
+
+/* 合法且安全的转向 */
+static Uint8 mask_(const SnakeContext *ctx, const SnakePlayer *snake, const Uint32 *body)
+{
+    const SnakeCell head = snake_cell_at(ctx, snake->head_xpos, snake->head_ypos);
+    const bool tail_leaves = snake->inhibit_tail_step == 1; /* snake_step 先移动蛇尾 */
+    Uint8 mask = 0;
+    int d;
+
+    for (d = 0; d < 4; d++)
+    {
+        const int x = (snake->head_xpos + step_x_[d] + (int)SNAKE_GAME_WIDTH) % (int)SNAKE_GAME_WIDTH;
+        const int y = (snake->head_ypos + step_y_[d] + (int)SNAKE_GAME_HEIGHT) % (int)SNAKE_GAME_HEIGHT;
+        /* 与 snake_redir 相同：方向不变总是允许，否则蛇头格子不能与新方向相反 */
+        const bool legal = d == snake->next_dir || head != (SnakeCell)(((d + 2) & 3) + 1);
+        const bool blocked = ((body[y] >> x) & 1U) && !(tail_leaves && x == snake->tail_xpos && y == snake->tail_ypos);
+        if (legal && !blocked)
+        {
+            mask |= (Uint8)(1U << d);
+        }
+    }
+    return mask;
+}
+
+void snake_features_batch(const SnakeContext *games, int count, int player, SnakeFeatures *out)
+{
+    int g;
+
+    for (g = 0; g < count; g++)
+    {
+        const SnakeContext *ctx = &games[g];
+        const SnakeEntities *entities = &ctx->entities;
+        const SnakePlayer *snake = &ctx->players[player];
+        Uint8 *body_rays = out->body_rays + (size_t)g * SNAKE_RAY_COUNT;
+        Uint8 *food_rays = out->food_rays + (size_t)g * SNAKE_RAY_COUNT;
+        Uint32 food[SNAKE_GAME_HEIGHT] = {0};
+        Uint32 body[SNAKE_GAME_HEIGHT];
+        int i;
+
+        if (player < 0 || player >= ctx->player_count || !snake->alive)
+        {
+            out->masks[g] = 0;
+            SDL_memset(body_rays, 0, SNAKE_RAY_COUNT);
+            SDL_memset(food_rays, 0, SNAKE_RAY_COUNT);
+            continue;
+        }
+        for (i = 0; i < entities->count[SNAKE_ENTITY_FOOD]; i++)
+        {
+            food[entities->food_y[i]] |= 1U << entities->food_x[i];
+        }
+        for (i = 0; i < entities->count[SNAKE_ENTITY_PICKUP]; i++)
+        {
+            food[entities->pickup_y[i]] |= 1U << entities->pickup_x[i];
+        }
+        for (i = 0; i < (int)SNAKE_GAME_HEIGHT; i++)
+        {
+            body[i] = ctx->occupied_rows[i] & ~food[i];
+        }
+        out->masks[g] = mask_(ctx, snake, body);
+        rays_(body, snake->head_xpos, snake->head_ypos, body_rays);
+        rays_(food, snake->head_xpos, snake->head_ypos, food_rays);
+    }
+}
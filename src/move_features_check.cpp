@@ -0,0 +1,237 @@
+/*
+ * 合法动作掩码和危险特征检查
+ * 批量推进一组随机对局（每四局中有一局为两名玩家），每隔一段 tick 计算特征并与参照比较：
+ *   射线距离与逐格调用 snake_cell_at 沿射线查找的结果一致；
+ *   单人对局的掩码与实际模拟一致：复制游戏、转向并推进一个 tick，合法转向之后没有死亡的方向才能为 1；
+ *   多人对局的掩码与按格子判断的结果一致
+ * 最后比较批量计算和逐格查找的耗时
+ */
+
+#include "headless.h"
+#include "batch.h"
+#include "move_features.h"
+
+#define FEATURES_CHECK_GAMES 4096          /* 默认局数 */
+#define FEATURES_CHECK_ROUNDS 16           /* 比较的轮数 */
+#define FEATURES_CHECK_TICKS_PER_ROUND 29  /* 每轮之间推进的 tick 数 */
+#define FEATURES_CHECK_TIMING_REPEATS 16   /* 计时重复次数 */
+#define FEATURES_CHECK_MULTI_EVERY 4       /* 每几局中有一局为两名玩家 */
+#define FEATURES_CHECK_SEED 0xFEA7
+
+/* 每条射线的坐标增量，与 SnakeRay 的顺序相同 */
+static const int ray_x_[SNAKE_RAY_COUNT] = {1, 1, 0, -1, -1, -1, 0, 1};
+static const int ray_y_[SNAKE_RAY_COUNT] = {0, -1, -1, -1, 0, 1, 1, 1};
+
+static int wrap_(int v, int max)
+{
+    return (v % max + max) % max;
+}
+
+/* 参照：沿射线逐格查找 */
+static void reference_rays_(const SnakeContext *ctx, const SnakePlayer *snake, Uint8 *body, Uint8 *food)
+{
+    int r;
+    int k;
+
+    for (r = 0; r < SNAKE_RAY_COUNT; r++)
+    {
+        const int length = ray_y_[r] == 0 ? (int)SNAKE_GAME_WIDTH - 1 : (int)SNAKE_GAME_HEIGHT - 1;
+        body[r] = food[r] = SNAKE_RAY_NONE;
+        for (k = 1; k <= length; k++)
+        {
+            const SnakeCell cell = snake_cell_at(ctx, (char)wrap_(snake->head_xpos + k * ray_x_[r], SNAKE_GAME_WIDTH),
+                                                 (char)wrap_(snake->head_ypos + k * ray_y_[r], SNAKE_GAME_HEIGHT));
+            if (cell == SNAKE_CELL_FOOD && food[r] == SNAKE_RAY_NONE)
+            {
+                food[r] = (Uint8)k;
+            }
+            else if (cell != SNAKE_CELL_NOTHING && cell != SNAKE_CELL_FOOD && body[r] == SNAKE_RAY_NONE)
+            {
+                body[r] = (Uint8)k;
+            }
+        }
+    }
+}
+
+/* 参照：复制游戏并实际推进一个 tick（单人对局） */
+static Uint8 simulated_mask_(const SnakeContext *ctx, SnakeContext *copy)
+{
+    Uint8 mask = 0;
+    int d;
+
+    for (d = 0; d < 4; d++)
+    {
+        SDL_memcpy(copy, ctx, sizeof(SnakeContext));
+        snake_redir(copy, (SnakeDirection)d);
+        if (copy->players[0].next_dir != d)
+        {
+            continue; /* 180 度转弯 */
+        }
+        snake_step(copy);
+        if (!(copy->events & SNAKE_EVENT_DIED))
+        {
+            mask |= (Uint8)(1U << d);
+        }
+    }
+    return mask;
+}
+
+/* 参照：按格子判断（多人对局），其他蛇的身体都是障碍 */
+static Uint8 cell_mask_(const SnakeContext *ctx, const SnakePlayer *snake)
+{
+    static const int step_x[4] = {1, 0, -1, 0};
+    static const int step_y[4] = {0, -1, 0, 1};
+    const SnakeCell head = snake_cell_at(ctx, snake->head_xpos, snake->head_ypos);
+    Uint8 mask = 0;
+    int d;
+
+    if (!snake->alive)
+    {
+        return 0;
+    }
+    for (d = 0; d < 4; d++)
+    {
+        const int x = wrap_(snake->head_xpos + step_x[d], SNAKE_GAME_WIDTH);
+        const int y = wrap_(snake->head_ypos + step_y[d], SNAKE_GAME_HEIGHT);
+        const SnakeCell cell = snake_cell_at(ctx, (char)x, (char)y);
+        const bool reverse = (d == SNAKE_DIR_RIGHT && head == SNAKE_CELL_SLEFT) || (d == SNAKE_DIR_UP && head == SNAKE_CELL_SDOWN) ||
+                             (d == SNAKE_DIR_LEFT && head == SNAKE_CELL_SRIGHT) || (d == SNAKE_DIR_DOWN && head == SNAKE_CELL_SUP);
+        const bool own_tail = snake->inhibit_tail_step == 1 && x == snake->tail_xpos && y == snake->tail_ypos;
+        if ((d == snake->next_dir || !reverse) && (cell == SNAKE_CELL_NOTHING || cell == SNAKE_CELL_FOOD || own_tail))
+        {
+            mask |= (Uint8)(1U << d);
+        }
+    }
+    return mask;
+}
+
+/* 比较一名玩家的特征，统计有合法转向被蛇身挡住的局数（掩码少于 3 位） */
+static bool compare_(const SnakeContext *games, int count, int player, const SnakeFeatures *features, SnakeContext *copy, int *blocked)
+{
+    int g;
+
+    for (g = 0; g < count; g++)
+    {
+        const SnakeContext *ctx = &games[g];
+        const SnakePlayer *snake = &ctx->players[player];
+        Uint8 body[SNAKE_RAY_COUNT] = {0};
+        Uint8 food[SNAKE_RAY_COUNT] = {0};
+        Uint8 mask = 0;
+
+        if (player < ctx->player_count && snake->alive)
+        {
+            reference_rays_(ctx, snake, body, food);
+            mask = ctx->player_count == 1 ? simulated_mask_(ctx, copy) : cell_mask_(ctx, snake);
+        }
+        if (SDL_memcmp(body, features->body_rays + (size_t)g * SNAKE_RAY_COUNT, SNAKE_RAY_COUNT) != 0 ||
+            SDL_memcmp(food, features->food_rays + (size_t)g * SNAKE_RAY_COUNT, SNAKE_RAY_COUNT) != 0)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_TEST, "features-check: rays of player %d in game %d differ from the reference", player + 1, g);
+            return false;
+        }
+        if (features->masks[g] != mask)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_TEST, "features-check: mask of player %d in game %d is 0x%x, expected 0x%x",
+                         player + 1, g, features->masks[g], mask);
+            return false;
+        }
+        *blocked += player < ctx->player_count && snake->alive && (mask == 0 || SDL_HasExactlyOneBitSet32(mask) ||
+                                                                   SDL_HasExactlyOneBitSet32(mask & (mask - 1)));
+    }
+    return true;
+}
+
+SDL_AppResult snake_features_check(int argc, char *argv[])
+{
+    int count = FEATURES_CHECK_GAMES;
+    SnakeContext *games = NULL;
+    SnakeContext *copy = (SnakeContext *)SDL_aligned_alloc(SNAKE_CACHE_LINE, sizeof(SnakeContext));
+    Uint8 *turns = NULL;
+    Uint8 *buffer = NULL;
+    SnakeFeatures features;
+    Uint64 rng = FEATURES_CHECK_SEED;
+    Uint64 start;
+    Uint64 batch_ns;
+    Uint64 reference_ns;
+    int blocked = 0;
+    int round;
+    int player;
+    int g;
+    int t;
+    bool ok = false;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (SDL_strcmp(argv[i], "--features-games") == 0 && i + 1 < argc)
+        {
+            count = SDL_atoi(argv[++i]);
+        }
+    }
+    count = SDL_max(count, 1);
+    games = snake_batch_alloc(count, FEATURES_CHECK_SEED);
+    turns = (Uint8 *)SDL_malloc((size_t)count);
+    buffer = (Uint8 *)SDL_malloc((size_t)count * (1 + 2 * SNAKE_RAY_COUNT));
+    if (!games || !copy || !turns || !buffer)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "features-check: cannot allocate %d games", count);
+        goto done;
+    }
+    features.masks = buffer;
+    features.body_rays = buffer + count;
+    features.food_rays = features.body_rays + (size_t)count * SNAKE_RAY_COUNT;
+    for (g = 0; g < count; g += FEATURES_CHECK_MULTI_EVERY)
+    {
+        snake_set_player_count(&games[g], 2);
+    }
+
+    /* 与参照比较 */
+    for (round = 0; round < FEATURES_CHECK_ROUNDS; round++)
+    {
+        for (t = 0; t < FEATURES_CHECK_TICKS_PER_ROUND; t++)
+        {
+            snake_batch_random_turns(turns, count, &rng);
+            snake_step_batch(games, turns, count);
+        }
+        for (player = 0; player < 2; player++)
+        {
+            snake_features_batch(games, count, player, &features);
+            if (!compare_(games, count, player, &features, copy, &blocked))
+            {
+                goto done;
+            }
+        }
+    }
+    SDL_Log("features-check: %d games x %d rounds match the reference (%d snakes with a legal move blocked by a body)", count,
+            FEATURES_CHECK_ROUNDS, blocked);
+
+    /* 计时：批量计算和逐格查找 */
+    start = SDL_GetTicksNS();
+    for (t = 0; t < FEATURES_CHECK_TIMING_REPEATS; t++)
+    {
+        snake_features_batch(games, count, 0, &features);
+    }
+    batch_ns = SDL_GetTicksNS() - start;
+    start = SDL_GetTicksNS();
+    for (t = 0; t < FEATURES_CHECK_TIMING_REPEATS; t++)
+    {
+        for (g = 0; g < count; g++)
+        {
+            reference_rays_(&games[g], &games[g].players[0], features.body_rays + (size_t)g * SNAKE_RAY_COUNT,
+                            features.food_rays + (size_t)g * SNAKE_RAY_COUNT);
+            features.masks[g] = cell_mask_(&games[g], &games[g].players[0]);
+        }
+    }
+    reference_ns = SDL_GetTicksNS() - start;
+    SDL_Log("features-check: bitboards %.1f ns per game, per-cell lookups %.1f ns per game (%.2fx)",
+            (double)batch_ns / ((double)count * FEATURES_CHECK_TIMING_REPEATS),
+            (double)reference_ns / ((double)count * FEATURES_CHECK_TIMING_REPEATS), batch_ns ? (double)reference_ns / batch_ns : 0.0);
+    ok = true;
+
+done:
+    SDL_free(buffer);
+    SDL_free(turns);
+    SDL_aligned_free(copy);
+    snake_batch_free(games);
+    return ok ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+}
@@ -0,0 +1,183 @@
+/*
+ * NUMA 拓扑实现（Linux 从 /sys/devices/system/node 读取，用 sched_setaffinity 绑定和 sched_getaffinity 读回）
+ */
+
+#include "numa.h"
+
+#ifdef SDL_PLATFORM_LINUX
+#include <sched.h>
+#endif
+
+#define NUMA_MAX_NODE_ID 256 /* 扫描的节点编号上限（编号可能不连续） */
+
+int snake_numa_parse_cpulist(const char *text, Uint64 *cpus)
+{
+    const char *p = text;
+    int count = 0;
+
+    while (*p)
+    {
+        char *end;
+        long first = SDL_strtol(p, &end, 10);
+        long last = first;
+        long cpu;
+
+        if (end == p)
+        {
+            /* 末尾的换行或空列表 */
+            while (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')
+            {
+                ++p;
+            }
+            return *p ? -1 : count;
+        }
+        p = end;
+        if (*p == '-')
+        {
+            last = SDL_strtol(p + 1, &end, 10);
+            if (end == p + 1 || last < first)
+            {
+                return -1;
+            }
+            p = end;
+        }
+        if (first < 0)
+        {
+            return -1;
+        }
+        for (cpu = first; cpu <= last && cpu < SNAKE_NUMA_MAX_CPUS; cpu++)
+        {
+            if (!(cpus[cpu / 64] & ((Uint64)1 << (cpu % 64))))
+            {
+                cpus[cpu / 64] |= (Uint64)1 << (cpu % 64);
+                ++count;
+            }
+        }
+        if (*p == ',')
+        {
+            ++p;
+        }
+    }
+    return count;
+}
+
+void snake_numa_format_cpulist(const Uint64 *cpus, char *text, size_t size)
+{
+    int cpu = 0;
+
+    text[0] = '\0';
+    while (cpu < SNAKE_NUMA_MAX_CPUS)
+    {
+        int last;
+        if (!(cpus[cpu / 64] & ((Uint64)1 << (cpu % 64))))
+        {
+            ++cpu;
+            continue;
+        }
+        for (last = cpu; last + 1 < SNAKE_NUMA_MAX_CPUS && (cpus[(last + 1) / 64] & ((Uint64)1 << ((last + 1) % 64))); last++)
+        {
+        }
+        SDL_snprintf(text + SDL_strlen(text), size - SDL_strlen(text), last > cpu ? "%s%d-%d" : "%s%d",
+                     text[0] ? "," : "", cpu, last);
+        cpu = last + 1;
+    }
+}
+
+void snake_numa_detect(SnakeNumaTopology *topo)
+{
+    int id;
+
+    SDL_zerop(topo);
+#ifdef SDL_PLATFORM_LINUX
+    for (id = 0; id < NUMA_MAX_NODE_ID && topo->node_count < SNAKE_NUMA_MAX_NODES; id++)
+    {
+        char path[64];
+        char *text;
+        const int node = topo->node_count;
+
+        SDL_snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", id);
+        text = (char *)SDL_LoadFile(path, NULL);
+        if (!text)
+        {
+            continue;
+        }
+        topo->cpu_count[node] = SDL_max(snake_numa_parse_cpulist(text, topo->cpus[node]), 0);
+        SDL_free(text);
+        if (topo->cpu_count[node] > 0)
+        {
+            topo->node_ids[node] = id; /* 只有内存没有 CPU 的节点不参与分片 */
+            ++topo->node_count;
+        }
+        else
+        {
+            SDL_zeroa(topo->cpus[node]);
+        }
+    }
+#else
+    (void)id;
+#endif
+    if (topo->node_count == 0)
+    {
+        SDL_zerop(topo);
+        topo->node_count = 1;
+    }
+}
+
+bool snake_numa_pin_thread(const SnakeNumaTopology *topo, int node)
+{
+    if (node < 0 || node >= topo->node_count || topo->cpu_count[node] == 0)
+    {
+        return SDL_SetError("NUMA node %d has no known CPUs", node);
+    }
+    return snake_numa_pin_cpus(topo->cpus[node]);
+}
+
+bool snake_numa_pin_cpus(const Uint64 *cpus)
+{
+#ifdef SDL_PLATFORM_LINUX
+    cpu_set_t set;
+    int cpu;
+
+    CPU_ZERO(&set);
+    for (cpu = 0; cpu < SNAKE_NUMA_MAX_CPUS && cpu < CPU_SETSIZE; cpu++)
+    {
+        if (cpus[cpu / 64] & ((Uint64)1 << (cpu % 64)))
+        {
+            CPU_SET(cpu, &set);
+        }
+    }
+    if (sched_setaffinity(0, sizeof(set), &set) != 0)
+    {
+        return SDL_SetError("sched_setaffinity failed");
+    }
+    return true;
+#else
+    (void)cpus;
+    return SDL_Unsupported();
+#endif
+}
+
+bool snake_numa_current_cpus(Uint64 *cpus)
+{
+#ifdef SDL_PLATFORM_LINUX
+    cpu_set_t set;
+    int cpu;
+
+    SDL_memset(cpus, 0, SNAKE_NUMA_MAX_CPUS / 8);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0)
+    {
+        return SDL_SetError("sched_getaffinity failed");
+    }
+    for (cpu = 0; cpu < SNAKE_NUMA_MAX_CPUS && cpu < CPU_SETSIZE; cpu++)
+    {
+        if (CPU_ISSET(cpu, &set))
+        {
+            cpus[cpu / 64] |= (Uint64)1 << (cpu % 64);
+        }
+    }
+    return true;
+#else
+    (void)cpus;
+    return SDL_Unsupported();
+#endif
+}
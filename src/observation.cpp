@@ -0,0 +1,185 @@
+/*
+ * 以蛇头为中心的观察实现
+ * 窗口中每个格子相对蛇头的偏移只取决于边长和朝向，每次调用按四个朝向各计算一次偏移表，
+ * 每局只需加上蛇头坐标、绕回并取出格子
+ */
+
+#include "observation.h"
+
+#define CROP_LANES 8 /* AVX2 每次收集的格子数 */
+#define CROP_MAX_CELLS (((SNAKE_CROP_MAX_SIZE * SNAKE_CROP_MAX_SIZE) + CROP_LANES - 1) / CROP_LANES * CROP_LANES)
+
+/* 每个朝向的前方和右侧（屏幕坐标，y 向下） */
+static const Sint32 forward_[4][2] = {{1, 0}, {0, -1}, {-1, 0}, {0, 1}};
+static const Sint32 right_[4][2] = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}};
+
+/* 四个朝向的偏移表，补齐到 CROP_LANES 的倍数（补齐的项为 0，即蛇头本身） */
+typedef struct
+{
+    Sint32 dx[4][CROP_MAX_CELLS];
+    Sint32 dy[4][CROP_MAX_CELLS];
+} CropOffsets;
+
+static bool valid_(int player, int size)
+{
+    if (player < 0 || player >= SNAKE_MAX_PLAYERS)
+    {
+        return SDL_InvalidParamError("player");
+    }
+    if (size < 1 || size > SNAKE_CROP_MAX_SIZE || size % 2 == 0)
+    {
+        return SDL_InvalidParamError("size");
+    }
+    return true;
+}
+
+static void crop_offsets_(CropOffsets *offsets, int size)
+{
+    const int half = size / 2;
+    int heading;
+    int i;
+
+    SDL_zerop(offsets);
+    for (heading = 0; heading < 4; heading++)
+    {
+        for (i = 0; i < size * size; i++)
+        {
+            const int f = half - i / size; /* 向前的格数 */
+            const int s = i % size - half; /* 向右的格数 */
+            offsets->dx[heading][i] = f * forward_[heading][0] + s * right_[heading][0];
+            offsets->dy[heading][i] = f * forward_[heading][1] + s * right_[heading][1];
+        }
+    }
+}
+
+/* 把蛇身格子的方向换算到朝向 heading：朝向变为向上，其他方向随之旋转 */
+static Uint8 rotate_cell_(Uint8 cell, int heading)
+{
+    if (cell >= SNAKE_CELL_SRIGHT && cell <= SNAKE_CELL_SDOWN)
+    {
+        return (Uint8)(((cell - heading) & 3) + SNAKE_CELL_SRIGHT);
+    }
+    return cell;
+}
+
+static void crop_one_(const SnakeContext *ctx, int player, int size, const CropOffsets *offsets, Uint8 *out)
+{
+    const SnakePlayer *snake = &ctx->players[player];
+    const int heading = snake->next_dir & 3;
+    int i;
+
+    for (i = 0; i < size * size; i++)
+    {
+        /* 偏移不超过半个窗口，小于场地宽高，加一次宽高即可绕回 */
+        const int x = (snake->head_xpos + offsets->dx[heading][i] + (int)SNAKE_GAME_WIDTH) % (int)SNAKE_GAME_WIDTH;
+        const int y = (snake->head_ypos + offsets->dy[heading][i] + (int)SNAKE_GAME_HEIGHT) % (int)SNAKE_GAME_HEIGHT;
+        out[i] = rotate_cell_((Uint8)snake_cell_at(ctx, (char)x, (char)y), heading);
+    }
+}
+
+#if defined(SDL_AVX2_INTRINSICS)
+/* 每次 8 个格子：计算坐标并绕回，按位偏移收集包含格子的 4 字节，移位取出 3 位，再换算蛇身方向；
+ * 格子最多位于 cells 的最后一个字节，收集读取的后 3 字节落在 cells 之后的 occupied_rows 中
+ */
+SDL_TARGETING("avx2") static void crop_batch_avx2_(const SnakeContext *games, int count, int player, int size,
+                                                   const CropOffsets *offsets, Uint8 *out)
+{
+    const int cells = size * size;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i width = _mm256_set1_epi32(SNAKE_GAME_WIDTH);
+    const __m256i height = _mm256_set1_epi32(SNAKE_GAME_HEIGHT);
+    const __m256i seven = _mm256_set1_epi32(THREE_BITS);
+    const __m256i three = _mm256_set1_epi32(3);
+    const __m256i body_first = _mm256_set1_epi32(SNAKE_CELL_SRIGHT);
+    const __m256i food = _mm256_set1_epi32(SNAKE_CELL_FOOD);
+    /* 每个 32 位通道的最低字节移到每 128 位的前 4 字节 */
+    const __m256i pick = _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                          0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    int g;
+    int i;
+
+    for (g = 0; g < count; g++, out += cells)
+    {
+        const SnakePlayer *snake = &games[g].players[player];
+        const int heading = snake->next_dir & 3;
+        const __m256i head_x = _mm256_set1_epi32(snake->head_xpos);
+        const __m256i head_y = _mm256_set1_epi32(snake->head_ypos);
+        const __m256i dir = _mm256_set1_epi32(heading);
+        const int *base = (const int *)games[g].cells;
+
+        for (i = 0; i < cells; i += CROP_LANES)
+        {
+            __m256i x = _mm256_add_epi32(head_x, _mm256_loadu_si256((const __m256i *)&offsets->dx[heading][i]));
+            __m256i y = _mm256_add_epi32(head_y, _mm256_loadu_si256((const __m256i *)&offsets->dy[heading][i]));
+            __m256i bit;
+            __m256i cell;
+            __m256i rotated;
+            __m256i body;
+            __m256i packed;
+            Uint32 low;
+            Uint32 high;
+            Uint8 lanes[CROP_LANES];
+
+            x = _mm256_add_epi32(x, _mm256_and_si256(_mm256_cmpgt_epi32(zero, x), width));
+            x = _mm256_sub_epi32(x, _mm256_andnot_si256(_mm256_cmpgt_epi32(width, x), width));
+            y = _mm256_add_epi32(y, _mm256_and_si256(_mm256_cmpgt_epi32(zero, y), height));
+            y = _mm256_sub_epi32(y, _mm256_andnot_si256(_mm256_cmpgt_epi32(height, y), height));
+
+            /* 位偏移 = (x + y * 宽) * 3 */
+            bit = _mm256_add_epi32(x, _mm256_mullo_epi32(y, width));
+            bit = _mm256_add_epi32(bit, _mm256_slli_epi32(bit, 1));
+            cell = _mm256_i32gather_epi32(base, _mm256_srli_epi32(bit, 3), 1);
+            cell = _mm256_and_si256(_mm256_srlv_epi32(cell, _mm256_and_si256(bit, seven)), seven);
+
+            /* 蛇身（1 到 4）：((cell - heading) & 3) + 1 */
+            body = _mm256_and_si256(_mm256_cmpgt_epi32(cell, zero), _mm256_cmpgt_epi32(food, cell));
+            rotated = _mm256_add_epi32(_mm256_and_si256(_mm256_sub_epi32(cell, dir), three), body_first);
+            cell = _mm256_blendv_epi8(cell, rotated, body);
+
+            packed = _mm256_shuffle_epi8(cell, pick);
+            low = (Uint32)_mm_cvtsi128_si32(_mm256_castsi256_si128(packed));
+            high = (Uint32)_mm_cvtsi128_si32(_mm256_extracti128_si256(packed, 1));
+            SDL_memcpy(lanes, &low, sizeof(low));
+            SDL_memcpy(lanes + 4, &high, sizeof(high));
+            SDL_memcpy(out + i, lanes, SDL_min(CROP_LANES, cells - i));
+        }
+    }
+}
+#endif
+
+bool snake_crop(const SnakeContext *ctx, int player, int size, Uint8 *out)
+{
+    CropOffsets offsets;
+
+    if (!valid_(player, size))
+    {
+        return false;
+    }
+    crop_offsets_(&offsets, size);
+    crop_one_(ctx, player, size, &offsets, out);
+    return true;
+}
+
+bool snake_crop_batch(const SnakeContext *games, int count, int player, int size, Uint8 *out)
+{
+    CropOffsets offsets;
+    int g;
+
+    if (!valid_(player, size))
+    {
+        return false;
+    }
+    crop_offsets_(&offsets, size);
+#if defined(SDL_AVX2_INTRINSICS)
+    if (SDL_HasAVX2())
+    {
+        crop_batch_avx2_(games, count, player, size, &offsets, out);
+        return true;
+    }
+#endif
+    for (g = 0; g < count; g++)
+    {
+        crop_one_(&games[g], player, size, &offsets, out + (size_t)g * size * size);
+    }
+    return true;
+}
@@ -0,0 +1,209 @@
+/*
+ * 以蛇头为中心的观察检查
+ * 批量推进一组随机对局，每隔一段 tick 对所有局取出各种边长的窗口，
+ * 与按朝向逐格计算的参照实现比较（包括跨越场地边界绕回的窗口），并比较批量和逐局取出的耗时
+ */
+
+#include "headless.h"
+#include "batch.h"
+#include "observation.h"
+
+#define CROP_CHECK_GAMES 4096         /* 默认局数 */
+#define CROP_CHECK_SIZE 11            /* 计时使用的默认边长 */
+#define CROP_CHECK_ROUNDS 8           /* 比较的轮数 */
+#define CROP_CHECK_TICKS_PER_ROUND 37 /* 每轮之间推进的 tick 数 */
+#define CROP_CHECK_TIMING_REPEATS 16  /* 计时重复次数 */
+#define CROP_CHECK_SEED 0xC809
+
+/* 参照实现：按朝向直接写出窗口第 (row, col) 格对应的场地坐标 */
+static Uint8 reference_cell_(const SnakeContext *ctx, const SnakePlayer *snake, int size, int row, int col)
+{
+    /* 朝向为向上时，蛇身方向的换算表 */
+    static const Uint8 rotated_[4][SNAKE_CELL_FOOD + 1] = {
+        {0, 2, 3, 4, 1, 5}, /* 向右：右→上、上→左、左→下、下→右 */
+        {0, 1, 2, 3, 4, 5}, /* 向上：不变 */
+        {0, 4, 1, 2, 3, 5}, /* 向左：右→下、上→右、左→上、下→左 */
+        {0, 3, 4, 1, 2, 5}, /* 向下：右→左、上→下、左→右、下→上 */
+    };
+    const int half = size / 2;
+    const int ahead = half - row;
+    const int side = col - half;
+    int x = snake->head_xpos;
+    int y = snake->head_ypos;
+
+    switch (snake->next_dir)
+    {
+    case SNAKE_DIR_RIGHT:
+        x += ahead;
+        y += side;
+        break;
+    case SNAKE_DIR_UP:
+        x += side;
+        y -= ahead;
+        break;
+    case SNAKE_DIR_LEFT:
+        x -= ahead;
+        y -= side;
+        break;
+    default:
+        x -= side;
+        y += ahead;
+        break;
+    }
+    x = ((x % (int)SNAKE_GAME_WIDTH) + (int)SNAKE_GAME_WIDTH) % (int)SNAKE_GAME_WIDTH;
+    y = ((y % (int)SNAKE_GAME_HEIGHT) + (int)SNAKE_GAME_HEIGHT) % (int)SNAKE_GAME_HEIGHT;
+    return rotated_[snake->next_dir & 3][snake_cell_at(ctx, (char)x, (char)y)];
+}
+
+/* 对所有局比较一种边长的批量结果和参照，统计跨越边界的窗口数 */
+static bool compare_(const SnakeContext *games, int count, int size, const Uint8 *crops, int *wrapped)
+{
+    const int half = size / 2;
+    int g;
+    int row;
+    int col;
+
+    for (g = 0; g < count; g++)
+    {
+        const SnakePlayer *snake = &games[g].players[0];
+        const Uint8 *crop = crops + (size_t)g * size * size;
+        for (row = 0; row < size; row++)
+        {
+            for (col = 0; col < size; col++)
+            {
+                const Uint8 expected = reference_cell_(&games[g], snake, size, row, col);
+                if (crop[row * size + col] != expected)
+                {
+                    SDL_LogError(SDL_LOG_CATEGORY_TEST, "crop-check: game %d, size %d, cell (%d, %d) is %u, expected %u (head %d,%d dir %d)",
+                                 g, size, row, col, crop[row * size + col], expected, snake->head_xpos, snake->head_ypos, snake->next_dir);
+                    return false;
+                }
+            }
+        }
+        /* 蛇头在中心，朝向换算后总是向上 */
+        if (crop[half * size + half] != SNAKE_CELL_SUP)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_TEST, "crop-check: game %d, size %d, head cell is %u", g, size, crop[half * size + half]);
+            return false;
+        }
+        *wrapped += snake->head_xpos < half || snake->head_xpos >= (int)SNAKE_GAME_WIDTH - half ||
+                    snake->head_ypos < half || snake->head_ypos >= (int)SNAKE_GAME_HEIGHT - half;
+    }
+    return true;
+}
+
+SDL_AppResult snake_crop_check(int argc, char *argv[])
+{
+    int count = CROP_CHECK_GAMES;
+    int timing_size = CROP_CHECK_SIZE;
+    SnakeContext *games = NULL;
+    Uint8 *turns = NULL;
+    Uint8 *crops = NULL;
+    Uint8 *single = NULL;
+    Uint64 rng = CROP_CHECK_SEED;
+    Uint64 start;
+    Uint64 batch_ns;
+    Uint64 single_ns;
+    int wrapped = 0;
+    int compared = 0;
+    int round;
+    int size;
+    int g;
+    int t;
+    bool ok = false;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (SDL_strcmp(argv[i], "--crop-games") == 0 && i + 1 < argc)
+        {
+            count = SDL_atoi(argv[++i]);
+        }
+        else if (SDL_strcmp(argv[i], "--crop-size") == 0 && i + 1 < argc)
+        {
+            timing_size = SDL_atoi(argv[++i]);
+        }
+    }
+    count = SDL_max(count, 1);
+    if (timing_size < 1 || timing_size > SNAKE_CROP_MAX_SIZE || timing_size % 2 == 0)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "crop-check: size must be odd and at most %d", SNAKE_CROP_MAX_SIZE);
+        return SDL_APP_FAILURE;
+    }
+    games = snake_batch_alloc(count, CROP_CHECK_SEED);
+    turns = (Uint8 *)SDL_malloc((size_t)count);
+    crops = (Uint8 *)SDL_malloc((size_t)count * SNAKE_CROP_MAX_SIZE * SNAKE_CROP_MAX_SIZE);
+    single = (Uint8 *)SDL_malloc((size_t)count * SNAKE_CROP_MAX_SIZE * SNAKE_CROP_MAX_SIZE);
+    if (!games || !turns || !crops || !single)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "crop-check: cannot allocate %d games", count);
+        goto done;
+    }
+
+    /* 与参照比较 */
+    for (round = 0; round < CROP_CHECK_ROUNDS; round++)
+    {
+        for (t = 0; t < CROP_CHECK_TICKS_PER_ROUND; t++)
+        {
+            snake_batch_random_turns(turns, count, &rng);
+            snake_step_batch(games, turns, count);
+        }
+        for (size = 1; size <= SNAKE_CROP_MAX_SIZE; size += 2)
+        {
+            if (!snake_crop_batch(games, count, 0, size, crops) || !compare_(games, count, size, crops, &wrapped))
+            {
+                goto done;
+            }
+            compared++;
+        }
+    }
+    SDL_Log("crop-check: %d games, %d crops per game (%d rounds of every odd size) match the reference, %d crops wrap around an edge",
+            count, compared, CROP_CHECK_ROUNDS, wrapped);
+    if (!snake_crop_batch(games, count, 0, 2, crops) && !snake_crop(games, 0, SNAKE_CROP_MAX_SIZE + 2, single))
+    {
+        SDL_Log("crop-check: even and oversized windows are rejected");
+    }
+    else
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "crop-check: invalid sizes are accepted");
+        goto done;
+    }
+
+    /* 计时：批量取出和逐局调用 snake_crop */
+    start = SDL_GetTicksNS();
+    for (t = 0; t < CROP_CHECK_TIMING_REPEATS; t++)
+    {
+        snake_crop_batch(games, count, 0, timing_size, crops);
+    }
+    batch_ns = SDL_GetTicksNS() - start;
+    start = SDL_GetTicksNS();
+    for (t = 0; t < CROP_CHECK_TIMING_REPEATS; t++)
+    {
+        for (g = 0; g < count; g++)
+        {
+            snake_crop(&games[g], 0, timing_size, single + (size_t)g * timing_size * timing_size);
+        }
+    }
+    single_ns = SDL_GetTicksNS() - start;
+    if (SDL_memcmp(crops, single, (size_t)count * timing_size * timing_size) != 0)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "crop-check: batched and per-game crops differ");
+        goto done;
+    }
+    SDL_Log("crop-check: %dx%d crops: batched %.1f ns per game%s, per game %.1f ns (%.2fx)", timing_size, timing_size,
+            (double)batch_ns / ((double)count * CROP_CHECK_TIMING_REPEATS),
+#if defined(SDL_AVX2_INTRINSICS)
+            SDL_HasAVX2() ? " (AVX2 gather)" : "",
+#else
+            "",
+#endif
+            (double)single_ns / ((double)count * CROP_CHECK_TIMING_REPEATS), batch_ns ? (double)single_ns / batch_ns : 0.0);
+    ok = true;
+
+done:
+    SDL_free(single);
+    SDL_free(crops);
+    SDL_free(turns);
+    snake_batch_free(games);
+    return ok ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+}
@@ -0,0 +1,228 @@
+/*
+ * 游戏画面渲染实现
+ * 蛇身：按玩家着色（玩家1为绿色），蛇头：黄色，食物：蓝色，拾取物：橙色，特效：白色，背景：黑色
+ * 蛇身格子的玩家通过所有权表查得，不需要逐条蛇遍历蛇身
+ */
+
+#include "render.h"
+#include "entity.h"
+
+/* 渲染策略名称表，顺序与 SnakeRenderStrategy 一致 */
+static const char *const render_strategy_names[SNAKE_RENDER_STRATEGY_COUNT] = {
+    "percell",
+    "batched"};
+
+const char *snake_render_strategy_name(SnakeRenderStrategy strategy)
+{
+    if ((unsigned)strategy >= SNAKE_RENDER_STRATEGY_COUNT)
+    {
+        return "unknown";
+    }
+    return render_strategy_names[strategy];
+}
+
+SnakeRenderStrategy snake_render_strategy_from_name(const char *name)
+{
+    int i;
+    for (i = 0; i < SNAKE_RENDER_STRATEGY_COUNT; i++)
+    {
+        if (SDL_strcmp(name, render_strategy_names[i]) == 0)
+        {
+            return (SnakeRenderStrategy)i;
+        }
+    }
+    return SNAKE_RENDER_STRATEGY_COUNT;
+}
+
+/* 各玩家的蛇身颜色 */
+static const SDL_Color player_colors[SNAKE_MAX_PLAYERS] = {
+    {0, 128, 0, SDL_ALPHA_OPAQUE},   /* 绿色 */
+    {200, 40, 40, SDL_ALPHA_OPAQUE}, /* 红色 */
+    {150, 60, 210, SDL_ALPHA_OPAQUE}, /* 紫色 */
+    {0, 170, 170, SDL_ALPHA_OPAQUE}}; /* 青色 */
+
+/* 设置矩形的屏幕坐标
+ * 将游戏坐标转换为屏幕像素坐标
+ */
+static void set_rect_xy_(SDL_FRect *r, short x, short y)
+{
+    r->x = (float)(x * SNAKE_BLOCK_SIZE_IN_PIXELS);
+    r->y = (float)(y * SNAKE_BLOCK_SIZE_IN_PIXELS);
+}
+
+/* 逐格渲染（参考实现）
+ * 每个非空格子单独设置颜色并调用一次 SDL_RenderFillRect
+ */
+static void render_per_cell_(SDL_Renderer *renderer, const SnakeContext *ctx)
+{
+    SDL_FRect r;
+    unsigned i;
+    unsigned j;
+    int ct;
+
+    r.w = r.h = SNAKE_BLOCK_SIZE_IN_PIXELS;
+
+    /* 遍历并渲染游戏场地 */
+    for (i = 0; i < SNAKE_GAME_WIDTH; i++)
+    {
+        for (j = 0; j < SNAKE_GAME_HEIGHT; j++)
+        {
+            ct = snake_cell_at(ctx, i, j);
+            if (ct == SNAKE_CELL_NOTHING)
+                continue;
+            set_rect_xy_(&r, i, j);
+            if (ct == SNAKE_CELL_FOOD)
+            {
+                const SnakeEntity item = snake_entity_at(&ctx->entities, i, j);
+                if (snake_entity_kind(&ctx->entities, item) == SNAKE_ENTITY_PICKUP)
+                    SDL_SetRenderDrawColor(renderer, 255, 160, 0, SDL_ALPHA_OPAQUE); /* 拾取物为橙色 */
+                else
+                    SDL_SetRenderDrawColor(renderer, 80, 80, 255, SDL_ALPHA_OPAQUE); /* 食物为蓝色 */
+            }
+            else                                                                     /* body */
+            {
+                const SDL_Color *c = &player_colors[ctx->owner[i + j * SNAKE_GAME_WIDTH]];
+                SDL_SetRenderDrawColor(renderer, c->r, c->g, c->b, c->a);           /* 蛇身为玩家颜色 */
+            }
+            SDL_RenderFillRect(renderer, &r);
+        }
+    }
+}
+
+/* 由实体组件数组生成矩形 */
+static int item_rects_(SDL_FRect *rects, const Uint8 *xs, const Uint8 *ys, int count)
+{
+    int i;
+    for (i = 0; i < count; i++)
+    {
+        set_rect_xy_(&rects[i], xs[i], ys[i]);
+        rects[i].w = rects[i].h = SNAKE_BLOCK_SIZE_IN_PIXELS;
+    }
+    return count;
+}
+
+/* 分组批量渲染
+ * 蛇身在一次场地扫描中按所有权表分到各玩家的数组，食物和拾取物直接取自实体的稠密数组，
+ * 每种颜色提交一次 SDL_RenderFillRects；
+ * 这些格子互不重叠，因此提交顺序不影响最终像素
+ */
+static void render_batched_(SDL_Renderer *renderer, const SnakeContext *ctx)
+{
+    const SnakeEntities *e = &ctx->entities;
+    SDL_FRect items[SNAKE_MAX_FOODS + SNAKE_MAX_PICKUPS];
+    SDL_FRect body[SNAKE_MAX_PLAYERS][SNAKE_MATRIX_SIZE];
+    int body_count[SNAKE_MAX_PLAYERS] = {0};
+    int food_count;
+    int pickup_count;
+    unsigned i;
+    unsigned j;
+    int ct;
+
+    for (i = 0; i < SNAKE_GAME_WIDTH; i++)
+    {
+        for (j = 0; j < SNAKE_GAME_HEIGHT; j++)
+        {
+            ct = snake_cell_at(ctx, i, j);
+            if (ct == SNAKE_CELL_NOTHING || ct == SNAKE_CELL_FOOD)
+                continue;
+            const int owner = ctx->owner[i + j * SNAKE_GAME_WIDTH];
+            SDL_FRect *const rect = &body[owner][body_count[owner]++];
+            set_rect_xy_(rect, i, j);
+            rect->w = rect->h = SNAKE_BLOCK_SIZE_IN_PIXELS;
+        }
+    }
+    food_count = item_rects_(items, e->food_x, e->food_y, e->count[SNAKE_ENTITY_FOOD]);
+    pickup_count = item_rects_(items + food_count, e->pickup_x, e->pickup_y, e->count[SNAKE_ENTITY_PICKUP]);
+
+    if (food_count > 0)
+    {
+        SDL_SetRenderDrawColor(renderer, 80, 80, 255, SDL_ALPHA_OPAQUE); /* 食物为蓝色 */
+        SDL_RenderFillRects(renderer, items, food_count);
+    }
+    if (pickup_count > 0)
+    {
+        SDL_SetRenderDrawColor(renderer, 255, 160, 0, SDL_ALPHA_OPAQUE); /* 拾取物为橙色 */
+        SDL_RenderFillRects(renderer, items + food_count, pickup_count);
+    }
+    for (i = 0; i < SNAKE_MAX_PLAYERS; i++)
+    {
+        if (body_count[i] > 0)
+        {
+            const SDL_Color *c = &player_colors[i];
+            SDL_SetRenderDrawColor(renderer, c->r, c->g, c->b, c->a); /* 蛇身为玩家颜色 */
+            SDL_RenderFillRects(renderer, body[i], body_count[i]);
+        }
+    }
+}
+
+/* 计算特效矩形：以格子中心为中心的白色方块，随剩余时间缩小 */
+static void effect_rect_(SDL_FRect *r, const SnakeEntities *e, int index)
+{
+    const float half = (float)(e->effect_ticks_left[index] * 2);
+    r->x = (float)(e->effect_x[index] * SNAKE_BLOCK_SIZE_IN_PIXELS + SNAKE_BLOCK_SIZE_IN_PIXELS / 2) - half;
+    r->y = (float)(e->effect_y[index] * SNAKE_BLOCK_SIZE_IN_PIXELS + SNAKE_BLOCK_SIZE_IN_PIXELS / 2) - half;
+    r->w = r->h = half * 2.0f;
+}
+
+/* 渲染特效（绘制在蛇头之上） */
+static void render_effects_(SDL_Renderer *renderer, const SnakeContext *ctx, SnakeRenderStrategy strategy)
+{
+    const SnakeEntities *e = &ctx->entities;
+    const int count = e->count[SNAKE_ENTITY_EFFECT];
+    SDL_FRect rects[SNAKE_MAX_EFFECTS];
+    int i;
+
+    if (count == 0)
+    {
+        return;
+    }
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, SDL_ALPHA_OPAQUE);
+    for (i = 0; i < count; i++)
+    {
+        effect_rect_(&rects[i], e, i);
+        if (strategy == SNAKE_RENDER_PER_CELL)
+        {
+            SDL_RenderFillRect(renderer, &rects[i]);
+        }
+    }
+    if (strategy != SNAKE_RENDER_PER_CELL)
+    {
+        SDL_RenderFillRects(renderer, rects, count);
+    }
+}
+
+bool snake_render(SDL_Renderer *renderer, const SnakeContext *ctx, SnakeRenderStrategy strategy)
+{
+    SDL_FRect r;
+    int i;
+
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE); /* 设置背景色为黑色 */
+    SDL_RenderClear(renderer);
+
+    switch (strategy)
+    {
+    case SNAKE_RENDER_PER_CELL:
+        render_per_cell_(renderer, ctx);
+        break;
+    case SNAKE_RENDER_BATCHED:
+        render_batched_(renderer, ctx);
+        break;
+    default:
+        return SDL_SetError("Unknown render strategy %d", (int)strategy);
+    }
+
+    /* 渲染蛇头（黄色） */
+    r.w = r.h = SNAKE_BLOCK_SIZE_IN_PIXELS;
+    SDL_SetRenderDrawColor(renderer, 255, 255, 0, SDL_ALPHA_OPAQUE);
+    for (i = 0; i < ctx->player_count; i++)
+    {
+        if (ctx->players[i].alive)
+        {
+            set_rect_xy_(&r, ctx->players[i].head_xpos, ctx->players[i].head_ypos);
+            SDL_RenderFillRect(renderer, &r);
+        }
+    }
+
+    render_effects_(renderer, ctx, strategy);
+    return true;
+}
@@ -0,0 +1,474 @@
+/*
+ * 渲染回归检查
+ * 用软件渲染器在内存表面上回放脚本化对局（含一局多人对局），逐帧计算像素哈希：
+ * 1. 每种渲染策略的哈希必须与逐格 SDL_RenderFillRect 参考实现一致
+ * 2. 参考实现的哈希必须与黄金哈希文件一致（文件用 --update-golden 在真实的 SDL3 软件渲染器上生成）；
+ *    默认路径下没有黄金哈希文件时只做第 1 项，用 --golden 明确指定的文件不存在时失败
+ */
+
+#include "headless.h"
+#include "render.h"
+#include "replay.h"
+
+#define RENDER_CHECK_DEFAULT_GOLDEN "test/golden/render_hashes.txt"
+#define RENDER_CHECK_MAX_FRAMES 4096 /* 所有回放的帧数上限（含初始帧） */
+#define SWEEP_ROWS 40                /* 扫场回放经过的行数（超过场地高度，会穿墙回到顶部） */
+#define COLLIDE_SWEEP_ROWS 12        /* 撞击回放在绕圈前扫过的行数 */
+#define MELEE_NAME "melee"
+#define MELEE_SEED 5
+#define MELEE_PLAYERS 3
+#define MELEE_TICKS 60
+
+/* 直线前进：穿墙和随机吃到食物 */
+static const SnakeReplayInput straight_inputs[] = {{0, SNAKE_DIR_RIGHT}};
+
+/* 之字形转弯 */
+static const SnakeReplayInput zigzag_inputs[] = {
+    {6, SNAKE_DIR_DOWN}, {9, SNAKE_DIR_RIGHT}, {15, SNAKE_DIR_UP}, {18, SNAKE_DIR_RIGHT},
+    {24, SNAKE_DIR_DOWN}, {27, SNAKE_DIR_LEFT}, {40, SNAKE_DIR_UP}, {44, SNAKE_DIR_LEFT},
+    {50, SNAKE_DIR_DOWN}, {62, SNAKE_DIR_RIGHT}, {70, SNAKE_DIR_UP}, {71, SNAKE_DIR_LEFT},
+    {90, SNAKE_DIR_DOWN}, {91, SNAKE_DIR_RIGHT}, {120, SNAKE_DIR_UP}, {135, SNAKE_DIR_LEFT}};
+
+/* 逐行扫场：尽量吃到食物，让蛇身变长 */
+static SnakeReplayInput sweep_inputs[SWEEP_ROWS * 2];
+
+/* 先扫场让蛇身变长，再原地绕小圈撞上自己，触发重置后继续 */
+static SnakeReplayInput collide_inputs[COLLIDE_SWEEP_ROWS * 2 + 8];
+
+/* 多人对局的一条输入：在 tick 时改变 player 的方向 */
+typedef struct
+{
+    Uint32 tick;
+    Uint8 player;
+    Uint8 dir;
+} MeleeInput;
+
+/* 三人对局：1 号蛇向上穿过 0 号蛇的行，0 号蛇撞上它并在出生点复活；
+ * 1 号蛇随后撞上 2 号蛇的蛇身，0 号蛇再向下撞上 1 号蛇
+ */
+static const MeleeInput melee_inputs[] = {
+    {8, 1, SNAKE_DIR_UP}, {20, 2, SNAKE_DIR_UP}, {24, 2, SNAKE_DIR_LEFT},
+    {30, 0, SNAKE_DIR_DOWN}, {36, 0, SNAKE_DIR_RIGHT}};
+
+static SnakeReplay replays[] = {
+    {"straight", 1, 200, straight_inputs, (int)SDL_arraysize(straight_inputs)},
+    {"zigzag", 2, 400, zigzag_inputs, (int)SDL_arraysize(zigzag_inputs)},
+    {"sweep", 4, 0, sweep_inputs, 0},
+    {"collide", 3, 0, collide_inputs, 0}};
+
+/* 生成扫场输入：每行走满 SNAKE_GAME_WIDTH - 1 格后下移一格并掉头
+ * 返回生成的输入数量，*tick 更新为扫场结束时的 tick
+ */
+static int build_sweep_inputs_(SnakeReplayInput *inputs, int rows, Uint32 *tick)
+{
+    int row;
+    int n = 0;
+    for (row = 0; row < rows; row++)
+    {
+        *tick += SNAKE_GAME_WIDTH - 1;
+        inputs[n].tick = *tick;
+        inputs[n].dir = SNAKE_DIR_DOWN;
+        ++n;
+        *tick += 1;
+        inputs[n].tick = *tick;
+        inputs[n].dir = (row % 2 == 0) ? SNAKE_DIR_LEFT : SNAKE_DIR_RIGHT;
+        ++n;
+    }
+    return n;
+}
+
+/* 生成需要运行时计算的回放输入 */
+static void build_replays_(void)
+{
+    static const Uint8 loop[] = {SNAKE_DIR_UP, SNAKE_DIR_LEFT, SNAKE_DIR_DOWN, SNAKE_DIR_RIGHT};
+    SnakeReplay *sweep = &replays[2];
+    SnakeReplay *collide = &replays[3];
+    Uint32 tick = 0;
+    int n;
+    int i;
+
+    sweep->input_count = build_sweep_inputs_(sweep_inputs, SWEEP_ROWS, &tick);
+    sweep->ticks = tick + SNAKE_GAME_WIDTH;
+
+    /* 扫场结束时蛇正在向右或向左移动，两圈小方块足以撞上蛇身 */
+    tick = 0;
+    n = build_sweep_inputs_(collide_inputs, COLLIDE_SWEEP_ROWS, &tick);
+    for (i = 0; i < 8; i++)
+    {
+        collide_inputs[n].tick = tick + 2 + i;
+        collide_inputs[n].dir = loop[i % 4];
+        ++n;
+    }
+    collide->input_count = n;
+    collide->ticks = tick + 40;
+}
+
+/* 一帧的黄金哈希记录 */
+typedef struct
+{
+    char replay[32];
+    Uint32 tick;
+    Uint64 hash;
+} GoldenFrame;
+
+/* 逐帧检查的状态 */
+typedef struct
+{
+    SDL_Renderer *renderer;
+    bool update;
+    const GoldenFrame *golden;
+    int golden_count;
+    GoldenFrame *actual;
+    int actual_count;
+    int mismatches;
+    int missing;
+} FrameCheck;
+
+/* 计算表面像素的 64 位 FNV-1a 哈希
+ * 按像素值的小端字节顺序计算，与平台字节序无关
+ */
+static Uint64 hash_surface_(SDL_Surface *surface)
+{
+    Uint64 hash = 0xcbf29ce484222325ULL;
+    int x;
+    int y;
+    for (y = 0; y < surface->h; y++)
+    {
+        const Uint32 *row = (const Uint32 *)((const Uint8 *)surface->pixels + y * surface->pitch);
+        for (x = 0; x < surface->w; x++)
+        {
+            Uint32 px = row[x];
+            int b;
+            for (b = 0; b < 4; b++)
+            {
+                hash ^= (Uint8)(px >> (b * 8));
+                hash *= 0x100000001b3ULL;
+            }
+        }
+    }
+    return hash;
+}
+
+/* 用指定策略渲染一帧并返回像素哈希 */
+static bool render_frame_hash_(SDL_Renderer *renderer, const SnakeContext *ctx,
+                               SnakeRenderStrategy strategy, Uint64 *hash)
+{
+    SDL_Surface *pixels;
+    SDL_Surface *converted;
+
+    if (!snake_render(renderer, ctx, strategy))
+    {
+        return false;
+    }
+    pixels = SDL_RenderReadPixels(renderer, NULL);
+    if (!pixels)
+    {
+        return false;
+    }
+    /* 统一为 ARGB8888，保证哈希与渲染器内部格式无关 */
+    converted = SDL_ConvertSurface(pixels, SDL_PIXELFORMAT_ARGB8888);
+    SDL_DestroySurface(pixels);
+    if (!converted)
+    {
+        return false;
+    }
+    *hash = hash_surface_(converted);
+    SDL_DestroySurface(converted);
+    return true;
+}
+
+/* 读取黄金哈希文件，每行格式：<回放名> <tick> <16位十六进制哈希> */
+static int load_golden_(const char *path, GoldenFrame *frames, int max_frames)
+{
+    size_t size;
+    char *text = (char *)SDL_LoadFile(path, &size);
+    char *line;
+    char *save = NULL;
+    int count = 0;
+
+    if (!text)
+    {
+        return -1;
+    }
+    for (line = SDL_strtok_r(text, "\r\n", &save); line && count < max_frames;
+         line = SDL_strtok_r(NULL, "\r\n", &save))
+    {
+        GoldenFrame *f = &frames[count];
+        unsigned long long hash;
+        if (line[0] == '#')
+        {
+            continue;
+        }
+        if (SDL_sscanf(line, "%31s %u %llx", f->replay, &f->tick, &hash) == 3)
+        {
+            f->hash = (Uint64)hash;
+            ++count;
+        }
+    }
+    SDL_free(text);
+    return count;
+}
+
+/* 写出黄金哈希文件，所在目录不存在时先创建 */
+static bool save_golden_(const char *path, const GoldenFrame *frames, int count)
+{
+    const char *slash = SDL_strrchr(path, '/');
+    SDL_IOStream *io;
+    int i;
+    if (slash && slash != path)
+    {
+        char *dir = SDL_strndup(path, (size_t)(slash - path));
+        if (dir)
+        {
+            SDL_CreateDirectory(dir); /* 已存在时无影响，失败由下面的打开报告 */
+            SDL_free(dir);
+        }
+    }
+    io = SDL_IOFromFile(path, "w");
+    if (!io)
+    {
+        return false;
+    }
+    SDL_IOprintf(io, "# snake render golden hashes: <replay> <tick> <fnv1a64 of ARGB8888 frame>\n");
+    for (i = 0; i < count; i++)
+    {
+        SDL_IOprintf(io, "%s %u %016llx\n", frames[i].replay, frames[i].tick,
+                     (unsigned long long)frames[i].hash);
+    }
+    return SDL_CloseIO(io);
+}
+
+/* 在黄金记录中查找指定帧 */
+static const GoldenFrame *find_golden_(const GoldenFrame *frames, int count,
+                                       const char *replay, Uint32 tick)
+{
+    int i;
+    for (i = 0; i < count; i++)
+    {
+        if (frames[i].tick == tick && SDL_strcmp(frames[i].replay, replay) == 0)
+        {
+            return &frames[i];
+        }
+    }
+    return NULL;
+}
+
+/* 用所有策略渲染一帧：与逐格参考实现比较，再与黄金哈希比较，并记录参考哈希
+ * 渲染失败时返回 false
+ */
+static bool check_frame_(FrameCheck *check, const char *name, Uint32 tick, const SnakeContext *ctx)
+{
+    Uint64 reference;
+    int s;
+
+    if (!render_frame_hash_(check->renderer, ctx, SNAKE_RENDER_PER_CELL, &reference))
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "render-check: %s", SDL_GetError());
+        return false;
+    }
+    for (s = SNAKE_RENDER_PER_CELL + 1; s < SNAKE_RENDER_STRATEGY_COUNT; s++)
+    {
+        Uint64 hash;
+        if (!render_frame_hash_(check->renderer, ctx, (SnakeRenderStrategy)s, &hash))
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_TEST, "render-check: %s", SDL_GetError());
+            return false;
+        }
+        if (hash != reference)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_TEST,
+                         "render-check: %s tick %u: strategy '%s' %016llx != percell %016llx",
+                         name, tick, snake_render_strategy_name((SnakeRenderStrategy)s),
+                         (unsigned long long)hash, (unsigned long long)reference);
+            ++check->mismatches;
+        }
+    }
+
+    if (check->golden)
+    {
+        const GoldenFrame *g = find_golden_(check->golden, check->golden_count, name, tick);
+        if (!g)
+        {
+            ++check->missing;
+        }
+        else if (g->hash != reference)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_TEST,
+                         "render-check: %s tick %u: percell %016llx != golden %016llx",
+                         name, tick, (unsigned long long)reference, (unsigned long long)g->hash);
+            ++check->mismatches;
+        }
+    }
+
+    if (check->actual_count < RENDER_CHECK_MAX_FRAMES)
+    {
+        GoldenFrame *f = &check->actual[check->actual_count++];
+        SDL_strlcpy(f->replay, name, sizeof(f->replay));
+        f->tick = tick;
+        f->hash = reference;
+    }
+    return true;
+}
+
+/* 回放多人对局并逐帧检查；脚本必须真的让蛇撞死并在之后复活，否则也算作不一致 */
+static bool check_melee_(FrameCheck *check)
+{
+    SnakeContext ctx;
+    Uint32 tick;
+    int cursor = 0;
+    int deaths = 0;
+    int respawns = 0;
+    bool dead[SNAKE_MAX_PLAYERS] = {false};
+    int p;
+
+    snake_initialize_seeded(&ctx, MELEE_SEED);
+    snake_set_player_count(&ctx, MELEE_PLAYERS);
+    for (tick = 0;; tick++)
+    {
+        if (!check_frame_(check, MELEE_NAME, tick, &ctx))
+        {
+            return false;
+        }
+        if (tick == MELEE_TICKS)
+        {
+            break;
+        }
+        while (cursor < (int)SDL_arraysize(melee_inputs) && melee_inputs[cursor].tick <= tick)
+        {
+            snake_player_redir(&ctx, melee_inputs[cursor].player, (SnakeDirection)melee_inputs[cursor].dir);
+            ++cursor;
+        }
+        snake_step(&ctx);
+        for (p = 0; p < MELEE_PLAYERS; p++)
+        {
+            if (dead[p] && ctx.players[p].alive)
+            {
+                ++respawns;
+            }
+            else if (!dead[p] && !ctx.players[p].alive)
+            {
+                ++deaths;
+            }
+            dead[p] = !ctx.players[p].alive;
+        }
+    }
+    if (deaths == 0 || respawns == 0)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "render-check: %s has %d crashes and %d respawns, expected both",
+                     MELEE_NAME, deaths, respawns);
+        ++check->mismatches;
+    }
+    return true;
+}
+
+SDL_AppResult snake_render_check(int argc, char *argv[])
+{
+    static GoldenFrame golden[RENDER_CHECK_MAX_FRAMES];
+    static GoldenFrame actual[RENDER_CHECK_MAX_FRAMES];
+    const char *golden_path = RENDER_CHECK_DEFAULT_GOLDEN;
+    bool golden_required = false;
+    FrameCheck check;
+    SDL_Surface *target;
+    SDL_Renderer *renderer;
+    size_t r;
+    int i;
+
+    SDL_zero(check);
+    check.golden = golden;
+    check.actual = actual;
+    for (i = 1; i < argc; i++)
+    {
+        if (SDL_strcmp(argv[i], "--golden") == 0 && i + 1 < argc)
+        {
+            golden_path = argv[++i];
+            golden_required = true;
+        }
+        else if (SDL_strcmp(argv[i], "--update-golden") == 0)
+        {
+            check.update = true;
+        }
+    }
+
+    build_replays_();
+
+    /* 软件渲染器直接绘制到内存表面，不需要初始化视频子系统 */
+    target = SDL_CreateSurface(SDL_WINDOW_WIDTH, SDL_WINDOW_HEIGHT, SDL_PIXELFORMAT_ARGB8888);
+    if (!target)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "render-check: %s", SDL_GetError());
+        return SDL_APP_FAILURE;
+    }
+    renderer = SDL_CreateSoftwareRenderer(target);
+    if (!renderer)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "render-check: %s", SDL_GetError());
+        SDL_DestroySurface(target);
+        return SDL_APP_FAILURE;
+    }
+
+    check.renderer = renderer;
+    check.golden_count = check.update ? 0 : load_golden_(golden_path, golden, RENDER_CHECK_MAX_FRAMES);
+    if (check.update)
+    {
+        check.golden = NULL;
+    }
+    else if (check.golden_count < 0 && golden_required)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "render-check: cannot read golden file %s", golden_path);
+        goto failed;
+    }
+    else if (check.golden_count < 0)
+    {
+        SDL_Log("render-check: no golden file at %s, only comparing strategies (generate it with --update-golden)",
+                golden_path);
+        check.golden = NULL;
+    }
+
+    for (r = 0; r < SDL_arraysize(replays); r++)
+    {
+        const SnakeReplay *replay = &replays[r];
+        SnakeReplayPlayer player;
+        SnakeContext ctx;
+        bool more = true;
+
+        snake_replay_start(&player, replay, &ctx);
+        while (more)
+        {
+            if (!check_frame_(&check, replay->name, player.tick, &ctx))
+            {
+                goto failed;
+            }
+            more = snake_replay_step(&player, &ctx);
+        }
+    }
+    if (!check_melee_(&check))
+    {
+        goto failed;
+    }
+
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroySurface(target);
+
+    if (check.update)
+    {
+        if (!save_golden_(golden_path, actual, check.actual_count))
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_TEST, "render-check: cannot write %s: %s", golden_path, SDL_GetError());
+            return SDL_APP_FAILURE;
+        }
+        SDL_Log("render-check: wrote %d golden frames to %s", check.actual_count, golden_path);
+    }
+    if (check.missing > 0)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "render-check: %d frames have no golden hash", check.missing);
+        ++check.mismatches;
+    }
+    SDL_Log("render-check: %d frames x %d strategies, %d mismatches",
+            check.actual_count, (int)SNAKE_RENDER_STRATEGY_COUNT, check.mismatches);
+    return check.mismatches == 0 ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+
+failed:
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroySurface(target);
+    return SDL_APP_FAILURE;
+}
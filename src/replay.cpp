@@ -0,0 +1,384 @@
+/*
+ * 游戏回放实现
+ */
+
+#include "replay.h"
+
+void snake_replay_start(SnakeReplayPlayer *player, const SnakeReplay *replay, SnakeContext *ctx)
+{
+    player->replay = replay;
+    player->tick = 0;
+    player->cursor = 0;
+    snake_initialize_seeded(ctx, replay->seed);
+}
+
+bool snake_replay_step(SnakeReplayPlayer *player, SnakeContext *ctx)
+{
+    const SnakeReplay *replay = player->replay;
+    if (player->tick >= replay->ticks)
+    {
+        return false;
+    }
+    /* 应用当前 tick 的全部输入（同一 tick 可以有多条） */
+    while (player->cursor < replay->input_count &&
+           replay->inputs[player->cursor].tick <= player->tick)
+    {
+        snake_redir(ctx, (SnakeDirection)replay->inputs[player->cursor].dir);
+        ++player->cursor;
+    }
+    snake_step(ctx);
+    ++player->tick;
+    return true;
+}
+
+#define REPLAY_FILE_MAGIC 0x524B4E53U /* "SNKR" */
+#define REPLAY_FILE_VERSION 3U        /* 3：文件头增加快照布局指纹 */
+#define REPLAY_FILE_VERSION_NO_LAYOUT 2U /* 没有布局指纹的旧版本，只能使用输入和校验和 */
+#define REPLAY_HEADER_SIZE 40U         /* 文件头字节数 */
+#define REPLAY_INDEX_ENTRY_SIZE 16U    /* 索引项字节数 */
+#define REPLAY_INPUT_SIZE 5U           /* 输入记录字节数 */
+
+/* 把一个字段的名称、偏移和大小合并到布局指纹中（FNV-1a） */
+static Uint32 layout_field_(Uint32 hash, const char *name, size_t offset, size_t size)
+{
+    const Uint32 numbers[2] = {(Uint32)offset, (Uint32)size};
+    const Uint8 *p = (const Uint8 *)numbers;
+    size_t i;
+    for (i = 0; name[i] != '\0'; i++)
+    {
+        hash = (hash ^ (Uint8)name[i]) * 0x01000193U;
+    }
+    for (i = 0; i < sizeof(numbers); i++)
+    {
+        hash = (hash ^ p[i]) * 0x01000193U;
+    }
+    return hash;
+}
+
+#define LAYOUT_FIELD_(hash, type, field) \
+    layout_field_((hash), #type "." #field, offsetof(type, field), sizeof(((type *)NULL)->field))
+
+/* 快照的布局指纹：SnakeContext 及其嵌套结构每个字段的名称、偏移和大小，以及字节序；
+ * 字段重新排列、改名或换成同样大小的其他字段时，即使结构体大小不变，指纹也会不同，
+ * 旧快照不会被当作当前布局恢复；给这些结构体增加字段时必须同时加到这里
+ */
+static Uint32 layout_fingerprint_(void)
+{
+    Uint32 hash = layout_field_(0x811C9DC5U, "byteorder", SDL_BYTEORDER, sizeof(SnakeContext));
+
+    hash = LAYOUT_FIELD_(hash, SnakeContext, rng_state);
+    hash = LAYOUT_FIELD_(hash, SnakeContext, tick);
+    hash = LAYOUT_FIELD_(hash, SnakeContext, occupied_cells);
+    hash = LAYOUT_FIELD_(hash, SnakeContext, free_cells);
+    hash = LAYOUT_FIELD_(hash, SnakeContext, events);
+    hash = LAYOUT_FIELD_(hash, SnakeContext, player_count);
+    hash = LAYOUT_FIELD_(hash, SnakeContext, players);
+    hash = LAYOUT_FIELD_(hash, SnakeContext, cells);
+    hash = LAYOUT_FIELD_(hash, SnakeContext, occupied_rows);
+    hash = LAYOUT_FIELD_(hash, SnakeContext, owner);
+    hash = LAYOUT_FIELD_(hash, SnakeContext, entities);
+
+    hash = LAYOUT_FIELD_(hash, SnakePlayer, head_xpos);
+    hash = LAYOUT_FIELD_(hash, SnakePlayer, head_ypos);
+    hash = LAYOUT_FIELD_(hash, SnakePlayer, tail_xpos);
+    hash = LAYOUT_FIELD_(hash, SnakePlayer, tail_ypos);
+    hash = LAYOUT_FIELD_(hash, SnakePlayer, next_dir);
+    hash = LAYOUT_FIELD_(hash, SnakePlayer, inhibit_tail_step);
+    hash = LAYOUT_FIELD_(hash, SnakePlayer, alive);
+    hash = LAYOUT_FIELD_(hash, SnakePlayer, score);
+
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, count);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, expiry_count);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, free_count);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, expiry);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, generation);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, kind);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, dense);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, free_slots);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, food_x);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, food_y);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, food_value);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, food_slot);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, food_lifetime);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, pickup_x);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, pickup_y);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, pickup_value);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, pickup_slot);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, pickup_lifetime);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, effect_x);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, effect_y);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, effect_ticks_left);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, effect_slot);
+    hash = LAYOUT_FIELD_(hash, SnakeEntities, cell_slot);
+
+    hash = LAYOUT_FIELD_(hash, SnakeExpiry, due_tick);
+    hash = LAYOUT_FIELD_(hash, SnakeExpiry, entity);
+    return hash;
+}
+
+int snake_replay_random_inputs(SnakeReplayInput *inputs, Uint32 ticks, Uint64 seed, int turn_chance)
+{
+    Uint32 tick;
+    int n = 0;
+    for (tick = 0; tick < ticks; tick++)
+    {
+        if (SDL_rand_r(&seed, turn_chance) == 0)
+        {
+            inputs[n].tick = tick;
+            inputs[n].dir = (Uint8)SDL_rand_r(&seed, 4);
+            ++n;
+        }
+    }
+    return n;
+}
+
+bool snake_replay_build_keyframes(SnakeReplayArchive *archive, const SnakeReplay *replay, Uint32 interval)
+{
+    SnakeReplayPlayer player;
+    SnakeContext *ctx;
+    Uint32 i;
+
+    SDL_zerop(archive);
+    if (interval == 0)
+    {
+        return SDL_SetError("Keyframe interval must be positive");
+    }
+    archive->replay = *replay;
+    archive->snapshots = true;
+    archive->keyframe_interval = interval;
+    archive->keyframe_count = replay->ticks / interval + 1;
+    archive->keyframes = (SnakeReplayKeyframe *)SDL_calloc(archive->keyframe_count, sizeof(SnakeReplayKeyframe));
+    archive->states = (SnakeContext *)SDL_aligned_alloc(SNAKE_CACHE_LINE, archive->keyframe_count * sizeof(SnakeContext));
+    archive->checksums = (Uint32 *)SDL_calloc((size_t)replay->ticks + 1, sizeof(Uint32));
+    ctx = (SnakeContext *)SDL_aligned_alloc(SNAKE_CACHE_LINE, sizeof(SnakeContext));
+    if (!archive->keyframes || !archive->states || !archive->checksums || !ctx)
+    {
+        SDL_aligned_free(ctx);
+        snake_replay_close(archive);
+        return false;
+    }
+
+    snake_replay_start(&player, &archive->replay, ctx);
+    archive->checksums[0] = snake_checksum_roll(0, ctx);
+    for (i = 0; i < archive->keyframe_count; i++)
+    {
+        while (player.tick < i * interval)
+        {
+            snake_replay_step(&player, ctx);
+            archive->checksums[player.tick] = snake_checksum_roll(archive->checksums[player.tick - 1], ctx);
+        }
+        archive->keyframes[i].tick = player.tick;
+        archive->keyframes[i].cursor = (Uint32)player.cursor;
+        archive->states[i] = *ctx;
+    }
+    /* 最后一个关键帧之后的 tick 只记录校验和 */
+    while (snake_replay_step(&player, ctx))
+    {
+        archive->checksums[player.tick] = snake_checksum_roll(archive->checksums[player.tick - 1], ctx);
+    }
+    SDL_aligned_free(ctx);
+    return true;
+}
+
+/* 文件布局：文件头、关键帧索引、输入、校验和、快照；快照的偏移在写入前即可算出 */
+static Uint64 state_offset_(const SnakeReplay *replay, Uint32 keyframe_count, Uint32 index)
+{
+    return REPLAY_HEADER_SIZE + (Uint64)keyframe_count * REPLAY_INDEX_ENTRY_SIZE +
+           (Uint64)replay->input_count * REPLAY_INPUT_SIZE + ((Uint64)replay->ticks + 1) * sizeof(Uint32) +
+           (Uint64)index * sizeof(SnakeContext);
+}
+
+bool snake_replay_save(const SnakeReplayArchive *archive, const char *path)
+{
+    const SnakeReplay *replay = &archive->replay;
+    SDL_IOStream *io;
+    bool ok = true;
+    Uint32 i;
+    int j;
+
+    if (!archive->states)
+    {
+        return SDL_SetError("Replay has no keyframes in memory");
+    }
+    io = SDL_IOFromFile(path, "wb");
+    if (!io)
+    {
+        return false;
+    }
+
+    ok = ok && SDL_WriteU32LE(io, REPLAY_FILE_MAGIC);
+    ok = ok && SDL_WriteU32LE(io, REPLAY_FILE_VERSION);
+    ok = ok && SDL_WriteU32LE(io, (Uint32)sizeof(SnakeContext));
+    ok = ok && SDL_WriteU32LE(io, layout_fingerprint_());
+    ok = ok && SDL_WriteU64LE(io, replay->seed);
+    ok = ok && SDL_WriteU32LE(io, replay->ticks);
+    ok = ok && SDL_WriteU32LE(io, (Uint32)replay->input_count);
+    ok = ok && SDL_WriteU32LE(io, archive->keyframe_interval);
+    ok = ok && SDL_WriteU32LE(io, archive->keyframe_count);
+    for (i = 0; ok && i < archive->keyframe_count; i++)
+    {
+        ok = SDL_WriteU32LE(io, archive->keyframes[i].tick) &&
+             SDL_WriteU32LE(io, archive->keyframes[i].cursor) &&
+             SDL_WriteU64LE(io, state_offset_(replay, archive->keyframe_count, i));
+    }
+    for (j = 0; ok && j < replay->input_count; j++)
+    {
+        ok = SDL_WriteU32LE(io, replay->inputs[j].tick) && SDL_WriteU8(io, replay->inputs[j].dir);
+    }
+    for (i = 0; ok && i <= replay->ticks; i++)
+    {
+        ok = SDL_WriteU32LE(io, archive->checksums[i]);
+    }
+    for (i = 0; ok && i < archive->keyframe_count; i++)
+    {
+        ok = SDL_WriteIO(io, &archive->states[i], sizeof(SnakeContext)) == sizeof(SnakeContext);
+    }
+
+    if (!SDL_CloseIO(io))
+    {
+        ok = false;
+    }
+    return ok;
+}
+
+bool snake_replay_open(SnakeReplayArchive *archive, const char *path)
+{
+    Uint32 magic = 0;
+    Uint32 version = 0;
+    Uint32 context_size = 0;
+    Uint32 layout = 0;
+    Uint32 input_count = 0;
+    bool ok = true;
+    Uint32 i;
+
+    SDL_zerop(archive);
+    archive->io = SDL_IOFromFile(path, "rb");
+    if (!archive->io)
+    {
+        return false;
+    }
+
+    ok = ok && SDL_ReadU32LE(archive->io, &magic);
+    ok = ok && SDL_ReadU32LE(archive->io, &version);
+    ok = ok && SDL_ReadU32LE(archive->io, &context_size);
+    if (ok && version == REPLAY_FILE_VERSION)
+    {
+        ok = SDL_ReadU32LE(archive->io, &layout);
+    }
+    ok = ok && SDL_ReadU64LE(archive->io, &archive->replay.seed);
+    ok = ok && SDL_ReadU32LE(archive->io, &archive->replay.ticks);
+    ok = ok && SDL_ReadU32LE(archive->io, &input_count);
+    ok = ok && SDL_ReadU32LE(archive->io, &archive->keyframe_interval);
+    ok = ok && SDL_ReadU32LE(archive->io, &archive->keyframe_count);
+    if (!ok || magic != REPLAY_FILE_MAGIC || (version != REPLAY_FILE_VERSION && version != REPLAY_FILE_VERSION_NO_LAYOUT))
+    {
+        snake_replay_close(archive);
+        return SDL_SetError("%s is not a replay file", path);
+    }
+    if (archive->keyframe_interval == 0 ||
+        archive->keyframe_count != archive->replay.ticks / archive->keyframe_interval + 1)
+    {
+        snake_replay_close(archive);
+        return SDL_SetError("%s has an invalid keyframe index", path);
+    }
+    /* 输入和校验和总是可用；快照只有布局指纹相同的程序才能恢复（大小相同不代表布局相同） */
+    archive->snapshots = version == REPLAY_FILE_VERSION && context_size == sizeof(SnakeContext) &&
+                         layout == layout_fingerprint_();
+
+    archive->replay.name = path;
+    archive->replay.input_count = (int)input_count;
+    archive->keyframes = (SnakeReplayKeyframe *)SDL_calloc(archive->keyframe_count, sizeof(SnakeReplayKeyframe));
+    archive->input_storage = (SnakeReplayInput *)SDL_calloc(input_count ? input_count : 1, sizeof(SnakeReplayInput));
+    archive->checksums = (Uint32 *)SDL_calloc((size_t)archive->replay.ticks + 1, sizeof(Uint32));
+    if (!archive->keyframes || !archive->input_storage || !archive->checksums)
+    {
+        snake_replay_close(archive);
+        return false;
+    }
+    archive->replay.inputs = archive->input_storage;
+
+    for (i = 0; ok && i < archive->keyframe_count; i++)
+    {
+        ok = SDL_ReadU32LE(archive->io, &archive->keyframes[i].tick) &&
+             SDL_ReadU32LE(archive->io, &archive->keyframes[i].cursor) &&
+             SDL_ReadU64LE(archive->io, &archive->keyframes[i].offset);
+    }
+    for (i = 0; ok && i < input_count; i++)
+    {
+        ok = SDL_ReadU32LE(archive->io, &archive->input_storage[i].tick) &&
+             SDL_ReadU8(archive->io, &archive->input_storage[i].dir);
+    }
+    for (i = 0; ok && i <= archive->replay.ticks; i++)
+    {
+        ok = SDL_ReadU32LE(archive->io, &archive->checksums[i]);
+    }
+    if (!ok)
+    {
+        snake_replay_close(archive);
+        return SDL_SetError("%s is truncated", path);
+    }
+    return true;
+}
+
+void snake_replay_close(SnakeReplayArchive *archive)
+{
+    if (archive->io)
+    {
+        SDL_CloseIO(archive->io);
+    }
+    SDL_free(archive->keyframes);
+    SDL_aligned_free(archive->states);
+    SDL_free(archive->input_storage);
+    SDL_free(archive->checksums);
+    SDL_zerop(archive);
+}
+
+/* 把第 index 个关键帧的快照恢复到 ctx */
+static bool load_keyframe_(SnakeReplayArchive *archive, Uint32 index, SnakeContext *ctx)
+{
+    if (archive->states)
+    {
+        *ctx = archive->states[index];
+        return true;
+    }
+    if (SDL_SeekIO(archive->io, (Sint64)archive->keyframes[index].offset, SDL_IO_SEEK_SET) < 0 ||
+        SDL_ReadIO(archive->io, ctx, sizeof(SnakeContext)) != sizeof(SnakeContext))
+    {
+        return SDL_SetError("Cannot read keyframe %u", (unsigned)index);
+    }
+    return true;
+}
+
+bool snake_replay_seek(SnakeReplayPlayer *player, SnakeReplayArchive *archive, SnakeContext *ctx, Uint32 tick)
+{
+    Uint32 index;
+
+    tick = SDL_min(tick, archive->replay.ticks);
+    index = SDL_min(tick / archive->keyframe_interval, archive->keyframe_count - 1);
+
+    if (!archive->snapshots)
+    {
+        /* 快照不可用：向后跳转时从头执行 */
+        if (player->replay != &archive->replay || player->tick > tick)
+        {
+            snake_replay_start(player, &archive->replay, ctx);
+        }
+    }
+    /* 向前小步拖动时，当前位置比关键帧更近，直接继续执行 */
+    else if (player->replay != &archive->replay || player->tick > tick ||
+             player->tick < archive->keyframes[index].tick)
+    {
+        if (!load_keyframe_(archive, index, ctx))
+        {
+            return false;
+        }
+        player->replay = &archive->replay;
+        player->tick = archive->keyframes[index].tick;
+        player->cursor = (int)archive->keyframes[index].cursor;
+    }
+    while (player->tick < tick)
+    {
+        snake_replay_step(player, ctx);
+    }
+    return true;
+}
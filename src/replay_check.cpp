@@ -0,0 +1,134 @@
+/*
+ * 回放跳转检查
+ * 生成一段很长的随机回放，保存为带关键帧的回放文件后重新打开，
+ * 以乱序跳转到若干 tick，结果必须与从头顺序播放得到的状态逐字节一致
+ */
+
+#include "headless.h"
+#include "replay.h"
+
+#define SEEK_CHECK_DEFAULT_PATH "seek_check.snkr"
+#define SEEK_CHECK_TICKS 1000000U  /* 回放长度 */
+#define SEEK_CHECK_TURN_CHANCE 4   /* 每个 tick 转向的概率为 1/4 */
+#define SEEK_CHECK_TARGETS 32      /* 跳转目标数量 */
+
+/* 对跳转目标排序 */
+static int SDLCALL compare_ticks_(const void *a, const void *b)
+{
+    const Uint32 x = *(const Uint32 *)a;
+    const Uint32 y = *(const Uint32 *)b;
+    return (x > y) - (x < y);
+}
+
+SDL_AppResult snake_seek_check(int argc, char *argv[])
+{
+    const char *path = SEEK_CHECK_DEFAULT_PATH;
+    SnakeReplayInput *inputs = NULL;
+    SnakeContext *expected = NULL;
+    SnakeContext *ctx = NULL;
+    SnakeReplayArchive built;
+    SnakeReplayArchive opened;
+    SnakeReplayPlayer linear;
+    SnakeReplayPlayer seeker;
+    SnakeReplay replay;
+    Uint32 targets[SEEK_CHECK_TARGETS];
+    Uint64 rng = 0x5EEC;
+    Uint64 start;
+    Uint64 linear_ns;
+    Uint64 seek_ns = 0;
+    Uint64 max_seek_ns = 0;
+    int mismatches = 0;
+    int order;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (SDL_strcmp(argv[i], "--replay-path") == 0 && i + 1 < argc)
+        {
+            path = argv[++i];
+        }
+    }
+
+    SDL_zero(built);
+    SDL_zero(opened);
+    inputs = (SnakeReplayInput *)SDL_malloc(SEEK_CHECK_TICKS * sizeof(SnakeReplayInput));
+    expected = (SnakeContext *)SDL_aligned_alloc(SNAKE_CACHE_LINE, SEEK_CHECK_TARGETS * sizeof(SnakeContext));
+    ctx = (SnakeContext *)SDL_aligned_alloc(SNAKE_CACHE_LINE, sizeof(SnakeContext));
+    if (!inputs || !expected || !ctx)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "seek-check: out of memory");
+        mismatches = -1;
+        goto done;
+    }
+
+    replay.name = "random";
+    replay.seed = 0x5EEC;
+    replay.ticks = SEEK_CHECK_TICKS;
+    replay.inputs = inputs;
+    replay.input_count = snake_replay_random_inputs(inputs, SEEK_CHECK_TICKS, rng, SEEK_CHECK_TURN_CHANCE);
+
+    /* 生成关键帧并保存，再从文件打开（快照按需读取） */
+    start = SDL_GetTicksNS();
+    if (!snake_replay_build_keyframes(&built, &replay, SNAKE_REPLAY_KEYFRAME_INTERVAL) ||
+        !snake_replay_save(&built, path) || !snake_replay_open(&opened, path))
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "seek-check: %s", SDL_GetError());
+        mismatches = -1;
+        goto done;
+    }
+    SDL_Log("seek-check: %u ticks, %d inputs, %u keyframes built and saved in %.1f ms",
+            replay.ticks, replay.input_count, built.keyframe_count, (SDL_GetTicksNS() - start) / 1e6);
+
+    /* 顺序播放得到各目标 tick 的参考状态 */
+    for (i = 0; i < SEEK_CHECK_TARGETS; i++)
+    {
+        targets[i] = (Uint32)SDL_rand_r(&rng, (Sint32)replay.ticks + 1);
+    }
+    targets[0] = replay.ticks; /* 包括回放结尾 */
+    SDL_qsort(targets, SEEK_CHECK_TARGETS, sizeof(targets[0]), compare_ticks_);
+    start = SDL_GetTicksNS();
+    snake_replay_start(&linear, &replay, ctx);
+    for (i = 0; i < SEEK_CHECK_TARGETS; i++)
+    {
+        while (linear.tick < targets[i])
+        {
+            snake_replay_step(&linear, ctx);
+        }
+        expected[i] = *ctx;
+    }
+    linear_ns = SDL_GetTicksNS() - start;
+
+    /* 以乱序（相邻目标交替从两端取）跳转并比较 */
+    SDL_zero(seeker);
+    for (order = 0; order < SEEK_CHECK_TARGETS; order++)
+    {
+        const int index = (order % 2 == 0) ? order / 2 : SEEK_CHECK_TARGETS - 1 - order / 2;
+        Uint64 elapsed;
+        start = SDL_GetTicksNS();
+        if (!snake_replay_seek(&seeker, &opened, ctx, targets[index]))
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_TEST, "seek-check: %s", SDL_GetError());
+            mismatches = -1;
+            goto done;
+        }
+        elapsed = SDL_GetTicksNS() - start;
+        seek_ns += elapsed;
+        max_seek_ns = SDL_max(max_seek_ns, elapsed);
+        if (SDL_memcmp(ctx, &expected[index], sizeof(SnakeContext)) != 0)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_TEST, "seek-check: state mismatch after seeking to tick %u", targets[index]);
+            ++mismatches;
+        }
+    }
+    SDL_Log("seek-check: linear playback %.1f ms, %d seeks avg %.3f ms max %.3f ms, %d mismatches",
+            linear_ns / 1e6, SEEK_CHECK_TARGETS, seek_ns / 1e6 / SEEK_CHECK_TARGETS, max_seek_ns / 1e6, mismatches);
+
+done:
+    snake_replay_close(&opened);
+    snake_replay_close(&built);
+    SDL_RemovePath(path);
+    SDL_aligned_free(ctx);
+    SDL_aligned_free(expected);
+    SDL_free(inputs);
+    return mismatches == 0 ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+}
@@ -0,0 +1,641 @@
+/*
+ * 流式回放实现
+ * 写入端：录制线程把输入编码到当前块缓冲区，写满后放入队列，
+ * 后台线程取出后压缩、写文件并记录索引；缓冲区数量固定，全部在排队时录制线程等待
+ * 读取端：只保留当前块的原始数据和压缩数据两个缓冲区
+ */
+
+#include "replay_stream.h"
+#include "lz.h"
+
+#define STREAM_FILE_MAGIC 0x534B4E53U    /* "SNKS" */
+#define STREAM_TRAILER_MAGIC 0x454B4E53U /* "SNKE" */
+#define STREAM_FILE_VERSION 1U
+#define STREAM_HEADER_SIZE 16U           /* 文件头字节数 */
+#define STREAM_CHUNK_HEADER_SIZE 16U     /* 块头字节数 */
+#define STREAM_INDEX_ENTRY_SIZE 16U      /* 索引项字节数 */
+#define STREAM_TRAILER_SIZE 16U          /* 文件尾字节数 */
+#define STREAM_MAX_RECORD 6              /* 单条输入编码后的最大长度（5 字节变长整数 + 方向） */
+#define STREAM_STORED_MAX SNAKE_LZ_BOUND(SNAKE_REPLAY_CHUNK_SIZE)
+
+/* 块索引项 */
+typedef struct
+{
+    Uint32 first_tick;  /* 块中第一条输入的 tick */
+    Uint32 input_count; /* 块中的输入数量 */
+    Uint64 offset;      /* 块头在文件中的偏移 */
+} StreamChunkEntry;
+
+/* 写入端的块缓冲区 */
+typedef struct
+{
+    Uint8 data[SNAKE_REPLAY_CHUNK_SIZE]; /* 编码后的输入 */
+    Uint32 size;                         /* 已使用的字节数 */
+    Uint32 first_tick;                   /* 第一条输入的 tick */
+    Uint32 last_tick;                    /* 最后一条输入的 tick */
+    Uint32 input_count;                  /* 输入数量 */
+} StreamBuffer;
+
+struct SnakeReplayWriter
+{
+    SDL_IOStream *io;
+    SDL_Thread *thread;
+    SDL_Mutex *lock;
+    SDL_Condition *queued;    /* 有块等待压缩或正在关闭 */
+    SDL_Condition *released;  /* 有缓冲区被释放 */
+
+    StreamBuffer buffers[SNAKE_REPLAY_WRITER_BUFFERS];
+    StreamBuffer *current;    /* 录制线程正在填充的缓冲区 */
+
+    /* 以下字段由 lock 保护 */
+    StreamBuffer *free_list[SNAKE_REPLAY_WRITER_BUFFERS];
+    int free_count;
+    StreamBuffer *queue[SNAKE_REPLAY_WRITER_BUFFERS]; /* 等待压缩的块（先进先出） */
+    int queue_head;
+    int queue_count;
+    bool closing;
+
+    /* 以下字段只由后台线程访问（关闭时在等待线程结束之后读取） */
+    Uint8 stored[STREAM_STORED_MAX];
+    StreamChunkEntry *index;
+    Uint32 index_capacity;
+    Uint64 offset;            /* 下一块的文件偏移 */
+    bool failed;
+
+    SnakeReplayWriterStats stats;
+};
+
+struct SnakeReplayReader
+{
+    SDL_IOStream *io;
+    Uint64 seed;
+    Uint32 ticks;
+    StreamChunkEntry *index;
+    Uint32 chunk_count;
+
+    /* 当前块 */
+    int chunk;                /* 当前块编号，-1 表示尚未读取 */
+    Uint8 raw[SNAKE_REPLAY_CHUNK_SIZE];
+    Uint8 stored[STREAM_STORED_MAX];
+    Uint32 raw_size;
+    Uint32 pos;               /* 下一条输入在 raw 中的位置 */
+    Uint32 remaining;         /* 当前块中尚未读取的输入数量 */
+    Uint32 prev_tick;         /* 上一条输入的 tick（变长编码的基准） */
+
+    /* 播放状态 */
+    SnakeReplayInput pending; /* 已读取但尚未应用的输入 */
+    bool has_pending;
+    Uint32 tick;              /* 已执行的 tick 数 */
+};
+
+/* 写出一块：压缩（压缩后不变小时保留原始数据）、写文件并记录索引 */
+static void write_chunk_(SnakeReplayWriter *writer, const StreamBuffer *buffer)
+{
+    const int compressed = snake_lz_compress(buffer->data, (int)buffer->size, writer->stored, STREAM_STORED_MAX);
+    const bool packed = compressed > 0 && (Uint32)compressed < buffer->size;
+    const Uint32 stored_size = packed ? (Uint32)compressed : buffer->size;
+    StreamChunkEntry *entry;
+    bool ok;
+
+    if (writer->stats.chunks == writer->index_capacity)
+    {
+        const Uint32 capacity = writer->index_capacity ? writer->index_capacity * 2 : 64;
+        StreamChunkEntry *index = (StreamChunkEntry *)SDL_realloc(writer->index, capacity * sizeof(StreamChunkEntry));
+        if (!index)
+        {
+            writer->failed = true;
+            return;
+        }
+        writer->index = index;
+        writer->index_capacity = capacity;
+    }
+
+    ok = SDL_WriteU32LE(writer->io, buffer->first_tick) &&
+         SDL_WriteU32LE(writer->io, buffer->input_count) &&
+         SDL_WriteU32LE(writer->io, buffer->size) &&
+         SDL_WriteU32LE(writer->io, stored_size) &&
+         SDL_WriteIO(writer->io, packed ? writer->stored : buffer->data, stored_size) == stored_size;
+    if (!ok)
+    {
+        writer->failed = true;
+        return;
+    }
+
+    entry = &writer->index[writer->stats.chunks++];
+    entry->first_tick = buffer->first_tick;
+    entry->input_count = buffer->input_count;
+    entry->offset = writer->offset;
+    writer->offset += STREAM_CHUNK_HEADER_SIZE + stored_size;
+    writer->stats.raw_bytes += buffer->size;
+    writer->stats.stored_bytes += stored_size;
+}
+
+/* 后台写入线程：取出排队的块写出，直到关闭且队列为空 */
+static int SDLCALL writer_thread_(void *userdata)
+{
+    SnakeReplayWriter *writer = (SnakeReplayWriter *)userdata;
+
+    SDL_LockMutex(writer->lock);
+    for (;;)
+    {
+        StreamBuffer *buffer;
+        while (writer->queue_count == 0 && !writer->closing)
+        {
+            SDL_WaitCondition(writer->queued, writer->lock);
+        }
+        if (writer->queue_count == 0)
+        {
+            break;
+        }
+        buffer = writer->queue[writer->queue_head];
+        writer->queue_head = (writer->queue_head + 1) % SNAKE_REPLAY_WRITER_BUFFERS;
+        --writer->queue_count;
+        SDL_UnlockMutex(writer->lock);
+
+        if (!writer->failed)
+        {
+            write_chunk_(writer, buffer);
+        }
+
+        SDL_LockMutex(writer->lock);
+        writer->free_list[writer->free_count++] = buffer;
+        SDL_SignalCondition(writer->released);
+    }
+    SDL_UnlockMutex(writer->lock);
+    return 0;
+}
+
+SnakeReplayWriter *snake_replay_writer_open(const char *path, Uint64 seed)
+{
+    SnakeReplayWriter *writer = (SnakeReplayWriter *)SDL_calloc(1, sizeof(SnakeReplayWriter));
+    int i;
+
+    if (!writer)
+    {
+        return NULL;
+    }
+    writer->io = SDL_IOFromFile(path, "wb");
+    if (!writer->io)
+    {
+        SDL_free(writer);
+        return NULL;
+    }
+    if (!SDL_WriteU32LE(writer->io, STREAM_FILE_MAGIC) ||
+        !SDL_WriteU32LE(writer->io, STREAM_FILE_VERSION) ||
+        !SDL_WriteU64LE(writer->io, seed))
+    {
+        SDL_CloseIO(writer->io);
+        SDL_free(writer);
+        return NULL;
+    }
+    writer->offset = STREAM_HEADER_SIZE;
+
+    writer->current = &writer->buffers[0];
+    for (i = 1; i < SNAKE_REPLAY_WRITER_BUFFERS; i++)
+    {
+        writer->free_list[writer->free_count++] = &writer->buffers[i];
+    }
+
+    writer->lock = SDL_CreateMutex();
+    writer->queued = SDL_CreateCondition();
+    writer->released = SDL_CreateCondition();
+    if (writer->lock && writer->queued && writer->released)
+    {
+        writer->thread = SDL_CreateThread(writer_thread_, "snake-replay-writer", writer);
+    }
+    if (!writer->thread)
+    {
+        SDL_DestroyCondition(writer->released);
+        SDL_DestroyCondition(writer->queued);
+        SDL_DestroyMutex(writer->lock);
+        SDL_CloseIO(writer->io);
+        SDL_free(writer);
+        return NULL;
+    }
+    return writer;
+}
+
+/* 把当前缓冲区交给后台线程，并取得一个空闲缓冲区（没有时等待） */
+static void submit_current_(SnakeReplayWriter *writer)
+{
+    SDL_LockMutex(writer->lock);
+    writer->queue[(writer->queue_head + writer->queue_count) % SNAKE_REPLAY_WRITER_BUFFERS] = writer->current;
+    ++writer->queue_count;
+    SDL_SignalCondition(writer->queued);
+    if (writer->free_count == 0)
+    {
+        ++writer->stats.stalls;
+        do
+        {
+            SDL_WaitCondition(writer->released, writer->lock);
+        } while (writer->free_count == 0);
+    }
+    writer->current = writer->free_list[--writer->free_count];
+    SDL_UnlockMutex(writer->lock);
+
+    writer->current->size = 0;
+    writer->current->input_count = 0;
+}
+
+void snake_replay_writer_record(SnakeReplayWriter *writer, Uint32 tick, SnakeDirection dir)
+{
+    StreamBuffer *buffer = writer->current;
+    Uint32 delta;
+
+    if (buffer->size + STREAM_MAX_RECORD > SNAKE_REPLAY_CHUNK_SIZE)
+    {
+        submit_current_(writer);
+        buffer = writer->current;
+    }
+    if (buffer->input_count == 0)
+    {
+        buffer->first_tick = tick;
+        buffer->last_tick = tick;
+    }
+
+    /* tick 差按 7 位一组的变长整数编码，最高位表示后面还有字节 */
+    delta = tick - buffer->last_tick;
+    while (delta >= 0x80)
+    {
+        buffer->data[buffer->size++] = (Uint8)(delta | 0x80);
+        delta >>= 7;
+    }
+    buffer->data[buffer->size++] = (Uint8)delta;
+    buffer->data[buffer->size++] = (Uint8)dir;
+    buffer->last_tick = tick;
+    ++buffer->input_count;
+    ++writer->stats.inputs;
+}
+
+bool snake_replay_writer_close(SnakeReplayWriter *writer, Uint32 ticks, SnakeReplayWriterStats *stats)
+{
+    bool ok;
+    Uint32 i;
+
+    if (writer->current->input_count > 0)
+    {
+        submit_current_(writer);
+    }
+    SDL_LockMutex(writer->lock);
+    writer->closing = true;
+    SDL_SignalCondition(writer->queued);
+    SDL_UnlockMutex(writer->lock);
+    SDL_WaitThread(writer->thread, NULL);
+
+    /* 索引和文件尾 */
+    ok = !writer->failed;
+    for (i = 0; ok && i < writer->stats.chunks; i++)
+    {
+        ok = SDL_WriteU32LE(writer->io, writer->index[i].first_tick) &&
+             SDL_WriteU32LE(writer->io, writer->index[i].input_count) &&
+             SDL_WriteU64LE(writer->io, writer->index[i].offset);
+    }
+    ok = ok && SDL_WriteU64LE(writer->io, writer->offset);
+    ok = ok && SDL_WriteU32LE(writer->io, ticks);
+    ok = ok && SDL_WriteU32LE(writer->io, STREAM_TRAILER_MAGIC);
+    if (!SDL_CloseIO(writer->io))
+    {
+        ok = false;
+    }
+
+    if (stats)
+    {
+        *stats = writer->stats;
+    }
+    SDL_DestroyCondition(writer->released);
+    SDL_DestroyCondition(writer->queued);
+    SDL_DestroyMutex(writer->lock);
+    SDL_free(writer->index);
+    SDL_free(writer);
+    return ok;
+}
+
+/* 读取第 chunk 块并解压到 raw */
+static bool load_chunk_(SnakeReplayReader *reader, int chunk)
+{
+    const StreamChunkEntry *entry = &reader->index[chunk];
+    Uint32 first_tick = 0;
+    Uint32 input_count = 0;
+    Uint32 raw_size = 0;
+    Uint32 stored_size = 0;
+
+    if (SDL_SeekIO(reader->io, (Sint64)entry->offset, SDL_IO_SEEK_SET) < 0 ||
+        !SDL_ReadU32LE(reader->io, &first_tick) ||
+        !SDL_ReadU32LE(reader->io, &input_count) ||
+        !SDL_ReadU32LE(reader->io, &raw_size) ||
+        !SDL_ReadU32LE(reader->io, &stored_size))
+    {
+        return SDL_SetError("Cannot read replay chunk %d", chunk);
+    }
+    if (first_tick != entry->first_tick || input_count != entry->input_count ||
+        raw_size > SNAKE_REPLAY_CHUNK_SIZE || stored_size > raw_size)
+    {
+        return SDL_SetError("Replay chunk %d is corrupt", chunk);
+    }
+
+    if (stored_size == raw_size)
+    {
+        if (SDL_ReadIO(reader->io, reader->raw, raw_size) != raw_size)
+        {
+            return SDL_SetError("Replay chunk %d is truncated", chunk);
+        }
+    }
+    else if (SDL_ReadIO(reader->io, reader->stored, stored_size) != stored_size ||
+             snake_lz_decompress(reader->stored, (int)stored_size, reader->raw, SNAKE_REPLAY_CHUNK_SIZE) != (int)raw_size)
+    {
+        return SDL_SetError("Replay chunk %d is corrupt", chunk);
+    }
+
+    reader->chunk = chunk;
+    reader->raw_size = raw_size;
+    reader->pos = 0;
+    reader->remaining = input_count;
+    reader->prev_tick = first_tick;
+    return true;
+}
+
+/* 从当前块解码下一条输入，当前块读完时解压下一块 */
+static bool decode_next_(SnakeReplayReader *reader, SnakeReplayInput *input)
+{
+    Uint32 delta = 0;
+    int shift = 0;
+    Uint8 b;
+
+    while (reader->remaining == 0)
+    {
+        if (reader->chunk + 1 >= (int)reader->chunk_count || !load_chunk_(reader, reader->chunk + 1))
+        {
+            return false;
+        }
+    }
+
+    do
+    {
+        if (reader->pos >= reader->raw_size || shift > 28)
+        {
+            return SDL_SetError("Replay chunk %d is corrupt", reader->chunk);
+        }
+        b = reader->raw[reader->pos++];
+        delta |= (Uint32)(b & 0x7F) << shift;
+        shift += 7;
+    } while (b & 0x80);
+    if (reader->pos >= reader->raw_size || reader->raw[reader->pos] > SNAKE_DIR_DOWN)
+    {
+        return SDL_SetError("Replay chunk %d is corrupt", reader->chunk);
+    }
+
+    reader->prev_tick += delta;
+    input->tick = reader->prev_tick;
+    input->dir = reader->raw[reader->pos++];
+    --reader->remaining;
+    return true;
+}
+
+/* 确保 pending 中有下一条输入 */
+static bool peek_(SnakeReplayReader *reader)
+{
+    if (!reader->has_pending)
+    {
+        reader->has_pending = decode_next_(reader, &reader->pending);
+    }
+    return reader->has_pending;
+}
+
+/* 读取文件尾指向的索引，文件没有有效的文件尾时返回 false */
+static bool read_trailer_index_(SnakeReplayReader *reader, Sint64 file_size)
+{
+    Uint64 index_offset = 0;
+    Uint32 magic = 0;
+    Uint64 index_size;
+    Uint32 i;
+
+    if (file_size < (Sint64)(STREAM_HEADER_SIZE + STREAM_TRAILER_SIZE) ||
+        SDL_SeekIO(reader->io, file_size - STREAM_TRAILER_SIZE, SDL_IO_SEEK_SET) < 0 ||
+        !SDL_ReadU64LE(reader->io, &index_offset) ||
+        !SDL_ReadU32LE(reader->io, &reader->ticks) ||
+        !SDL_ReadU32LE(reader->io, &magic) ||
+        magic != STREAM_TRAILER_MAGIC ||
+        index_offset < STREAM_HEADER_SIZE || index_offset > (Uint64)file_size - STREAM_TRAILER_SIZE)
+    {
+        return false;
+    }
+    index_size = (Uint64)file_size - STREAM_TRAILER_SIZE - index_offset;
+    if (index_size % STREAM_INDEX_ENTRY_SIZE != 0)
+    {
+        return false;
+    }
+
+    reader->chunk_count = (Uint32)(index_size / STREAM_INDEX_ENTRY_SIZE);
+    reader->index = (StreamChunkEntry *)SDL_calloc(reader->chunk_count ? reader->chunk_count : 1, sizeof(StreamChunkEntry));
+    if (!reader->index || SDL_SeekIO(reader->io, (Sint64)index_offset, SDL_IO_SEEK_SET) < 0)
+    {
+        return false;
+    }
+    for (i = 0; i < reader->chunk_count; i++)
+    {
+        if (!SDL_ReadU32LE(reader->io, &reader->index[i].first_tick) ||
+            !SDL_ReadU32LE(reader->io, &reader->index[i].input_count) ||
+            !SDL_ReadU64LE(reader->io, &reader->index[i].offset))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* 没有文件尾时依次扫描块头重建索引（忽略末尾不完整的块），总 tick 数取最后一条输入的 tick + 1 */
+static bool scan_index_(SnakeReplayReader *reader, Sint64 file_size)
+{
+    Uint64 offset = STREAM_HEADER_SIZE;
+    Uint32 capacity = 0;
+    SnakeReplayInput input;
+
+    SDL_free(reader->index);
+    reader->index = NULL;
+    reader->chunk_count = 0;
+    reader->ticks = 0;
+
+    while (offset + STREAM_CHUNK_HEADER_SIZE <= (Uint64)file_size)
+    {
+        StreamChunkEntry entry;
+        Uint32 raw_size = 0;
+        Uint32 stored_size = 0;
+
+        entry.offset = offset;
+        if (SDL_SeekIO(reader->io, (Sint64)offset, SDL_IO_SEEK_SET) < 0 ||
+            !SDL_ReadU32LE(reader->io, &entry.first_tick) ||
+            !SDL_ReadU32LE(reader->io, &entry.input_count) ||
+            !SDL_ReadU32LE(reader->io, &raw_size) ||
+            !SDL_ReadU32LE(reader->io, &stored_size) ||
+            raw_size > SNAKE_REPLAY_CHUNK_SIZE || stored_size > raw_size ||
+            offset + STREAM_CHUNK_HEADER_SIZE + stored_size > (Uint64)file_size)
+        {
+            break;
+        }
+        if (reader->chunk_count == capacity)
+        {
+            StreamChunkEntry *index;
+            capacity = capacity ? capacity * 2 : 64;
+            index = (StreamChunkEntry *)SDL_realloc(reader->index, capacity * sizeof(StreamChunkEntry));
+            if (!index)
+            {
+                return false;
+            }
+            reader->index = index;
+        }
+        reader->index[reader->chunk_count++] = entry;
+        offset += STREAM_CHUNK_HEADER_SIZE + stored_size;
+    }
+
+    /* 解压最后一块得到最后一条输入的 tick */
+    if (reader->chunk_count > 0)
+    {
+        if (!load_chunk_(reader, (int)reader->chunk_count - 1))
+        {
+            return false;
+        }
+        while (reader->remaining > 0)
+        {
+            if (!decode_next_(reader, &input))
+            {
+                return false;
+            }
+            reader->ticks = input.tick + 1;
+        }
+    }
+    return true;
+}
+
+SnakeReplayReader *snake_replay_reader_open(const char *path)
+{
+    SnakeReplayReader *reader = (SnakeReplayReader *)SDL_calloc(1, sizeof(SnakeReplayReader));
+    Uint32 magic = 0;
+    Uint32 version = 0;
+    Sint64 file_size;
+
+    if (!reader)
+    {
+        return NULL;
+    }
+    reader->io = SDL_IOFromFile(path, "rb");
+    if (!reader->io)
+    {
+        SDL_free(reader);
+        return NULL;
+    }
+    if (!SDL_ReadU32LE(reader->io, &magic) || !SDL_ReadU32LE(reader->io, &version) ||
+        !SDL_ReadU64LE(reader->io, &reader->seed) ||
+        magic != STREAM_FILE_MAGIC || version != STREAM_FILE_VERSION)
+    {
+        snake_replay_reader_close(reader);
+        SDL_SetError("%s is not a streamed replay file", path);
+        return NULL;
+    }
+
+    file_size = SDL_GetIOSize(reader->io);
+    if (!read_trailer_index_(reader, file_size) && !scan_index_(reader, file_size))
+    {
+        snake_replay_reader_close(reader);
+        return NULL;
+    }
+    reader->chunk = -1;
+    reader->remaining = 0;
+    return reader;
+}
+
+void snake_replay_reader_close(SnakeReplayReader *reader)
+{
+    if (!reader)
+    {
+        return;
+    }
+    if (reader->io)
+    {
+        SDL_CloseIO(reader->io);
+    }
+    SDL_free(reader->index);
+    SDL_free(reader);
+}
+
+Uint64 snake_replay_reader_seed(const SnakeReplayReader *reader)
+{
+    return reader->seed;
+}
+
+Uint32 snake_replay_reader_ticks(const SnakeReplayReader *reader)
+{
+    return reader->ticks;
+}
+
+bool snake_replay_reader_next(SnakeReplayReader *reader, SnakeReplayInput *input)
+{
+    if (!peek_(reader))
+    {
+        return false;
+    }
+    *input = reader->pending;
+    reader->has_pending = false;
+    return true;
+}
+
+bool snake_replay_reader_seek(SnakeReplayReader *reader, Uint32 tick)
+{
+    int lo = 0;
+    int hi = (int)reader->chunk_count - 1;
+    int chunk = 0;
+
+    /* 最后一个首 tick 小于目标的块：同一 tick 的输入可能跨越块边界 */
+    while (lo <= hi)
+    {
+        const int mid = (lo + hi) / 2;
+        if (reader->index[mid].first_tick < tick)
+        {
+            chunk = mid;
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid - 1;
+        }
+    }
+
+    reader->has_pending = false;
+    reader->chunk = -1;
+    reader->remaining = 0;
+    if (reader->chunk_count == 0)
+    {
+        return true;
+    }
+    if (!load_chunk_(reader, chunk))
+    {
+        return false;
+    }
+    while (peek_(reader) && reader->pending.tick < tick)
+    {
+        reader->has_pending = false;
+    }
+    return true;
+}
+
+void snake_replay_reader_start(SnakeReplayReader *reader, SnakeContext *ctx)
+{
+    snake_initialize_seeded(ctx, reader->seed);
+    reader->tick = 0;
+    snake_replay_reader_seek(reader, 0);
+}
+
+bool snake_replay_reader_step(SnakeReplayReader *reader, SnakeContext *ctx)
+{
+    if (reader->tick >= reader->ticks)
+    {
+        return false;
+    }
+    while (peek_(reader) && reader->pending.tick <= reader->tick)
+    {
+        snake_redir(ctx, (SnakeDirection)reader->pending.dir);
+        reader->has_pending = false;
+    }
+    snake_step(ctx);
+    ++reader->tick;
+    return true;
+}
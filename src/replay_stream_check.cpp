@@ -0,0 +1,187 @@
+/*
+ * 流式回放检查
+ * 录制一段很长的随机对局（后台线程分块压缩写入），再从文件按需解压播放，
+ * 最终状态必须与录制时逐字节一致；随机定位到若干 tick，读到的输入必须与录制的一致
+ */
+
+#include "headless.h"
+#include "batch.h"
+#include "lz.h"
+#include "replay_stream.h"
+
+#define STREAM_CHECK_DEFAULT_PATH "stream_check.snks"
+#define STREAM_CHECK_TICKS 4000000U /* 录制长度 */
+#define STREAM_CHECK_SEEKS 64       /* 随机定位次数 */
+#define STREAM_CHECK_CODEC_SIZE 4096
+
+/* 用几种典型数据检查编解码往返：全零、重复短模式、随机字节 */
+static bool check_codec_(void)
+{
+    static Uint8 src[STREAM_CHECK_CODEC_SIZE];
+    static Uint8 packed[SNAKE_LZ_BOUND(STREAM_CHECK_CODEC_SIZE)];
+    static Uint8 out[STREAM_CHECK_CODEC_SIZE];
+    Uint64 rng = 0xC0DEC;
+    int pattern;
+    int size;
+    int i;
+
+    for (pattern = 0; pattern < 3; pattern++)
+    {
+        for (i = 0; i < STREAM_CHECK_CODEC_SIZE; i++)
+        {
+            src[i] = pattern == 0 ? 0 : pattern == 1 ? (Uint8)("snake"[i % 5]) : (Uint8)SDL_rand_r(&rng, 256);
+        }
+        /* 各种长度，包括不足一个匹配的短数据 */
+        for (size = 0; size <= STREAM_CHECK_CODEC_SIZE; size = size < 16 ? size + 1 : size * 2)
+        {
+            const int packed_size = snake_lz_compress(src, size, packed, (int)sizeof(packed));
+            if ((size > 0 && packed_size == 0) ||
+                snake_lz_decompress(packed, packed_size, out, STREAM_CHECK_CODEC_SIZE) != size ||
+                SDL_memcmp(src, out, size) != 0)
+            {
+                SDL_LogError(SDL_LOG_CATEGORY_TEST, "stream-check: codec round trip failed (pattern %d, %d bytes)", pattern, size);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+SDL_AppResult snake_stream_check(int argc, char *argv[])
+{
+    const char *path = STREAM_CHECK_DEFAULT_PATH;
+    const Uint64 seed = 0x50AC;
+    SnakeReplayWriter *writer = NULL;
+    SnakeReplayReader *reader = NULL;
+    SnakeReplayWriterStats stats;
+    SnakeReplayInput input;
+    SnakeContext *recorded = NULL;
+    SnakeContext *played = NULL;
+    Uint32 *input_ticks = NULL;
+    Uint32 input_count = 0;
+    Uint64 rng = seed;
+    Uint64 start;
+    Uint32 tick;
+    bool ok = false;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (SDL_strcmp(argv[i], "--replay-path") == 0 && i + 1 < argc)
+        {
+            path = argv[++i];
+        }
+    }
+
+    if (!check_codec_())
+    {
+        return SDL_APP_FAILURE;
+    }
+
+    recorded = (SnakeContext *)SDL_aligned_alloc(SNAKE_CACHE_LINE, sizeof(SnakeContext));
+    played = (SnakeContext *)SDL_aligned_alloc(SNAKE_CACHE_LINE, sizeof(SnakeContext));
+    input_ticks = (Uint32 *)SDL_malloc(STREAM_CHECK_TICKS * sizeof(Uint32));
+    if (!recorded || !played || !input_ticks)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "stream-check: out of memory");
+        goto done;
+    }
+
+    /* 录制 */
+    writer = snake_replay_writer_open(path, seed);
+    if (!writer)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "stream-check: %s", SDL_GetError());
+        goto done;
+    }
+    start = SDL_GetTicksNS();
+    snake_initialize_seeded(recorded, seed);
+    for (tick = 0; tick < STREAM_CHECK_TICKS; tick++)
+    {
+        Uint8 turn;
+        snake_batch_random_turns(&turn, 1, &rng);
+        if (turn != SNAKE_BATCH_NO_TURN)
+        {
+            const SnakeDirection dir = (SnakeDirection)turn;
+            snake_replay_writer_record(writer, tick, dir);
+            snake_redir(recorded, dir);
+            input_ticks[input_count++] = tick;
+        }
+        snake_step(recorded);
+    }
+    ok = snake_replay_writer_close(writer, STREAM_CHECK_TICKS, &stats);
+    writer = NULL;
+    if (!ok)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "stream-check: writing %s failed", path);
+        goto done;
+    }
+    SDL_Log("stream-check: recorded %u ticks, %u inputs in %.1f ms: %u chunks, %.1f KiB -> %.1f KiB (%.1f%%), %u stalls",
+            STREAM_CHECK_TICKS, stats.inputs, (SDL_GetTicksNS() - start) / 1e6, stats.chunks,
+            stats.raw_bytes / 1024.0, stats.stored_bytes / 1024.0,
+            stats.raw_bytes ? 100.0 * stats.stored_bytes / stats.raw_bytes : 0.0, stats.stalls);
+
+    /* 按需解压播放 */
+    ok = false;
+    reader = snake_replay_reader_open(path);
+    if (!reader)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "stream-check: %s", SDL_GetError());
+        goto done;
+    }
+    start = SDL_GetTicksNS();
+    snake_replay_reader_start(reader, played);
+    while (snake_replay_reader_step(reader, played))
+    {
+    }
+    if (SDL_memcmp(recorded, played, sizeof(SnakeContext)) != 0)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "stream-check: playback diverged from the recorded game");
+        goto done;
+    }
+    SDL_Log("stream-check: played back %u ticks in %.1f ms", snake_replay_reader_ticks(reader),
+            (SDL_GetTicksNS() - start) / 1e6);
+
+    /* 随机定位：第一条 tick 不小于目标的输入 */
+    start = SDL_GetTicksNS();
+    for (i = 0; i < STREAM_CHECK_SEEKS; i++)
+    {
+        const Uint32 target = (Uint32)SDL_rand_r(&rng, (Sint32)STREAM_CHECK_TICKS);
+        Uint32 lo = 0;
+        Uint32 hi = input_count;
+        while (lo < hi)
+        {
+            const Uint32 mid = (lo + hi) / 2;
+            if (input_ticks[mid] < target)
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        if (!snake_replay_reader_seek(reader, target) ||
+            snake_replay_reader_next(reader, &input) != (lo < input_count) ||
+            (lo < input_count && input.tick != input_ticks[lo]))
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_TEST, "stream-check: seeking to tick %u returned the wrong input", target);
+            goto done;
+        }
+    }
+    SDL_Log("stream-check: %d seeks avg %.3f ms", STREAM_CHECK_SEEKS,
+            (SDL_GetTicksNS() - start) / 1e6 / STREAM_CHECK_SEEKS);
+    ok = true;
+
+done:
+    snake_replay_reader_close(reader);
+    if (writer)
+    {
+        snake_replay_writer_close(writer, 0, NULL);
+    }
+    SDL_RemovePath(path);
+    SDL_free(input_ticks);
+    SDL_aligned_free(played);
+    SDL_aligned_free(recorded);
+    return ok ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+}
@@ -0,0 +1,222 @@
+/*
+ * 协程脚本实现
+ * 包括协程帧内存池、按 tick 恢复的调度器和内置脚本
+ */
+
+#include "script.h"
+
+#define SNAKE_SCRIPT_FRAME_COUNT SNAKE_SCRIPT_MAX_TASKS /* 内存池中的协程帧数量 */
+
+/* 协程帧内存块，空闲时串成单链表 */
+typedef union ScriptFrame
+{
+    union ScriptFrame *next;
+    alignas(16) unsigned char bytes[SNAKE_SCRIPT_FRAME_SIZE];
+} ScriptFrame;
+
+static ScriptFrame frame_pool[SNAKE_SCRIPT_FRAME_COUNT]; /* 协程帧内存池 */
+static ScriptFrame *frame_free_list;                     /* 空闲协程帧链表 */
+static bool frame_pool_ready;                            /* 内存池是否已初始化 */
+
+/* 初始化协程帧内存池 */
+static void frame_pool_init_(void)
+{
+    int i;
+    frame_free_list = NULL;
+    for (i = SNAKE_SCRIPT_FRAME_COUNT - 1; i >= 0; i--)
+    {
+        frame_pool[i].next = frame_free_list;
+        frame_free_list = &frame_pool[i];
+    }
+    frame_pool_ready = true;
+}
+
+void *SnakeScript::promise_type::operator new(size_t size) noexcept
+{
+    ScriptFrame *frame;
+    if (!frame_pool_ready)
+    {
+        frame_pool_init_();
+    }
+    if (size > sizeof(ScriptFrame) || !frame_free_list)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "script: cannot allocate %u byte frame", (unsigned)size);
+        return NULL;
+    }
+    frame = frame_free_list;
+    frame_free_list = frame->next;
+    return frame;
+}
+
+void SnakeScript::promise_type::operator delete(void *ptr, size_t size) noexcept
+{
+    ScriptFrame *frame = (ScriptFrame *)ptr;
+    (void)size;
+    frame->next = frame_free_list;
+    frame_free_list = frame;
+}
+
+void SnakeWaitTicks::await_suspend(std::coroutine_handle<SnakeScript::promise_type> h) const noexcept
+{
+    SnakeScript::promise_type &promise = h.promise();
+    promise.wake_tick = promise.sched->tick + ticks;
+}
+
+void snake_script_init(SnakeScriptScheduler *sched, SnakeContext *ctx)
+{
+    int i;
+    for (i = 0; i < SNAKE_SCRIPT_MAX_TASKS; i++)
+    {
+        sched->tasks[i] = nullptr;
+    }
+    sched->task_count = 0;
+    sched->tick = 0;
+    sched->ctx = ctx;
+    sched->text[0] = '\0';
+    sched->text_until_tick = 0;
+}
+
+bool snake_script_start(SnakeScriptScheduler *sched, SnakeScript script)
+{
+    if (!script.handle)
+    {
+        return false;
+    }
+    if (sched->task_count >= SNAKE_SCRIPT_MAX_TASKS)
+    {
+        script.handle.destroy();
+        return false;
+    }
+    /* 脚本在下一次 snake_script_tick 时开始执行 */
+    script.handle.promise().sched = sched;
+    script.handle.promise().wake_tick = sched->tick;
+    sched->tasks[sched->task_count++] = script.handle;
+    return true;
+}
+
+void snake_script_tick(SnakeScriptScheduler *sched)
+{
+    int i = 0;
+    while (i < sched->task_count)
+    {
+        std::coroutine_handle<SnakeScript::promise_type> task = sched->tasks[i];
+        if (task.promise().wake_tick <= sched->tick)
+        {
+            task.resume();
+        }
+        if (task.done())
+        {
+            /* 用最后一个脚本填补空位，保持数组紧凑 */
+            task.destroy();
+            sched->tasks[i] = sched->tasks[--sched->task_count];
+            sched->tasks[sched->task_count] = nullptr;
+            continue;
+        }
+        ++i;
+    }
+    ++sched->tick;
+}
+
+void snake_script_quit(SnakeScriptScheduler *sched)
+{
+    int i;
+    for (i = 0; i < sched->task_count; i++)
+    {
+        sched->tasks[i].destroy();
+        sched->tasks[i] = nullptr;
+    }
+    sched->task_count = 0;
+}
+
+void snake_script_show_text(SnakeScriptScheduler *sched, const char *text, Uint32 ticks)
+{
+    SDL_strlcpy(sched->text, text, sizeof(sched->text));
+    sched->text_until_tick = sched->tick + ticks;
+}
+
+const char *snake_script_text(const SnakeScriptScheduler *sched)
+{
+    if (sched->text[0] == '\0' || sched->tick >= sched->text_until_tick)
+    {
+        return NULL;
+    }
+    return sched->text;
+}
+
+/* 在蛇头前方 distance 格处生成食物（穿墙），lifetime 不为 0 时为限时食物 */
+static bool spawn_food_ahead_(SnakeContext *ctx, int distance, Uint16 lifetime)
+{
+    const SnakePlayer *snake = &ctx->players[0];
+    int x = snake->head_xpos;
+    int y = snake->head_ypos;
+    switch (snake->next_dir)
+    {
+    case SNAKE_DIR_RIGHT:
+        x += distance;
+        break;
+    case SNAKE_DIR_UP:
+        y -= distance;
+        break;
+    case SNAKE_DIR_LEFT:
+        x -= distance;
+        break;
+    case SNAKE_DIR_DOWN:
+        y += distance;
+        break;
+    }
+    x = (x % (int)SNAKE_GAME_WIDTH + SNAKE_GAME_WIDTH) % SNAKE_GAME_WIDTH;
+    y = (y % (int)SNAKE_GAME_HEIGHT + SNAKE_GAME_HEIGHT) % SNAKE_GAME_HEIGHT;
+    if (lifetime > 0)
+    {
+        return snake_spawn_timed_food(ctx, (char)x, (char)y, lifetime);
+    }
+    return snake_spawn_food(ctx, (char)x, (char)y);
+}
+
+/* 新手教程：依次提示操作方式，并在蛇头前方放置食物 */
+static SnakeScript tutorial_script_(SnakeScriptScheduler *sched)
+{
+    snake_script_show_text(sched, "Arrow keys turn the snake", 24);
+    co_await SnakeWaitTicks{24};
+    snake_script_show_text(sched, "Eat the blue food to grow", 24);
+    spawn_food_ahead_(sched->ctx, 4, 0);
+    co_await SnakeWaitTicks{24};
+    snake_script_show_text(sched, "Walls wrap around", 24);
+    co_await SnakeWaitTicks{24};
+    snake_script_show_text(sched, "Do not bite yourself! R resets", 32);
+}
+
+/* 食物雨：每隔一段时间在蛇头前方补充会移动的限时食物 */
+static SnakeScript food_rain_script_(SnakeScriptScheduler *sched)
+{
+    int wave;
+    snake_script_show_text(sched, "Food rain!", 16);
+    for (wave = 0; wave < 16; wave++)
+    {
+        co_await SnakeWaitTicks{16};
+        spawn_food_ahead_(sched->ctx, 3 + wave % 5, 24);
+    }
+    snake_script_show_text(sched, "Rain is over", 16);
+}
+
+/* 内置脚本表 */
+static const struct
+{
+    const char *name;
+    SnakeScriptFunc func;
+} builtin_scripts[] = {
+    {"tutorial", tutorial_script_},
+    {"rain", food_rain_script_}};
+
+bool snake_script_start_named(SnakeScriptScheduler *sched, const char *name)
+{
+    size_t i;
+    for (i = 0; i < SDL_arraysize(builtin_scripts); i++)
+    {
+        if (SDL_strcmp(builtin_scripts[i].name, name) == 0)
+        {
+            return snake_script_start(sched, builtin_scripts[i].func(sched));
+        }
+    }
+    return false;
+}
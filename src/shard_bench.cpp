@@ -0,0 +1,217 @@
+/*
+ * NUMA 分片基准测试
+ * 每个工作线程推进自己的一批游戏，线程按顺序分配到各 NUMA 节点并绑定到节点的 CPU 上；
+ * 比较两种内存放置方式：
+ *   共享：主线程一次分配并初始化所有批次，页面都落在主线程所在的节点上
+ *   本地：工作线程绑定之后自己分配和初始化批次，首次访问使页面落在本节点上
+ * 报告每个节点的吞吐量；用 --pin-cpus 指定 CPU 时按列表把每个线程绑定到一个核心上，代替按节点绑定
+ */
+
+#include "headless.h"
+#include "batch.h"
+#include "numa.h"
+#include "thread_policy.h"
+
+#define SHARD_BENCH_GAMES 8192     /* 每个线程的游戏局数（约 24 MiB，超出 L2） */
+#define SHARD_BENCH_ROUNDS 256     /* 每个线程推进的轮数 */
+#define SHARD_BENCH_SEED 0x5A4D
+#define SHARD_BENCH_MAX_THREADS 256
+
+/* 一个工作线程 */
+typedef struct
+{
+    const SnakeNumaTopology *topo;
+    const SnakeThreadPolicy *policy; /* 命令行指定的绑定和优先级 */
+    int index;              /* 线程序号 */
+    int node;               /* 分配到的节点（拓扑中的下标） */
+    bool local;             /* 是否由工作线程自己分配批次 */
+    SnakeContext *games;    /* 共享放置时由主线程分配的分片 */
+    int count;              /* 游戏局数 */
+    Uint64 seed;            /* 本地放置时第一局的种子 */
+    Uint64 elapsed_ns;      /* 推进耗时 */
+    bool pinned;            /* 是否绑定成功 */
+    bool ok;
+} ShardWorker;
+
+static int SDLCALL shard_worker_(void *data)
+{
+    ShardWorker *worker = (ShardWorker *)data;
+    SnakeContext *games = worker->games;
+    Uint8 *turns;
+    Uint64 rng = worker->seed;
+    int round;
+
+    /* 先绑定再分配，首次访问的页面才会落在本节点上 */
+    if (worker->policy->cpu_count > 0 || worker->policy->set_priority)
+    {
+        worker->pinned = snake_thread_policy_apply(worker->policy, worker->index, "shard") && worker->policy->cpu_count > 0;
+    }
+    if (worker->policy->cpu_count == 0)
+    {
+        worker->pinned = worker->topo->node_count > 1 && snake_numa_pin_thread(worker->topo, worker->node);
+    }
+    if (worker->local)
+    {
+        games = snake_batch_alloc(worker->count, worker->seed);
+    }
+    turns = (Uint8 *)SDL_malloc((size_t)worker->count);
+    if (!games || !turns)
+    {
+        if (worker->local)
+        {
+            snake_batch_free(games);
+        }
+        SDL_free(turns);
+        return 0;
+    }
+
+    for (round = 0; round < SHARD_BENCH_ROUNDS; round++)
+    {
+        Uint64 start;
+        snake_batch_random_turns(turns, worker->count, &rng);
+        start = SDL_GetTicksNS();
+        snake_step_batch_pipelined(games, turns, worker->count, SNAKE_BATCH_PREFETCH_DISTANCE);
+        worker->elapsed_ns += SDL_GetTicksNS() - start;
+    }
+    worker->ok = true;
+
+    if (worker->local)
+    {
+        snake_batch_free(games);
+    }
+    SDL_free(turns);
+    return 0;
+}
+
+/* 运行一种放置方式并报告每个节点的吞吐量 */
+static bool run_(const SnakeNumaTopology *topo, const SnakeThreadPolicy *policy, int threads, int count, bool local)
+{
+    ShardWorker workers[SHARD_BENCH_MAX_THREADS];
+    SDL_Thread *handles[SHARD_BENCH_MAX_THREADS];
+    SnakeContext *shared = NULL;
+    double node_rate[SNAKE_NUMA_MAX_NODES];
+    int node_threads[SNAKE_NUMA_MAX_NODES];
+    double total = 0.0;
+    bool ok = true;
+    int pinned = 0;
+    int w;
+    int n;
+
+    if (!local)
+    {
+        shared = snake_batch_alloc(threads * count, SHARD_BENCH_SEED);
+        if (!shared)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_TEST, "shard-bench: cannot allocate %d games", threads * count);
+            return false;
+        }
+    }
+    SDL_zeroa(workers);
+    for (w = 0; w < threads; w++)
+    {
+        workers[w].topo = topo;
+        workers[w].policy = policy;
+        workers[w].index = w;
+        workers[w].node = w % topo->node_count;
+        workers[w].local = local;
+        workers[w].games = shared ? &shared[w * count] : NULL;
+        workers[w].count = count;
+        workers[w].seed = SHARD_BENCH_SEED + (Uint64)w * count;
+        handles[w] = SDL_CreateThread(shard_worker_, "shard", &workers[w]);
+        if (!handles[w])
+        {
+            workers[w].ok = false;
+            ok = false;
+        }
+    }
+    for (w = 0; w < threads; w++)
+    {
+        SDL_WaitThread(handles[w], NULL);
+        ok = ok && workers[w].ok;
+    }
+    snake_batch_free(shared);
+    if (!ok)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "shard-bench: a worker failed: %s", SDL_GetError());
+        return false;
+    }
+
+    SDL_zeroa(node_rate);
+    SDL_zeroa(node_threads);
+    for (w = 0; w < threads; w++)
+    {
+        const double rate = (double)SHARD_BENCH_ROUNDS * count / (workers[w].elapsed_ns / 1e9);
+        node_rate[workers[w].node] += rate;
+        node_threads[workers[w].node]++;
+        pinned += workers[w].pinned;
+        total += rate;
+    }
+    for (n = 0; n < topo->node_count; n++)
+    {
+        SDL_Log("shard-bench: %s placement, node %d: %d thread(s), %.2f M steps/s", local ? "local" : "shared",
+                topo->node_ids[n], node_threads[n], node_rate[n] / 1e6);
+    }
+    SDL_Log("shard-bench: %s placement total %.2f M steps/s (%d of %d threads pinned)", local ? "local" : "shared",
+            total / 1e6, pinned, threads);
+    return true;
+}
+
+SDL_AppResult snake_shard_bench(int argc, char *argv[])
+{
+    SnakeNumaTopology *topo = (SnakeNumaTopology *)SDL_malloc(sizeof(SnakeNumaTopology));
+    SnakeThreadPolicy policy;
+    int threads = SDL_GetNumLogicalCPUCores();
+    int count = SHARD_BENCH_GAMES;
+    bool valid = true;
+    bool ok = false;
+    int i;
+
+    snake_thread_policy_init(&policy);
+    for (i = 1; i < argc; i++)
+    {
+        if (SDL_strcmp(argv[i], "--pin-cpus") == 0 && i + 1 < argc)
+        {
+            valid = snake_thread_policy_set(&policy, "cpus", argv[++i]) && valid;
+        }
+        else if (SDL_strcmp(argv[i], "--priority") == 0 && i + 1 < argc)
+        {
+            valid = snake_thread_policy_set(&policy, "priority", argv[++i]) && valid;
+        }
+        else if (SDL_strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            threads = SDL_atoi(argv[++i]);
+        }
+        else if (SDL_strcmp(argv[i], "--shard-games") == 0 && i + 1 < argc)
+        {
+            count = SDL_atoi(argv[++i]);
+        }
+    }
+    threads = SDL_clamp(threads, 1, SHARD_BENCH_MAX_THREADS);
+    count = SDL_max(count, 1);
+    if (!topo)
+    {
+        return SDL_APP_FAILURE;
+    }
+    if (!valid)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "shard-bench: invalid --pin-cpus or --priority");
+        SDL_free(topo);
+        return SDL_APP_FAILURE;
+    }
+
+    snake_numa_detect(topo);
+    SDL_Log("shard-bench: %d NUMA node(s), %d thread(s) x %d games (%.1f MiB each)", topo->node_count, threads, count,
+            (double)count * sizeof(SnakeContext) / (1024.0 * 1024.0));
+    if (topo->node_count == 1)
+    {
+        /* 单节点时两种放置方式没有区别，也不需要按节点绑定 */
+        SDL_Log("shard-bench: single node, running local placement only");
+        ok = run_(topo, &policy, threads, count, true);
+    }
+    else
+    {
+        ok = run_(topo, &policy, threads, count, false) && run_(topo, &policy, threads, count, true);
+    }
+    SDL_free(topo);
+    return ok ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+}
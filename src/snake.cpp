@@ -0,0 +1,619 @@
+/*
+ * 贪吃蛇游戏核心逻辑实现
+ * 本代码采用高效的内存表示方式，使用位操作来存储游戏状态
+ */
+
+#include "snake.h"
+#include "entity.h"
+
+#define SNAKE_PICKUP_CHANCE 8    /* 吃到食物后生成拾取物的概率为 1/8 */
+#define SNAKE_PICKUP_VALUE 5     /* 拾取物分值 */
+#define SNAKE_FOOD_VALUE 1       /* 普通食物分值 */
+#define SNAKE_EAT_EFFECT_TICKS 4 /* 吃到东西时特效持续的 tick 数 */
+#define SNAKE_TIMED_FOOD_CHANCE 4 /* 新食物为限时食物的概率为 1/4 */
+#define SNAKE_FOOD_LIFETIME 64   /* 限时食物在原地停留的 tick 数 */
+#define SNAKE_PICKUP_LIFETIME 48 /* 拾取物存在的 tick 数 */
+#define ROW_MASK ((1U << SNAKE_GAME_WIDTH) - 1U) /* 一行占用位图的有效位 */
+
+/* 单人模式每个 tick 访问的计数器和玩家1的蛇都在第一条缓存行中 */
+SDL_COMPILE_TIME_ASSERT(hot_fields_in_first_line, offsetof(SnakeContext, players) + sizeof(SnakePlayer) <= SNAKE_CACHE_LINE);
+
+/* 获取指定位置的单元格状态
+ * 使用位操作从压缩存储中提取单元格信息
+ */
+SnakeCell snake_cell_at(const SnakeContext *ctx, char x, char y)
+{
+    const int shift = SHIFT(x, y);
+    unsigned short range;
+    SDL_memcpy(&range, ctx->cells + (shift / 8), sizeof(range));
+    return (SnakeCell)((range >> (shift % 8)) & THREE_BITS);
+}
+
+/* 设置指定位置的单元格状态
+ * 使用位操作更新压缩存储中的单元格信息
+ */
+static void put_cell_at_(SnakeContext *ctx, char x, char y, SnakeCell ct)
+{
+    const int shift = SHIFT(x, y);
+    const int adjust = shift % 8;
+    unsigned char *const pos = ctx->cells + (shift / 8);
+    unsigned short range;
+    SDL_memcpy(&range, pos, sizeof(range));
+    /* 空/非空发生变化时同步行占用位图 */
+    if ((((range >> adjust) & THREE_BITS) == SNAKE_CELL_NOTHING) != (ct == SNAKE_CELL_NOTHING))
+    {
+        ctx->occupied_rows[(int)y] ^= 1U << x;
+        ctx->free_cells += (ct == SNAKE_CELL_NOTHING) ? 1 : -1;
+    }
+    range &= ~(THREE_BITS << adjust); /* 清除原有状态 */
+    range |= (ct & THREE_BITS) << adjust; /* 设置新状态 */
+    SDL_memcpy(pos, &range, sizeof(range));
+}
+
+/* 统计32位整数中为1的位数 */
+static int popcount32_(Uint32 v)
+{
+    v = v - ((v >> 1) & 0x55555555U);
+    v = (v & 0x33333333U) + ((v >> 2) & 0x33333333U);
+    return (int)((((v + (v >> 4)) & 0x0F0F0F0FU) * 0x01010101U) >> 24);
+}
+
+/* 检查游戏场地是否已满 */
+static int are_cells_full_(SnakeContext *ctx)
+{
+    return ctx->occupied_cells == SNAKE_GAME_WIDTH * SNAKE_GAME_HEIGHT;
+}
+
+/* 随机选择一个空闲格子
+ * 在空格子总数内取一个随机序号，再借助行占用位图定位：
+ * 逐行用 popcount 跳过整行，最后在目标行内找到对应的空位，
+ * 只消耗一个随机数，耗时与蛇身长度和场地占用率无关；没有空格子时返回 false
+ */
+static bool pick_free_cell_(SnakeContext *ctx, char *x, char *y)
+{
+    int n;
+    int row;
+    Uint32 free_bits;
+
+    if (ctx->free_cells == 0)
+    {
+        return false;
+    }
+    n = SDL_rand_r(&ctx->rng_state, ctx->free_cells);
+    for (row = 0;; row++)
+    {
+        free_bits = ~ctx->occupied_rows[row] & ROW_MASK;
+        const int row_free = popcount32_(free_bits);
+        if (n < row_free)
+        {
+            break;
+        }
+        n -= row_free;
+    }
+    /* 清除低位的 n 个空位，剩下的最低位就是目标格子 */
+    while (n-- > 0)
+    {
+        free_bits &= free_bits - 1;
+    }
+    *x = (char)SDL_MostSignificantBitIndex32(free_bits & (~free_bits + 1));
+    *y = (char)row;
+    return true;
+}
+
+/* 在指定空格子上放置可拾取的实体（食物或拾取物）
+ * lifetime 不为 0 时登记到期时间
+ */
+static bool place_item_(SnakeContext *ctx, SnakeEntityKind kind, char x, char y, Uint8 value, Uint16 lifetime)
+{
+    const SnakeEntity item = snake_entity_create(&ctx->entities, kind, x, y, value);
+    if (item == SNAKE_ENTITY_INVALID)
+    {
+        return false;
+    }
+    snake_entity_set_lifetime(&ctx->entities, item, lifetime, ctx->tick);
+    put_cell_at_(ctx, x, y, SNAKE_CELL_FOOD);
+    return true;
+}
+
+/* 在空闲位置生成新的食物，其中一部分是限时食物
+ * 没有空格子或食物数量已达上限时返回 false
+ */
+static bool new_food_pos_(SnakeContext *ctx)
+{
+    Uint16 lifetime = 0;
+    char x;
+    char y;
+    if (!pick_free_cell_(ctx, &x, &y))
+    {
+        return false;
+    }
+    if (SDL_rand_r(&ctx->rng_state, SNAKE_TIMED_FOOD_CHANCE) == 0)
+    {
+        lifetime = SNAKE_FOOD_LIFETIME;
+    }
+    return place_item_(ctx, SNAKE_ENTITY_FOOD, x, y, SNAKE_FOOD_VALUE, lifetime);
+}
+
+/* 处理所有已到期的实体
+ * 到期堆只返回当前 tick 到期的实体，不需要遍历全部食物：
+ * 限时食物移动到新的随机空格子并重新计时，拾取物直接消失
+ */
+static void expire_items_(SnakeContext *ctx)
+{
+    SnakeEntity item;
+    char x;
+    char y;
+    char new_x;
+    char new_y;
+
+    while ((item = snake_entities_pop_expired(&ctx->entities, ctx->tick)) != SNAKE_ENTITY_INVALID)
+    {
+        snake_entity_position(&ctx->entities, item, &x, &y);
+        if (snake_entity_kind(&ctx->entities, item) == SNAKE_ENTITY_PICKUP)
+        {
+            put_cell_at_(ctx, x, y, SNAKE_CELL_NOTHING);
+            snake_entity_destroy(&ctx->entities, item);
+            --ctx->occupied_cells;
+            continue;
+        }
+        if (pick_free_cell_(ctx, &new_x, &new_y))
+        {
+            put_cell_at_(ctx, x, y, SNAKE_CELL_NOTHING);
+            put_cell_at_(ctx, new_x, new_y, SNAKE_CELL_FOOD);
+            snake_entity_move(&ctx->entities, item, new_x, new_y);
+        }
+        snake_entity_set_lifetime(&ctx->entities, item, snake_entity_lifetime(&ctx->entities, item), ctx->tick);
+    }
+}
+
+/* 在玩家的出生点放置长度为1的蛇（之后增长到4格）
+ * 玩家按行均匀分布在场地中线上，偶数号向右、奇数号向左；单人时位于场地中心
+ * 出生点被占用时返回 false，蛇保持不在场上的状态
+ */
+static bool spawn_player_(SnakeContext *ctx, int player)
+{
+    SnakePlayer *const snake = &ctx->players[player];
+    const char x = SNAKE_GAME_WIDTH / 2;
+    const char y = (char)(SNAKE_GAME_HEIGHT * (2 * player + 1) / (2 * ctx->player_count));
+    const SnakeDirection dir = (player % 2 == 0) ? SNAKE_DIR_RIGHT : SNAKE_DIR_LEFT;
+
+    if (snake_cell_at(ctx, x, y) != SNAKE_CELL_NOTHING)
+    {
+        return false;
+    }
+    snake->head_xpos = snake->tail_xpos = x;
+    snake->head_ypos = snake->tail_ypos = y;
+    snake->next_dir = dir;
+    snake->inhibit_tail_step = 4;
+    snake->alive = true;
+    ctx->occupied_cells += 4;
+    put_cell_at_(ctx, x, y, (SnakeCell)(dir + 1));
+    ctx->owner[x + y * SNAKE_GAME_WIDTH] = (Uint8)player;
+    return true;
+}
+
+/* 从场地上移除一条蛇（多人模式下蛇死亡时）
+ * 从蛇尾沿格子中记录的方向走到蛇头，逐格清空
+ */
+static void remove_player_(SnakeContext *ctx, int player)
+{
+    SnakePlayer *const snake = &ctx->players[player];
+    char x = snake->tail_xpos;
+    char y = snake->tail_ypos;
+    unsigned removed = 0;
+
+    while (removed < SNAKE_MATRIX_SIZE)
+    {
+        const SnakeCell ct = snake_cell_at(ctx, x, y);
+        put_cell_at_(ctx, x, y, SNAKE_CELL_NOTHING);
+        ++removed;
+        if (x == snake->head_xpos && y == snake->head_ypos)
+        {
+            break;
+        }
+        switch (ct)
+        {
+        case SNAKE_CELL_SRIGHT:
+            ++x;
+            break;
+        case SNAKE_CELL_SUP:
+            --y;
+            break;
+        case SNAKE_CELL_SLEFT:
+            --x;
+            break;
+        case SNAKE_CELL_SDOWN:
+            ++y;
+            break;
+        default:
+            break;
+        }
+        x = (char)((x + SNAKE_GAME_WIDTH) % SNAKE_GAME_WIDTH);
+        y = (char)((y + SNAKE_GAME_HEIGHT) % SNAKE_GAME_HEIGHT);
+    }
+    /* 占用计数按蛇的最终长度（当前格数加上尚未完成的增长）计算；
+     * 本 tick 的蛇尾已经前进，而新的蛇头没有放下，因此还要多减去这一格 */
+    ctx->occupied_cells -= removed + snake->inhibit_tail_step;
+    snake->alive = false;
+}
+
+/* 游戏初始化函数
+ * 设置各条蛇的初始状态和位置，生成初始食物
+ */
+void snake_initialize(SnakeContext *ctx)
+{
+    int i;
+    SDL_zeroa(ctx->cells);
+    SDL_zeroa(ctx->occupied_rows);
+    ctx->free_cells = SNAKE_MATRIX_SIZE;
+    snake_entities_clear(&ctx->entities);
+    ctx->tick = 0;
+    ctx->occupied_cells = 0;
+    for (i = 0; i < ctx->player_count; i++)
+    {
+        ctx->players[i].score = 0;
+        spawn_player_(ctx, i);
+    }
+    --ctx->occupied_cells;
+    /* 生成初始食物：单人4个，每多一个玩家多1个 */
+    for (i = 0; i < 3 + ctx->player_count; i++)
+    {
+        if (new_food_pos_(ctx))
+        {
+            ++ctx->occupied_cells;
+        }
+    }
+}
+
+/* 使用指定随机种子初始化游戏
+ * 相同的种子和相同的输入序列会得到完全相同的游戏过程
+ */
+void snake_initialize_seeded(SnakeContext *ctx, Uint64 seed)
+{
+    SDL_zerop(ctx); /* 实体句柄代数等字段也从确定的初始值开始 */
+    ctx->rng_state = seed;
+    ctx->player_count = 1;
+    snake_initialize(ctx);
+}
+
+void snake_set_player_count(SnakeContext *ctx, int count)
+{
+    ctx->player_count = SDL_clamp(count, 1, SNAKE_MAX_PLAYERS);
+    snake_initialize(ctx);
+}
+
+/* 在指定位置生成食物
+ * 供脚本等外部逻辑使用，只能放在空格子上
+ */
+bool snake_spawn_food(SnakeContext *ctx, char x, char y)
+{
+    if (x < 0 || x >= (char)SNAKE_GAME_WIDTH || y < 0 || y >= (char)SNAKE_GAME_HEIGHT ||
+        snake_cell_at(ctx, x, y) != SNAKE_CELL_NOTHING || are_cells_full_(ctx) ||
+        !place_item_(ctx, SNAKE_ENTITY_FOOD, x, y, SNAKE_FOOD_VALUE, 0))
+    {
+        return false;
+    }
+    ++ctx->occupied_cells;
+    return true;
+}
+
+/* 在指定位置生成限时食物 */
+bool snake_spawn_timed_food(SnakeContext *ctx, char x, char y, Uint16 lifetime)
+{
+    if (x < 0 || x >= (char)SNAKE_GAME_WIDTH || y < 0 || y >= (char)SNAKE_GAME_HEIGHT ||
+        snake_cell_at(ctx, x, y) != SNAKE_CELL_NOTHING || are_cells_full_(ctx) ||
+        !place_item_(ctx, SNAKE_ENTITY_FOOD, x, y, SNAKE_FOOD_VALUE, lifetime))
+    {
+        return false;
+    }
+    ++ctx->occupied_cells;
+    return true;
+}
+
+/* 在指定位置生成拾取物 */
+bool snake_spawn_pickup(SnakeContext *ctx, char x, char y, Uint8 value)
+{
+    if (x < 0 || x >= (char)SNAKE_GAME_WIDTH || y < 0 || y >= (char)SNAKE_GAME_HEIGHT ||
+        snake_cell_at(ctx, x, y) != SNAKE_CELL_NOTHING || are_cells_full_(ctx) ||
+        !place_item_(ctx, SNAKE_ENTITY_PICKUP, x, y, value, 0))
+    {
+        return false;
+    }
+    ++ctx->occupied_cells;
+    return true;
+}
+
+/* 改变蛇的移动方向
+ * 检查是否允许改变方向（不允许180度转弯）
+ */
+void snake_redir(SnakeContext *ctx, SnakeDirection dir)
+{
+    snake_player_redir(ctx, 0, dir);
+}
+
+void snake_player_redir(SnakeContext *ctx, int player, SnakeDirection dir)
+{
+    SnakePlayer *snake;
+    SnakeCell ct;
+    if (player < 0 || player >= ctx->player_count)
+    {
+        return;
+    }
+    snake = &ctx->players[player];
+    if (dir == snake->next_dir || !snake->alive)
+    {
+        return; /* 方向不变，不需要解码蛇头格子 */
+    }
+    ct = snake_cell_at(ctx, snake->head_xpos, snake->head_ypos);
+    /* 检查是否允许改变方向（不允许180度转弯） */
+    if ((dir == SNAKE_DIR_RIGHT && ct != SNAKE_CELL_SLEFT) ||
+        (dir == SNAKE_DIR_UP && ct != SNAKE_CELL_SDOWN) ||
+        (dir == SNAKE_DIR_LEFT && ct != SNAKE_CELL_SRIGHT) ||
+        (dir == SNAKE_DIR_DOWN && ct != SNAKE_CELL_SUP))
+    {
+        snake->next_dir = dir;
+    }
+}
+
+/* 处理坐标环绕（穿墙）
+ * 当坐标超出边界时进行环绕处理
+ */
+static void wrap_around_(char *val, char max)
+{
+    if (*val < 0)
+    {
+        *val = max - 1;
+    }
+    else if (*val > max - 1)
+    {
+        *val = 0;
+    }
+}
+
+/* 吃掉蛇头位置的食物或拾取物
+ * 食物：蛇身增长并补充新食物，有一定概率额外生成拾取物
+ * 拾取物：只加分，被吃掉后不补充
+ * 场地占满时重置游戏并返回 false
+ */
+static bool eat_item_(SnakeContext *ctx, SnakePlayer *snake)
+{
+    const SnakeEntity item = snake_entity_at(&ctx->entities, snake->head_xpos, snake->head_ypos);
+    const SnakeEntityKind kind = snake_entity_kind(&ctx->entities, item);
+    char x;
+    char y;
+
+    snake->score += snake_entity_value(&ctx->entities, item);
+    snake_entity_destroy(&ctx->entities, item);
+    snake_entity_create(&ctx->entities, SNAKE_ENTITY_EFFECT, snake->head_xpos, snake->head_ypos, SNAKE_EAT_EFFECT_TICKS);
+    ctx->events |= (kind == SNAKE_ENTITY_PICKUP) ? SNAKE_EVENT_PICKUP : SNAKE_EVENT_ATE;
+    if (kind == SNAKE_ENTITY_PICKUP)
+    {
+        --ctx->occupied_cells; /* 拾取物的格子变为蛇头，蛇身长度不变 */
+        return true;
+    }
+    if (are_cells_full_(ctx))
+    {
+        snake_initialize(ctx); /* 游戏胜利，重置游戏 */
+        ctx->events |= SNAKE_EVENT_WON;
+        return false;
+    }
+    if (new_food_pos_(ctx))        /* 生成新的食物 */
+    {
+        ++ctx->occupied_cells;
+    }
+    ++snake->inhibit_tail_step;    /* 延迟蛇尾移动，实现蛇身增长 */
+    if (SDL_rand_r(&ctx->rng_state, SNAKE_PICKUP_CHANCE) == 0 &&
+        ctx->occupied_cells + 1 < SNAKE_MATRIX_SIZE &&
+        pick_free_cell_(ctx, &x, &y) &&
+        place_item_(ctx, SNAKE_ENTITY_PICKUP, x, y, SNAKE_PICKUP_VALUE, SNAKE_PICKUP_LIFETIME))
+    {
+        ++ctx->occupied_cells;
+    }
+    return true;
+}
+
+/* 更新一条蛇：移动蛇尾和蛇头，处理碰撞和进食
+ * 游戏被重置（单人模式死亡或场地占满）时返回 false
+ */
+static bool step_player_(SnakeContext *ctx, int player)
+{
+    SnakePlayer *const snake = &ctx->players[player];
+    const SnakeCell dir_as_cell = (SnakeCell)(snake->next_dir + 1);
+    SnakeCell ct;
+    char prev_xpos;
+    char prev_ypos;
+    /* 不在场上的蛇等待出生点空出后复活 */
+    if (!snake->alive)
+    {
+        spawn_player_(ctx, player);
+        return true;
+    }
+    /* 移动蛇尾 */
+    if (--snake->inhibit_tail_step == 0)
+    {
+        ++snake->inhibit_tail_step;
+        ct = snake_cell_at(ctx, snake->tail_xpos, snake->tail_ypos);
+        put_cell_at_(ctx, snake->tail_xpos, snake->tail_ypos, SNAKE_CELL_NOTHING);
+        switch (ct)
+        {
+        case SNAKE_CELL_SRIGHT:
+            snake->tail_xpos++;
+            break;
+        case SNAKE_CELL_SUP:
+            snake->tail_ypos--;
+            break;
+        case SNAKE_CELL_SLEFT:
+            snake->tail_xpos--;
+            break;
+        case SNAKE_CELL_SDOWN:
+            snake->tail_ypos++;
+            break;
+        default:
+            break;
+        }
+        wrap_around_(&snake->tail_xpos, SNAKE_GAME_WIDTH);
+        wrap_around_(&snake->tail_ypos, SNAKE_GAME_HEIGHT);
+    }
+    /* 移动蛇头 */
+    prev_xpos = snake->head_xpos;
+    prev_ypos = snake->head_ypos;
+    switch (snake->next_dir)
+    {
+    case SNAKE_DIR_RIGHT:
+        ++snake->head_xpos;
+        break;
+    case SNAKE_DIR_UP:
+        --snake->head_ypos;
+        break;
+    case SNAKE_DIR_LEFT:
+        --snake->head_xpos;
+        break;
+    case SNAKE_DIR_DOWN:
+        ++snake->head_ypos;
+        break;
+    }
+    wrap_around_(&snake->head_xpos, SNAKE_GAME_WIDTH);
+    wrap_around_(&snake->head_ypos, SNAKE_GAME_HEIGHT);
+    /* 碰撞检测 */
+    ct = snake_cell_at(ctx, snake->head_xpos, snake->head_ypos);
+    if (ct != SNAKE_CELL_NOTHING && ct != SNAKE_CELL_FOOD)
+    {
+        if (ctx->player_count == 1)
+        {
+            snake_initialize(ctx); /* 碰到蛇身，游戏重置 */
+            ctx->events = SNAKE_EVENT_DIED;
+            return false;
+        }
+        /* 多人模式：只移除撞上的蛇，其他玩家继续 */
+        snake->head_xpos = prev_xpos;
+        snake->head_ypos = prev_ypos;
+        remove_player_(ctx, player);
+        snake->score = 0;
+        ctx->events |= SNAKE_EVENT_DIED;
+        return true;
+    }
+    if (snake_cell_at(ctx, prev_xpos, prev_ypos) != dir_as_cell)
+    {
+        ctx->events |= SNAKE_EVENT_TURNED;
+    }
+    put_cell_at_(ctx, prev_xpos, prev_ypos, dir_as_cell);
+    put_cell_at_(ctx, snake->head_xpos, snake->head_ypos, dir_as_cell);
+    ctx->owner[snake->head_xpos + snake->head_ypos * SNAKE_GAME_WIDTH] = (Uint8)player;
+    if (ct == SNAKE_CELL_FOOD)
+    {
+        return eat_item_(ctx, snake);
+    }
+    return true;
+}
+
+/* 更新所有蛇的状态
+ * 按玩家顺序依次移动，先移动的蛇占据的格子对后移动的蛇立即生效
+ */
+void snake_step(SnakeContext *ctx)
+{
+    int i;
+    /* 推进特效计时，处理到期的食物和拾取物 */
+    ctx->events = 0;
+    ++ctx->tick;
+    snake_entities_tick(&ctx->entities);
+    expire_items_(ctx);
+    for (i = 0; i < ctx->player_count; i++)
+    {
+        if (!step_player_(ctx, i))
+        {
+            return;
+        }
+    }
+}
+
+#define CHECKSUM_FNV_OFFSET 0x811C9DC5U
+#define CHECKSUM_FNV_PRIME 0x01000193U
+
+/* FNV-1a：把 size 字节合并到 hash 中 */
+static Uint32 checksum_bytes_(Uint32 hash, const void *data, size_t size)
+{
+    const Uint8 *p = (const Uint8 *)data;
+    size_t i;
+    for (i = 0; i < size; i++)
+    {
+        hash = (hash ^ p[i]) * CHECKSUM_FNV_PRIME;
+    }
+    return hash;
+}
+
+/* 合并实体存储：按稠密下标逐个组件合并，再合并到期堆
+ * 只合并有效的元素；句柄表和格子交叉引用只是组件的索引，不参与计算（句柄代数通过到期堆中的句柄覆盖）
+ */
+static Uint32 checksum_entities_(Uint32 hash, const SnakeEntities *e)
+{
+    int i;
+    hash = checksum_bytes_(hash, e->count, sizeof(e->count));
+    for (i = 0; i < e->count[SNAKE_ENTITY_FOOD]; i++)
+    {
+        const Uint8 food[3] = {e->food_x[i], e->food_y[i], e->food_value[i]};
+        hash = checksum_bytes_(hash, food, sizeof(food));
+        hash = checksum_bytes_(hash, &e->food_lifetime[i], sizeof(e->food_lifetime[i]));
+    }
+    for (i = 0; i < e->count[SNAKE_ENTITY_PICKUP]; i++)
+    {
+        const Uint8 pickup[3] = {e->pickup_x[i], e->pickup_y[i], e->pickup_value[i]};
+        hash = checksum_bytes_(hash, pickup, sizeof(pickup));
+        hash = checksum_bytes_(hash, &e->pickup_lifetime[i], sizeof(e->pickup_lifetime[i]));
+    }
+    for (i = 0; i < e->count[SNAKE_ENTITY_EFFECT]; i++)
+    {
+        const Uint8 effect[3] = {e->effect_x[i], e->effect_y[i], e->effect_ticks_left[i]};
+        hash = checksum_bytes_(hash, effect, sizeof(effect));
+    }
+    hash = checksum_bytes_(hash, &e->expiry_count, sizeof(e->expiry_count));
+    for (i = 0; i < e->expiry_count; i++)
+    {
+        hash = checksum_bytes_(hash, &e->expiry[i].due_tick, sizeof(e->expiry[i].due_tick));
+        hash = checksum_bytes_(hash, &e->expiry[i].entity, sizeof(e->expiry[i].entity));
+    }
+    return hash;
+}
+
+Uint32 snake_checksum(const SnakeContext *ctx)
+{
+    Uint32 hash = checksum_bytes_(CHECKSUM_FNV_OFFSET, ctx->cells, sizeof(ctx->cells));
+    int row;
+    int i;
+    /* 逐个字段合并，不受结构体填充字节影响 */
+    for (i = 0; i < ctx->player_count; i++)
+    {
+        const SnakePlayer *snake = &ctx->players[i];
+        const char position[6] = {snake->head_xpos, snake->head_ypos, snake->tail_xpos, snake->tail_ypos,
+                                  snake->next_dir, snake->inhibit_tail_step};
+        hash = checksum_bytes_(hash, position, sizeof(position));
+        hash = checksum_bytes_(hash, &snake->alive, sizeof(snake->alive));
+        hash = checksum_bytes_(hash, &snake->score, sizeof(snake->score));
+    }
+    /* 多人模式下蛇身格子的所属玩家（单人模式总是 0）：按占用位图只访问非空格子，
+     * 空格子和食物格子的 owner 是残留值，不参与计算 */
+    for (row = 0; ctx->player_count > 1 && row < (int)SNAKE_GAME_HEIGHT; row++)
+    {
+        Uint32 bits = ctx->occupied_rows[row];
+        while (bits != 0)
+        {
+            const int x = SDL_MostSignificantBitIndex32(bits & (~bits + 1));
+            bits &= bits - 1;
+            if (snake_cell_at(ctx, (char)x, (char)row) != SNAKE_CELL_FOOD)
+            {
+                hash = checksum_bytes_(hash, &ctx->owner[x + row * SNAKE_GAME_WIDTH], 1);
+            }
+        }
+    }
+    hash = checksum_entities_(hash, &ctx->entities);
+    hash = checksum_bytes_(hash, &ctx->player_count, sizeof(ctx->player_count));
+    hash = checksum_bytes_(hash, &ctx->occupied_cells, sizeof(ctx->occupied_cells));
+    hash = checksum_bytes_(hash, &ctx->rng_state, sizeof(ctx->rng_state));
+    hash = checksum_bytes_(hash, &ctx->tick, sizeof(ctx->tick));
+    return hash;
+}
+
+Uint32 snake_checksum_roll(Uint32 rolling, const SnakeContext *ctx)
+{
+    const Uint32 checksum = snake_checksum(ctx);
+    return checksum_bytes_(rolling ^ CHECKSUM_FNV_OFFSET, &checksum, sizeof(checksum));
+}
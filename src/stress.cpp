@@ -0,0 +1,535 @@
+/*
+ * 长蛇压力测试
+ * 自动驾驶沿覆盖整个场地的哈密顿回路前进，蛇吃掉沿途所有食物，一直增长到占满场地；
+ * 按蛇身长度分段统计每 tick 的 snake_step 耗时和渲染耗时，
+ * snake_step 的耗时必须与长度无关，循环中隐藏的 O(长度) 工作会使长蛇段明显变慢
+ *
+ * 游戏场地固定为 24x18，蛇最长 431 格；第二段在运行时指定大小的大场地上重复测量
+ * （默认 1024x1024，蛇长到 10^6 格以上）：大场地使用与游戏相同的数据结构（3 位压缩的格子、
+ * 格子中记录方向的蛇身链、行占用位图和空格子计数），坐标、位图和计数换成更宽的类型，
+ * 每行的空格子数另外记录在树状数组中，使挑选空格子的耗时与长度无关，也不随场地高度线性增长
+ */
+
+#include "headless.h"
+#include "render.h"
+
+#define STRESS_BUCKET 16                                     /* 长度分段宽度 */
+#define STRESS_BUCKETS ((int)(SNAKE_MATRIX_SIZE / STRESS_BUCKET) + 1)
+#define STRESS_MAX_TICKS 2000000U                            /* 占满场地之前的 tick 上限 */
+#define STRESS_RENDER_EVERY 8                                /* 每隔几个 tick 测量一次渲染 */
+#define STRESS_MAX_RATIO 3.0                                 /* 最长段与最短段 snake_step 耗时之比的上限 */
+#define STRESS_BAR_WIDTH 40                                  /* 文本图表的最大宽度 */
+
+#define STRESS_LARGE_WIDTH 1024                              /* 大场地默认宽度 */
+#define STRESS_LARGE_HEIGHT 1024                             /* 大场地默认高度（必须为偶数） */
+#define STRESS_LARGE_MAX_CELLS (1 << 26)                     /* 大场地的格子数上限 */
+#define STRESS_LARGE_BUCKETS 32                              /* 大场地的长度分段数 */
+#define STRESS_LARGE_GROW_EVERY 2                            /* 大场地上每隔几个 tick 增长一格 */
+
+SDL_COMPILE_TIME_ASSERT(stress_even_height, SNAKE_GAME_HEIGHT % 2 == 0);
+
+/* 一个长度段的统计 */
+typedef struct
+{
+    Uint64 ticks;                                 /* 测量的 tick 数 */
+    Uint64 step_counts;                           /* snake_step 累计耗时（性能计数器） */
+    Uint64 frames;                                /* 测量的渲染帧数 */
+    Uint64 render_counts[SNAKE_RENDER_STRATEGY_COUNT]; /* 每种渲染策略累计耗时 */
+} StressBucket;
+
+/* 运行时指定大小的大场地
+ * 格子编码与 SnakeCell 相同，蛇身格子记录前往下一格的方向，蛇尾沿方向前进，移动只访问蛇头和蛇尾；
+ * 场地上始终有一个食物，每 tick 移动到新的随机空格子，使每个测量的 tick 都包含一次空格子挑选
+ */
+typedef struct
+{
+    int width;                /* 场地宽度（格子数） */
+    int height;               /* 场地高度（格子数） */
+    int row_words;            /* 每行占用位图的 64 位字数 */
+    Uint32 cell_count;        /* 格子总数 */
+    Uint32 free_cells;        /* 空格子数量 */
+    Uint32 length;            /* 蛇身长度 */
+    Uint32 pending_growth;    /* 尚未完成的增长（蛇尾停留的 tick 数） */
+    Sint32 head_x;
+    Sint32 head_y;
+    Sint32 tail_x;
+    Sint32 tail_y;
+    Sint32 food_x;            /* 食物位置（没有空格子时 food_x 为 -1） */
+    Sint32 food_y;
+    Uint64 rng_state;
+    unsigned char *cells;     /* 每格 3 位，末尾多留 1 字节供两字节读取 */
+    Uint64 *occupied_rows;    /* [height][row_words] 每行的占用位图 */
+    Uint32 *free_tree;        /* 每行空格子数的树状数组（下标从 1 开始） */
+} StressBoard;
+
+/* 哈密顿回路：第 0 列向上，其余各列按行往返（偶数行向右，奇数行向左），
+ * 最后一行走到第 0 列后沿第 0 列回到顶部
+ */
+static SnakeDirection autopilot_(int x, int y, int width, int height)
+{
+    if (x == 0)
+    {
+        return y == 0 ? SNAKE_DIR_RIGHT : SNAKE_DIR_UP;
+    }
+    if (y % 2 == 0)
+    {
+        return x == width - 1 ? SNAKE_DIR_DOWN : SNAKE_DIR_RIGHT;
+    }
+    if (x == 1 && y != height - 1)
+    {
+        return SNAKE_DIR_DOWN;
+    }
+    return SNAKE_DIR_LEFT;
+}
+
+/* 蛇身长度：已占用的格子减去食物和拾取物 */
+static int body_length_(const SnakeContext *ctx)
+{
+    return (int)SNAKE_MATRIX_SIZE - ctx->free_cells -
+           ctx->entities.count[SNAKE_ENTITY_FOOD] - ctx->entities.count[SNAKE_ENTITY_PICKUP];
+}
+
+static double to_ns_(Uint64 counts, Uint64 n)
+{
+    return n ? (double)counts * 1e9 / (double)SDL_GetPerformanceFrequency() / (double)n : 0.0;
+}
+
+/* 统计64位整数中为1的位数 */
+static int popcount64_(Uint64 v)
+{
+    v = v - ((v >> 1) & 0x5555555555555555ULL);
+    v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+    return (int)((((v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL) * 0x0101010101010101ULL) >> 56);
+}
+
+/* 64位整数最低的1位的下标 */
+static int lowest_bit64_(Uint64 v)
+{
+    const Uint64 low = v & (~v + 1);
+    return (Uint32)low ? SDL_MostSignificantBitIndex32((Uint32)low) : 32 + SDL_MostSignificantBitIndex32((Uint32)(low >> 32));
+}
+
+static SnakeCell board_cell_at_(const StressBoard *board, Sint32 x, Sint32 y)
+{
+    const Uint64 shift = ((Uint64)y * (Uint64)board->width + (Uint64)x) * SNAKE_CELL_MAX_BITS;
+    unsigned short range;
+    SDL_memcpy(&range, board->cells + (shift / 8), sizeof(range));
+    return (SnakeCell)((range >> (shift % 8)) & THREE_BITS);
+}
+
+/* 设置格子状态，空/非空发生变化时同步行占用位图、空格子计数和树状数组 */
+static void board_put_cell_(StressBoard *board, Sint32 x, Sint32 y, SnakeCell ct)
+{
+    const Uint64 shift = ((Uint64)y * (Uint64)board->width + (Uint64)x) * SNAKE_CELL_MAX_BITS;
+    const int adjust = (int)(shift % 8);
+    unsigned char *const pos = board->cells + (shift / 8);
+    unsigned short range;
+    SDL_memcpy(&range, pos, sizeof(range));
+    if ((((range >> adjust) & THREE_BITS) == SNAKE_CELL_NOTHING) != (ct == SNAKE_CELL_NOTHING))
+    {
+        const Uint32 delta = (ct == SNAKE_CELL_NOTHING) ? 1U : (Uint32)-1;
+        Uint32 i;
+        board->occupied_rows[y * board->row_words + x / 64] ^= 1ULL << (x % 64);
+        board->free_cells += delta;
+        for (i = (Uint32)y + 1; i <= (Uint32)board->height; i += i & (~i + 1))
+        {
+            board->free_tree[i] += delta;
+        }
+    }
+    range &= ~(THREE_BITS << adjust);
+    range |= (ct & THREE_BITS) << adjust;
+    SDL_memcpy(pos, &range, sizeof(range));
+}
+
+/* 随机选择一个空格子：在树状数组上按序号找到所在的行，再在行内逐字跳过，
+ * 耗时为 O(log 高度 + 宽度 / 64)，与蛇身长度无关；没有空格子时返回 false
+ */
+static bool board_pick_free_cell_(StressBoard *board, Sint32 *x, Sint32 *y)
+{
+    Uint32 n;
+    Uint32 row = 0;
+    Uint32 step;
+    const Uint64 *bits;
+    Uint64 free_bits = 0;
+    int word;
+
+    if (board->free_cells == 0)
+    {
+        return false;
+    }
+    n = (Uint32)SDL_rand_r(&board->rng_state, (Sint32)board->free_cells);
+    for (step = 1U << SDL_MostSignificantBitIndex32((Uint32)board->height); step != 0; step >>= 1)
+    {
+        if (row + step <= (Uint32)board->height && board->free_tree[row + step] <= n)
+        {
+            row += step;
+            n -= board->free_tree[row];
+        }
+    }
+    bits = &board->occupied_rows[row * board->row_words];
+    for (word = 0; word < board->row_words; word++)
+    {
+        const int valid = SDL_min(64, board->width - word * 64);
+        free_bits = ~bits[word] & (valid == 64 ? ~0ULL : (1ULL << valid) - 1ULL);
+        const Uint32 word_free = (Uint32)popcount64_(free_bits);
+        if (n < word_free)
+        {
+            break;
+        }
+        n -= word_free;
+    }
+    while (n-- > 0)
+    {
+        free_bits &= free_bits - 1;
+    }
+    *x = word * 64 + lowest_bit64_(free_bits);
+    *y = (Sint32)row;
+    return true;
+}
+
+static void board_destroy_(StressBoard *board)
+{
+    SDL_free(board->cells);
+    SDL_free(board->occupied_rows);
+    SDL_free(board->free_tree);
+}
+
+/* 分配场地，在左上角放置长度为1的蛇和一个食物 */
+static bool board_create_(StressBoard *board, int width, int height)
+{
+    const Uint64 cells = (Uint64)width * (Uint64)height;
+    int i;
+
+    SDL_zerop(board);
+    if (width < 2 || height < 2 || height % 2 != 0 || cells > STRESS_LARGE_MAX_CELLS)
+    {
+        return SDL_SetError("stress board must be at least 2x2 with an even height and at most %d cells, not %dx%d",
+                            STRESS_LARGE_MAX_CELLS, width, height);
+    }
+    board->width = width;
+    board->height = height;
+    board->row_words = (width + 63) / 64;
+    board->cell_count = (Uint32)cells;
+    board->free_cells = (Uint32)cells;
+    board->rng_state = 0x57E55;
+    board->cells = (unsigned char *)SDL_calloc(cells * SNAKE_CELL_MAX_BITS / 8 + 2, 1);
+    board->occupied_rows = (Uint64 *)SDL_calloc((size_t)height * board->row_words, sizeof(Uint64));
+    board->free_tree = (Uint32 *)SDL_calloc((size_t)height + 1, sizeof(Uint32));
+    if (!board->cells || !board->occupied_rows || !board->free_tree)
+    {
+        board_destroy_(board);
+        return false;
+    }
+    for (i = 1; i <= height; i++)
+    {
+        board->free_tree[i] = (Uint32)width * (Uint32)(i & -i); /* 每行 width 个空格子的前缀和 */
+    }
+    board->length = 1;
+    board_put_cell_(board, 0, 0, (SnakeCell)(autopilot_(0, 0, width, height) + 1));
+    board_pick_free_cell_(board, &board->food_x, &board->food_y);
+    board_put_cell_(board, board->food_x, board->food_y, SNAKE_CELL_FOOD);
+    return true;
+}
+
+/* 推进一个 tick：移动蛇尾（有待完成的增长时停留）和蛇头，吃到食物时增长一格，
+ * 然后把食物移动到新的随机空格子；撞到蛇身时返回 false
+ */
+static bool board_step_(StressBoard *board, SnakeDirection dir)
+{
+    const SnakeCell dir_as_cell = (SnakeCell)(dir + 1);
+    Sint32 x = board->head_x;
+    Sint32 y = board->head_y;
+    SnakeCell ct;
+
+    if (board->pending_growth > 0)
+    {
+        --board->pending_growth;
+        ++board->length;
+    }
+    else
+    {
+        ct = board_cell_at_(board, board->tail_x, board->tail_y);
+        board_put_cell_(board, board->tail_x, board->tail_y, SNAKE_CELL_NOTHING);
+        board->tail_x += ct == SNAKE_CELL_SRIGHT ? 1 : ct == SNAKE_CELL_SLEFT ? -1 : 0;
+        board->tail_y += ct == SNAKE_CELL_SDOWN ? 1 : ct == SNAKE_CELL_SUP ? -1 : 0;
+        board->tail_x = (board->tail_x + board->width) % board->width;
+        board->tail_y = (board->tail_y + board->height) % board->height;
+    }
+    x += dir == SNAKE_DIR_RIGHT ? 1 : dir == SNAKE_DIR_LEFT ? -1 : 0;
+    y += dir == SNAKE_DIR_DOWN ? 1 : dir == SNAKE_DIR_UP ? -1 : 0;
+    x = (x + board->width) % board->width;
+    y = (y + board->height) % board->height;
+    ct = board_cell_at_(board, x, y);
+    if (ct != SNAKE_CELL_NOTHING && ct != SNAKE_CELL_FOOD)
+    {
+        return false;
+    }
+    board_put_cell_(board, board->head_x, board->head_y, dir_as_cell);
+    board_put_cell_(board, x, y, dir_as_cell);
+    board->head_x = x;
+    board->head_y = y;
+    if (ct == SNAKE_CELL_FOOD)
+    {
+        ++board->pending_growth;
+    }
+    else if (board->food_x >= 0)
+    {
+        board_put_cell_(board, board->food_x, board->food_y, SNAKE_CELL_NOTHING);
+    }
+    board->food_x = -1;
+    if (board_pick_free_cell_(board, &board->food_x, &board->food_y))
+    {
+        board_put_cell_(board, board->food_x, board->food_y, SNAKE_CELL_FOOD);
+    }
+    return true;
+}
+
+/* 输出每个长度段的平均耗时（文本图表和 CSV），比较最长段与最短段
+ * 返回 false 表示 snake_step 的耗时随长度增长超过限度
+ */
+static bool report_(const char *board, const StressBucket *buckets, int count, int bucket_width, int longest, SDL_IOStream *csv)
+{
+    double max_ns = 0.0;
+    double first_ns = 0.0;
+    double last_ns = 0.0;
+    int b;
+    int s;
+
+    for (b = 0; b < count; b++)
+    {
+        max_ns = SDL_max(max_ns, to_ns_(buckets[b].step_counts, buckets[b].ticks));
+    }
+    for (b = 0; b < count; b++)
+    {
+        const StressBucket *bucket = &buckets[b];
+        const double step_ns = to_ns_(bucket->step_counts, bucket->ticks);
+        char bar[STRESS_BAR_WIDTH + 1];
+        char renders[64];
+        const int width = max_ns > 0.0 ? (int)(step_ns / max_ns * STRESS_BAR_WIDTH + 0.5) : 0;
+
+        if (bucket->ticks == 0)
+        {
+            continue;
+        }
+        SDL_memset(bar, '#', width);
+        bar[width] = '\0';
+        renders[0] = '\0';
+        for (s = 0; s < SNAKE_RENDER_STRATEGY_COUNT && bucket->frames; s++)
+        {
+            SDL_snprintf(renders + SDL_strlen(renders), sizeof(renders) - SDL_strlen(renders), " %s %.1f us",
+                         snake_render_strategy_name((SnakeRenderStrategy)s), to_ns_(bucket->render_counts[s], bucket->frames) / 1e3);
+        }
+        SDL_Log("stress: %7d-%7d %7.1f ns%s |%s", b * bucket_width, b * bucket_width + bucket_width - 1, step_ns, renders, bar);
+        if (csv)
+        {
+            SDL_IOprintf(csv, "%s,%d,%" SDL_PRIu64 ",%.1f", board, b * bucket_width, bucket->ticks, step_ns);
+            for (s = 0; s < SNAKE_RENDER_STRATEGY_COUNT; s++)
+            {
+                if (bucket->frames)
+                {
+                    SDL_IOprintf(csv, ",%.1f", to_ns_(bucket->render_counts[s], bucket->frames));
+                }
+                else
+                {
+                    SDL_IOprintf(csv, ","); /* 大场地不测量渲染 */
+                }
+            }
+            SDL_IOprintf(csv, "\n");
+        }
+        if (first_ns == 0.0)
+        {
+            first_ns = step_ns;
+        }
+        last_ns = step_ns;
+    }
+
+    /* 最长段与最短段比较 */
+    if (first_ns > 0.0 && last_ns <= first_ns * STRESS_MAX_RATIO)
+    {
+        SDL_Log("stress: %s step cost at length %d is %.2fx the cost at length 0", board, longest, last_ns / first_ns);
+        return true;
+    }
+    SDL_LogError(SDL_LOG_CATEGORY_TEST, "stress: %s step cost grows with length (%.1f ns -> %.1f ns)", board, first_ns, last_ns);
+    return false;
+}
+
+/* 在大场地上让蛇增长到占满场地（只剩食物的格子），每 STRESS_LARGE_GROW_EVERY 个 tick 额外增长一格，
+ * 蛇尾在其余 tick 照常移动；按长度分段统计每 tick 的耗时
+ */
+static bool stress_large_(int width, int height, SDL_IOStream *csv)
+{
+    StressBucket buckets[STRESS_LARGE_BUCKETS];
+    StressBoard board;
+    char name[32];
+    int bucket_width;
+    Uint64 tick;
+    Uint64 max_ticks;
+    bool ok = false;
+
+    if (!board_create_(&board, width, height))
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "stress: %s", SDL_GetError());
+        return false;
+    }
+    SDL_zeroa(buckets);
+    SDL_snprintf(name, sizeof(name), "%dx%d", width, height);
+    bucket_width = (int)((board.cell_count + STRESS_LARGE_BUCKETS - 1) / STRESS_LARGE_BUCKETS);
+    max_ticks = (Uint64)board.cell_count * (STRESS_LARGE_GROW_EVERY + 1);
+    for (tick = 0; tick < max_ticks && board.length + 1 < board.cell_count; tick++)
+    {
+        StressBucket *bucket = &buckets[board.length / bucket_width];
+        const SnakeDirection dir = autopilot_(board.head_x, board.head_y, width, height);
+        Uint64 start;
+        Uint64 elapsed;
+        bool alive;
+
+        if (tick % STRESS_LARGE_GROW_EVERY == 0 && board.length + board.pending_growth + 1 < board.cell_count)
+        {
+            ++board.pending_growth;
+        }
+        start = SDL_GetPerformanceCounter();
+        alive = board_step_(&board, dir);
+        elapsed = SDL_GetPerformanceCounter() - start;
+        if (!alive)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_TEST, "stress: autopilot collided on the %s board at length %u", name, board.length);
+            goto done;
+        }
+        bucket->ticks++;
+        bucket->step_counts += elapsed;
+    }
+    if (board.length + 1 < board.cell_count)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "stress: %s board not filled after %" SDL_PRIu64 " ticks (length %u)", name, tick, board.length);
+        goto done;
+    }
+    SDL_Log("stress: filled the %s board in %" SDL_PRIu64 " ticks; per-tick cost by snake length:", name, tick);
+    ok = report_(name, buckets, STRESS_LARGE_BUCKETS, bucket_width, (int)board.length, csv);
+
+done:
+    board_destroy_(&board);
+    return ok;
+}
+
+SDL_AppResult snake_stress(int argc, char *argv[])
+{
+    const char *csv_path = NULL;
+    StressBucket buckets[STRESS_BUCKETS];
+    SDL_Surface *target = NULL;
+    SDL_Renderer *renderer = NULL;
+    SDL_IOStream *csv = NULL;
+    SnakeContext *ctx = (SnakeContext *)SDL_aligned_alloc(SNAKE_CACHE_LINE, sizeof(SnakeContext));
+    int large_width = STRESS_LARGE_WIDTH;
+    int large_height = STRESS_LARGE_HEIGHT;
+    Uint32 tick;
+    int longest = 0;
+    int b;
+    int s;
+    bool won = false;
+    bool ok = false;
+
+    for (b = 1; b < argc; b++)
+    {
+        if (SDL_strcmp(argv[b], "--stress-csv") == 0 && b + 1 < argc)
+        {
+            csv_path = argv[++b];
+        }
+        else if (SDL_strcmp(argv[b], "--stress-width") == 0 && b + 1 < argc)
+        {
+            large_width = SDL_atoi(argv[++b]);
+        }
+        else if (SDL_strcmp(argv[b], "--stress-height") == 0 && b + 1 < argc)
+        {
+            large_height = SDL_atoi(argv[++b]);
+        }
+    }
+    SDL_zeroa(buckets);
+    if (!ctx)
+    {
+        return SDL_APP_FAILURE;
+    }
+
+    /* 渲染使用内存表面上的软件渲染器，创建失败时只测量 snake_step */
+    target = SDL_CreateSurface(SDL_WINDOW_WIDTH, SDL_WINDOW_HEIGHT, SDL_PIXELFORMAT_ARGB8888);
+    renderer = target ? SDL_CreateSoftwareRenderer(target) : NULL;
+    if (!renderer)
+    {
+        SDL_Log("stress: rendering not measured: %s", SDL_GetError());
+    }
+
+    snake_initialize_seeded(ctx, 0x57E55);
+    for (tick = 0; tick < STRESS_MAX_TICKS; tick++)
+    {
+        const int length = body_length_(ctx);
+        StressBucket *bucket = &buckets[length / STRESS_BUCKET];
+        const SnakePlayer *snake = &ctx->players[0];
+        Uint64 start;
+        Uint64 elapsed;
+
+        snake_redir(ctx, autopilot_(snake->head_xpos, snake->head_ypos, SNAKE_GAME_WIDTH, SNAKE_GAME_HEIGHT));
+        start = SDL_GetPerformanceCounter();
+        snake_step(ctx);
+        elapsed = SDL_GetPerformanceCounter() - start;
+
+        if (ctx->events & SNAKE_EVENT_DIED)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_TEST, "stress: autopilot collided at length %d", length);
+            goto done;
+        }
+        if (ctx->events & SNAKE_EVENT_WON)
+        {
+            won = true; /* 占满场地，这个 tick 包含重置，不计入统计 */
+            break;
+        }
+        bucket->ticks++;
+        bucket->step_counts += elapsed;
+        longest = SDL_max(longest, length);
+
+        if (renderer && tick % STRESS_RENDER_EVERY == 0)
+        {
+            for (s = 0; s < SNAKE_RENDER_STRATEGY_COUNT; s++)
+            {
+                start = SDL_GetPerformanceCounter();
+                snake_render(renderer, ctx, (SnakeRenderStrategy)s);
+                bucket->render_counts[s] += SDL_GetPerformanceCounter() - start;
+            }
+            bucket->frames++;
+        }
+    }
+    if (!won)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "stress: board not filled after %u ticks (length %d)", tick, longest);
+        goto done;
+    }
+
+    if (csv_path)
+    {
+        csv = SDL_IOFromFile(csv_path, "w");
+        if (!csv)
+        {
+            SDL_LogError(SDL_LOG_CATEGORY_TEST, "stress: cannot write %s: %s", csv_path, SDL_GetError());
+            goto done;
+        }
+        SDL_IOprintf(csv, "board,length,ticks,step_ns");
+        for (s = 0; s < SNAKE_RENDER_STRATEGY_COUNT; s++)
+        {
+            SDL_IOprintf(csv, ",render_%s_ns", snake_render_strategy_name((SnakeRenderStrategy)s));
+        }
+        SDL_IOprintf(csv, "\n");
+    }
+    SDL_Log("stress: filled the board in %u ticks; per-tick cost by snake length:", tick);
+    ok = report_("game", buckets, STRESS_BUCKETS, STRESS_BUCKET, longest, csv);
+
+    /* 大场地：长度扫到 10^5 到 10^6 格 */
+    ok = stress_large_(large_width, large_height, csv) && ok;
+
+done:
+    if (csv)
+    {
+        SDL_CloseIO(csv);
+    }
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroySurface(target);
+    SDL_aligned_free(ctx);
+    return ok ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+}
@@ -0,0 +1,121 @@
+/*
+ * 线程策略实现（绑定通过 NUMA 模块的 sched_setaffinity，优先级通过 SDL_SetCurrentThreadPriority）
+ */
+
+#include "thread_policy.h"
+
+/* 优先级名称，按 SDL_ThreadPriority 的顺序 */
+static const char *const priority_names_[] = {"low", "normal", "high", "time_critical"};
+
+SDL_COMPILE_TIME_ASSERT(priority_names, SDL_arraysize(priority_names_) == SDL_THREAD_PRIORITY_TIME_CRITICAL + 1);
+
+void snake_thread_policy_init(SnakeThreadPolicy *policy)
+{
+    SDL_zerop(policy);
+    policy->priority = SDL_THREAD_PRIORITY_NORMAL;
+}
+
+bool snake_thread_policy_set(SnakeThreadPolicy *policy, const char *key, const char *value)
+{
+    size_t i;
+
+    if (SDL_strcmp(key, "cpus") == 0)
+    {
+        Uint64 cpus[SNAKE_NUMA_MAX_CPUS / 64];
+        int count;
+
+        SDL_zeroa(cpus);
+        count = snake_numa_parse_cpulist(value, cpus);
+        if (count <= 0)
+        {
+            return false;
+        }
+        SDL_memcpy(policy->cpus, cpus, sizeof(cpus));
+        policy->cpu_count = count;
+        return true;
+    }
+    if (SDL_strcmp(key, "priority") == 0)
+    {
+        for (i = 0; i < SDL_arraysize(priority_names_); i++)
+        {
+            if (SDL_strcmp(value, priority_names_[i]) == 0)
+            {
+                policy->priority = (SDL_ThreadPriority)i;
+                policy->set_priority = true;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/* 列表中的第 index 个 CPU（按列表循环） */
+static int nth_cpu_(const SnakeThreadPolicy *policy, int index)
+{
+    int n = index % policy->cpu_count;
+    int cpu;
+
+    for (cpu = 0; cpu < SNAKE_NUMA_MAX_CPUS; cpu++)
+    {
+        if ((policy->cpus[cpu / 64] & ((Uint64)1 << (cpu % 64))) && n-- == 0)
+        {
+            return cpu;
+        }
+    }
+    return -1;
+}
+
+bool snake_thread_policy_apply(const SnakeThreadPolicy *policy, int index, const char *name)
+{
+    Uint64 cpus[SNAKE_NUMA_MAX_CPUS / 64];
+    char applied[128];
+    char priority[96];
+    bool ok = true;
+
+    /* 绑定 CPU */
+    if (policy->cpu_count > 0)
+    {
+        if (index >= 0)
+        {
+            const int cpu = nth_cpu_(policy, index);
+            SDL_zeroa(cpus);
+            cpus[cpu / 64] |= (Uint64)1 << (cpu % 64);
+        }
+        else
+        {
+            SDL_memcpy(cpus, policy->cpus, sizeof(cpus));
+        }
+        if (!snake_numa_pin_cpus(cpus))
+        {
+            SDL_Log("thread %s: cannot pin: %s", name, SDL_GetError());
+            ok = false;
+        }
+    }
+
+    /* 调整优先级（没有权限时系统会拒绝较高的优先级） */
+    SDL_strlcpy(priority, "default", sizeof(priority));
+    if (policy->set_priority)
+    {
+        if (SDL_SetCurrentThreadPriority(policy->priority))
+        {
+            SDL_strlcpy(priority, priority_names_[policy->priority], sizeof(priority));
+        }
+        else
+        {
+            SDL_snprintf(priority, sizeof(priority), "default (%s refused: %s)", priority_names_[policy->priority], SDL_GetError());
+            ok = false;
+        }
+    }
+
+    /* 读回实际生效的 CPU */
+    if (snake_numa_current_cpus(cpus))
+    {
+        snake_numa_format_cpulist(cpus, applied, sizeof(applied));
+    }
+    else
+    {
+        SDL_strlcpy(applied, "unknown", sizeof(applied));
+    }
+    SDL_Log("thread %s: cpus %s, priority %s", name, applied, priority);
+    return ok;
+}
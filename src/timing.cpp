@@ -0,0 +1,166 @@
+/*
+ * 计时实现
+ */
+
+#include "timing.h"
+
+#define TIMING_FP_SHIFT 32                 /* 定点数的小数位数 */
+#define TIMING_JITTER_BUCKET_NS 50000U     /* tick 延迟直方图的桶宽度：50 微秒 */
+#define TIMING_PRESENT_BUCKET_NS 500000U   /* 呈现间隔直方图的桶宽度：0.5 毫秒 */
+
+void snake_histogram_init(SnakeHistogram *histogram, Uint64 bucket_ns)
+{
+    SDL_zerop(histogram);
+    histogram->bucket_ns = bucket_ns ? bucket_ns : 1;
+}
+
+void snake_histogram_add(SnakeHistogram *histogram, Uint64 ns)
+{
+    const Uint64 bucket = SDL_min(ns / histogram->bucket_ns, (Uint64)SNAKE_HISTOGRAM_BUCKETS - 1);
+    histogram->buckets[bucket]++;
+    histogram->count++;
+    histogram->sum_ns += ns;
+    histogram->max_ns = SDL_max(histogram->max_ns, ns);
+}
+
+Uint64 snake_histogram_percentile(const SnakeHistogram *histogram, double p)
+{
+    const Uint64 rank = (Uint64)(p / 100.0 * (double)histogram->count);
+    Uint64 seen = 0;
+    int i;
+
+    for (i = 0; i < SNAKE_HISTOGRAM_BUCKETS - 1; i++)
+    {
+        seen += histogram->buckets[i];
+        if (seen > rank)
+        {
+            return (Uint64)(i + 1) * histogram->bucket_ns;
+        }
+    }
+    return histogram->max_ns; /* 落在最后一个桶（超出范围） */
+}
+
+double snake_histogram_fraction_below(const SnakeHistogram *histogram, Uint64 ns)
+{
+    const Uint64 limit = SDL_min(ns / histogram->bucket_ns, (Uint64)SNAKE_HISTOGRAM_BUCKETS - 1);
+    Uint64 below = 0;
+    Uint64 i;
+
+    for (i = 0; i < limit; i++)
+    {
+        below += histogram->buckets[i];
+    }
+    return histogram->count ? (double)below / (double)histogram->count : 1.0;
+}
+
+void snake_histogram_log(const SnakeHistogram *histogram, const char *name)
+{
+    int i;
+
+    SDL_Log("%s: %" SDL_PRIu64 " samples, mean %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms", name, histogram->count,
+            histogram->count ? histogram->sum_ns / 1e6 / histogram->count : 0.0, snake_histogram_percentile(histogram, 50.0) / 1e6,
+            snake_histogram_percentile(histogram, 99.0) / 1e6, histogram->max_ns / 1e6);
+    for (i = 0; i < SNAKE_HISTOGRAM_BUCKETS; i++)
+    {
+        if (histogram->buckets[i] == 0)
+        {
+            continue;
+        }
+        if (i == SNAKE_HISTOGRAM_BUCKETS - 1)
+        {
+            SDL_Log("%s:   >= %7.3f ms %u", name, i * histogram->bucket_ns / 1e6, histogram->buckets[i]);
+        }
+        else
+        {
+            SDL_Log("%s:   < %7.3f ms %u", name, (i + 1) * histogram->bucket_ns / 1e6, histogram->buckets[i]);
+        }
+    }
+}
+
+void snake_present_stats_init(SnakePresentStats *stats, Uint64 target_ns)
+{
+    SDL_zerop(stats);
+    stats->target_ns = target_ns;
+    snake_histogram_init(&stats->intervals, TIMING_PRESENT_BUCKET_NS);
+}
+
+void snake_present_stats_record(SnakePresentStats *stats, Uint64 now_ns)
+{
+    if (stats->last_ns != 0)
+    {
+        const Uint64 interval = now_ns - stats->last_ns;
+        snake_histogram_add(&stats->intervals, interval);
+        /* 间隔为预期的 n 倍（四舍五入）时错过了 n - 1 次刷新 */
+        if (stats->target_ns != 0 && interval >= stats->target_ns + stats->target_ns / 2)
+        {
+            stats->missed += (interval + stats->target_ns / 2) / stats->target_ns - 1;
+        }
+    }
+    stats->last_ns = now_ns;
+    stats->frames++;
+}
+
+void snake_present_stats_log(const SnakePresentStats *stats, const char *mode)
+{
+    snake_histogram_log(&stats->intervals, "present interval");
+    if (stats->target_ns != 0)
+    {
+        SDL_Log("present: %s, %" SDL_PRIu64 " frames, target %.3f ms, %" SDL_PRIu64 " missed (%.2f%%)", mode, stats->frames,
+                stats->target_ns / 1e6, stats->missed,
+                stats->frames ? 100.0 * stats->missed / (stats->frames + stats->missed) : 0.0);
+    }
+    else
+    {
+        SDL_Log("present: %s, %" SDL_PRIu64 " frames, uncapped", mode, stats->frames);
+    }
+}
+
+void snake_clock_init(SnakeTickClock *clock, Uint64 period_ns, Uint64 now_ns)
+{
+    clock->period_fp = period_ns << TIMING_FP_SHIFT;
+    snake_histogram_init(&clock->jitter, TIMING_JITTER_BUCKET_NS);
+    snake_clock_restart(clock, now_ns);
+}
+
+void snake_clock_set_rate(SnakeTickClock *clock, double hz)
+{
+    clock->period_fp = (Uint64)(1e9 / hz * (double)((Uint64)1 << TIMING_FP_SHIFT));
+}
+
+void snake_clock_scale(SnakeTickClock *clock, Uint64 num, Uint64 den, Uint64 min_ns, Uint64 max_ns)
+{
+    const Uint64 period_fp = clock->period_fp / den * num + clock->period_fp % den * num / den;
+    clock->period_fp = SDL_clamp(period_fp, min_ns << TIMING_FP_SHIFT, max_ns << TIMING_FP_SHIFT);
+}
+
+Uint64 snake_clock_period_ns(const SnakeTickClock *clock)
+{
+    return clock->period_fp >> TIMING_FP_SHIFT;
+}
+
+void snake_clock_restart(SnakeTickClock *clock, Uint64 now_ns)
+{
+    clock->due_ns = now_ns + (clock->period_fp >> TIMING_FP_SHIFT);
+    clock->due_frac = (Uint32)clock->period_fp;
+}
+
+bool snake_clock_tick(SnakeTickClock *clock, Uint64 now_ns)
+{
+    Uint64 frac;
+
+    if (now_ns < snake_clock_due(clock))
+    {
+        return false;
+    }
+    snake_histogram_add(&clock->jitter, now_ns - clock->due_ns);
+    /* 小数部分单独累加，进位到整数部分 */
+    frac = (Uint64)clock->due_frac + (Uint32)clock->period_fp;
+    clock->due_ns += (clock->period_fp >> TIMING_FP_SHIFT) + (frac >> TIMING_FP_SHIFT);
+    clock->due_frac = (Uint32)frac;
+    return true;
+}
+
+Uint64 snake_clock_due(const SnakeTickClock *clock)
+{
+    return clock->due_ns + (clock->due_frac != 0);
+}
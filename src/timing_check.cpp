@@ -0,0 +1,138 @@
+/*
+ * tick 计时检查
+ * 先不睡眠地按 60 Hz 推进一百万个 tick，检查预定时刻没有累计误差；
+ * 再按 60 Hz 实际运行，每个 tick 推进一局游戏，之间用 SDL_DelayPrecise 睡到下一个 tick，
+ * 记录 tick 实际执行时刻晚于预定时刻的直方图；可以先绑定 CPU 和提高优先级，比较系统繁忙时的延迟
+ *
+ * 默认的门槛（99% 的 tick 在 0.5 毫秒内）需要安静的机器，最好绑定到没有其他负载的 CPU；
+ * 共享的虚拟机和 CI 容器上可以放宽门槛，或者只输出警告
+ */
+
+#include "headless.h"
+#include "snake.h"
+#include "timing.h"
+#include "thread_policy.h"
+
+#define TIMING_CHECK_RATE 60.0           /* 不是整数毫秒的速率 */
+#define TIMING_CHECK_DRIFT_TICKS 1000000U
+#define TIMING_CHECK_TICKS 300           /* 实际运行的 tick 数（5 秒） */
+#define TIMING_CHECK_MIN_PERCENT 99.0    /* 默认至少这个比例的 tick 在目标延迟内执行 */
+
+SDL_AppResult snake_timing_check(int argc, char *argv[])
+{
+    SnakeTickClock clock;
+    SnakeThreadPolicy policy;
+    SnakeContext ctx;
+    Uint64 expected;
+    Uint64 due;
+    Uint32 tick;
+    int ticks = TIMING_CHECK_TICKS;
+    int i;
+    double within;
+    double target_ms = SNAKE_TICK_JITTER_TARGET_NS / 1e6;
+    double min_percent = TIMING_CHECK_MIN_PERCENT;
+    bool warn_only = false;
+    bool valid = true;
+
+    snake_thread_policy_init(&policy);
+    for (i = 1; i < argc; i++)
+    {
+        if (SDL_strcmp(argv[i], "--timing-ticks") == 0 && i + 1 < argc)
+        {
+            ticks = SDL_atoi(argv[++i]);
+        }
+        else if (SDL_strcmp(argv[i], "--timing-target-ms") == 0 && i + 1 < argc)
+        {
+            target_ms = SDL_strtod(argv[++i], NULL);
+        }
+        else if (SDL_strcmp(argv[i], "--timing-min-percent") == 0 && i + 1 < argc)
+        {
+            min_percent = SDL_strtod(argv[++i], NULL);
+        }
+        else if (SDL_strcmp(argv[i], "--timing-warn-only") == 0)
+        {
+            warn_only = true;
+        }
+        else if (SDL_strcmp(argv[i], "--pin-cpus") == 0 && i + 1 < argc)
+        {
+            valid = snake_thread_policy_set(&policy, "cpus", argv[++i]) && valid;
+        }
+        else if (SDL_strcmp(argv[i], "--priority") == 0 && i + 1 < argc)
+        {
+            valid = snake_thread_policy_set(&policy, "priority", argv[++i]) && valid;
+        }
+    }
+    ticks = SDL_max(ticks, 1);
+    if (!valid)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "timing-check: invalid --pin-cpus or --priority");
+        return SDL_APP_FAILURE;
+    }
+    if (!(target_ms > 0.0) || !(min_percent >= 0.0 && min_percent <= 100.0))
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "timing-check: --timing-target-ms must be positive and --timing-min-percent between 0 and 100");
+        return SDL_APP_FAILURE;
+    }
+
+    /* 累计误差：第 n 个 tick 应在 n / 60 秒时到期 */
+    snake_clock_init(&clock, 0, 0);
+    snake_clock_set_rate(&clock, TIMING_CHECK_RATE);
+    snake_clock_restart(&clock, 0);
+    for (tick = 1; tick < TIMING_CHECK_DRIFT_TICKS; tick++)
+    {
+        snake_clock_tick(&clock, snake_clock_due(&clock));
+    }
+    due = snake_clock_due(&clock);
+    expected = (Uint64)((double)TIMING_CHECK_DRIFT_TICKS * SDL_NS_PER_SECOND / TIMING_CHECK_RATE + 0.5);
+    if (due + 1 < expected || due > expected + 1)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "timing-check: tick %u due at %" SDL_PRIu64 " ns, expected %" SDL_PRIu64 " ns",
+                     TIMING_CHECK_DRIFT_TICKS, due, expected);
+        return SDL_APP_FAILURE;
+    }
+    SDL_Log("timing-check: %u ticks at %.0f Hz scheduled with %" SDL_PRIs64 " ns drift", TIMING_CHECK_DRIFT_TICKS,
+            TIMING_CHECK_RATE, (Sint64)due - (Sint64)expected);
+
+    /* 实际运行：绑定和优先级失败时按系统默认继续 */
+    if (policy.cpu_count > 0 || policy.set_priority)
+    {
+        snake_thread_policy_apply(&policy, -1, "timing-check");
+    }
+    snake_initialize_seeded(&ctx, 0x71C4);
+    snake_clock_init(&clock, 0, 0);
+    snake_clock_set_rate(&clock, TIMING_CHECK_RATE);
+    snake_clock_restart(&clock, SDL_GetTicksNS());
+    while (clock.jitter.count < (Uint64)ticks)
+    {
+        Uint64 now = SDL_GetTicksNS();
+        while (snake_clock_tick(&clock, now))
+        {
+            snake_step(&ctx);
+        }
+        now = SDL_GetTicksNS();
+        due = snake_clock_due(&clock);
+        if (due > now)
+        {
+            SDL_DelayPrecise(due - now);
+        }
+    }
+    snake_histogram_log(&clock.jitter, "timing-check");
+
+    /* 预定时刻的累计误差与机器负载无关，总是检查；延迟取决于机器，可以放宽或只警告 */
+    within = snake_histogram_fraction_below(&clock.jitter, (Uint64)(target_ms * 1e6 + 0.5));
+    if (100.0 * within < min_percent)
+    {
+        if (warn_only)
+        {
+            SDL_LogWarn(SDL_LOG_CATEGORY_TEST, "timing-check: only %.2f%% of ticks within %.2f ms of schedule (need %.2f%%; warning only)",
+                        100.0 * within, target_ms, min_percent);
+            return SDL_APP_SUCCESS;
+        }
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "timing-check: only %.2f%% of ticks within %.2f ms of schedule (need %.2f%%); "
+                     "run on a quiet host with --pin-cpus, or relax with --timing-target-ms/--timing-min-percent",
+                     100.0 * within, target_ms, min_percent);
+        return SDL_APP_FAILURE;
+    }
+    SDL_Log("timing-check: %.2f%% of ticks within %.2f ms of schedule (need %.2f%%)", 100.0 * within, target_ms, min_percent);
+    return SDL_APP_SUCCESS;
+}
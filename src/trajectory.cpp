@@ -0,0 +1,561 @@
+/*
+ * 轨迹数据集实现
+ * 写入端：录制线程把每行写入当前块缓冲区的各列，写满后交给后台线程写文件，
+ * 同时换到另一个缓冲区继续录制；另一个缓冲区还没写完时录制线程等待
+ * 读取端：只在打开时读取索引，列数据按需映射（Linux 使用 mmap，其他系统读入内存）
+ */
+
+#include "trajectory.h"
+
+#ifdef SDL_PLATFORM_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define TRAJECTORY_FILE_MAGIC 0x544B4E53U    /* "SNKT" */
+#define TRAJECTORY_TRAILER_MAGIC 0x45544E53U /* "SNTE" */
+#define TRAJECTORY_FILE_VERSION 1U
+#define TRAJECTORY_HEADER_SIZE 64U           /* 文件头字节数（补齐到列的对齐） */
+#define TRAJECTORY_INDEX_ENTRY_SIZE (16U + 16U * SNAKE_TRAJECTORY_COLUMN_COUNT) /* 索引项字节数 */
+#define TRAJECTORY_TRAILER_SIZE 24U          /* 文件尾字节数 */
+
+SDL_COMPILE_TIME_ASSERT(trajectory_done_bytes, SNAKE_TRAJECTORY_CHUNK_ROWS % 8 == 0);
+SDL_COMPILE_TIME_ASSERT(trajectory_header_aligned, TRAJECTORY_HEADER_SIZE % SNAKE_TRAJECTORY_ALIGN == 0);
+
+/* 块索引项 */
+typedef struct
+{
+    Uint64 first_row;                                /* 块中第一行的编号 */
+    Uint32 rows;                                     /* 块中的行数 */
+    Uint64 offsets[SNAKE_TRAJECTORY_COLUMN_COUNT];   /* 每列在文件中的偏移 */
+    Uint64 sizes[SNAKE_TRAJECTORY_COLUMN_COUNT];     /* 每列的字节数 */
+} TrajectoryChunkEntry;
+
+/* 写入端的块缓冲区，每列连续存放 */
+typedef struct
+{
+    Uint8 obs[SNAKE_TRAJECTORY_CHUNK_ROWS][SNAKE_TRAJECTORY_OBS_BYTES];
+    Uint8 action[SNAKE_TRAJECTORY_CHUNK_ROWS];
+    float reward[SNAKE_TRAJECTORY_CHUNK_ROWS];       /* 已按小端保存 */
+    Uint8 done[SNAKE_TRAJECTORY_CHUNK_ROWS / 8];
+    Uint32 rows;                                     /* 已填充的行数 */
+    Uint64 first_row;                                /* 第一行的编号 */
+} TrajectoryBuffer;
+
+struct SnakeTrajectoryWriter
+{
+    SDL_IOStream *io;
+    SDL_Thread *thread;
+    SDL_Mutex *lock;
+    SDL_Condition *queued;    /* 有块等待写出或正在关闭 */
+    SDL_Condition *released;  /* 另一个缓冲区已写完 */
+
+    TrajectoryBuffer buffers[2];
+    TrajectoryBuffer *current; /* 录制线程正在填充的缓冲区 */
+
+    /* 以下字段由 lock 保护 */
+    TrajectoryBuffer *pending; /* 等待写出的块 */
+    TrajectoryBuffer *spare;   /* 已写完、可以换入的缓冲区 */
+    bool closing;
+
+    /* 以下字段只由后台线程访问（关闭时在等待线程结束之后读取） */
+    TrajectoryChunkEntry *index;
+    Uint32 index_capacity;
+    Uint64 offset;             /* 下一次写入的文件偏移 */
+    bool failed;
+
+    SnakeTrajectoryWriterStats stats;
+};
+
+struct SnakeTrajectoryReader
+{
+    SDL_IOStream *io;
+#ifdef SDL_PLATFORM_LINUX
+    int fd;                    /* 用于 mmap 的文件描述符 */
+#endif
+    Uint64 rows;
+    TrajectoryChunkEntry *index;
+    Uint32 chunk_count;
+};
+
+/* 一列在 rows 行时的字节数（结束列每行 1 位） */
+static Uint64 column_size_(SnakeTrajectoryColumn column, Uint32 rows)
+{
+    switch (column)
+    {
+    case SNAKE_TRAJECTORY_OBS:
+        return (Uint64)rows * SNAKE_TRAJECTORY_OBS_BYTES;
+    case SNAKE_TRAJECTORY_ACTION:
+        return rows;
+    case SNAKE_TRAJECTORY_REWARD:
+        return (Uint64)rows * sizeof(float);
+    default:
+        return (rows + 7) / 8;
+    }
+}
+
+float snake_trajectory_reward(const SnakeContext *ctx, const SnakePlayer *prev, bool *done)
+{
+    /* SNAKE_EVENT_DIED 是整个场地的事件：单人模式下只可能是玩家1，多人模式下要看玩家1 自己是否离场 */
+    const bool died = ctx->player_count == 1 ? (ctx->events & SNAKE_EVENT_DIED) != 0
+                                             : prev->alive && !ctx->players[0].alive;
+
+    *done = died || (ctx->events & SNAKE_EVENT_WON) != 0;
+    /* 死亡或占满场地时得分已经清零，不能再用得分的差 */
+    if (*done)
+    {
+        return died ? -1.0f : 1.0f;
+    }
+    return (float)(ctx->players[0].score - prev->score);
+}
+
+/* 写入 size 字节并推进偏移 */
+static bool write_(SnakeTrajectoryWriter *writer, const void *data, Uint64 size)
+{
+    if (SDL_WriteIO(writer->io, data, (size_t)size) != size)
+    {
+        return false;
+    }
+    writer->offset += size;
+    return true;
+}
+
+/* 用零补齐到列的对齐 */
+static bool pad_(SnakeTrajectoryWriter *writer)
+{
+    static const Uint8 zeros[SNAKE_TRAJECTORY_ALIGN] = {0};
+    const Uint64 pad = (SNAKE_TRAJECTORY_ALIGN - writer->offset % SNAKE_TRAJECTORY_ALIGN) % SNAKE_TRAJECTORY_ALIGN;
+    return write_(writer, zeros, pad);
+}
+
+/* 写出一块的各列并记录索引 */
+static void write_chunk_(SnakeTrajectoryWriter *writer, const TrajectoryBuffer *buffer)
+{
+    const void *columns[SNAKE_TRAJECTORY_COLUMN_COUNT] = {buffer->obs, buffer->action, buffer->reward, buffer->done};
+    const Uint64 start = writer->offset;
+    TrajectoryChunkEntry *entry;
+    int c;
+
+    if (writer->stats.chunks == writer->index_capacity)
+    {
+        const Uint32 capacity = writer->index_capacity ? writer->index_capacity * 2 : 64;
+        TrajectoryChunkEntry *index = (TrajectoryChunkEntry *)SDL_realloc(writer->index, capacity * sizeof(TrajectoryChunkEntry));
+        if (!index)
+        {
+            writer->failed = true;
+            return;
+        }
+        writer->index = index;
+        writer->index_capacity = capacity;
+    }
+
+    entry = &writer->index[writer->stats.chunks];
+    entry->first_row = buffer->first_row;
+    entry->rows = buffer->rows;
+    for (c = 0; c < SNAKE_TRAJECTORY_COLUMN_COUNT; c++)
+    {
+        entry->offsets[c] = writer->offset;
+        entry->sizes[c] = column_size_((SnakeTrajectoryColumn)c, buffer->rows);
+        if (!write_(writer, columns[c], entry->sizes[c]) || !pad_(writer))
+        {
+            writer->failed = true;
+            return;
+        }
+    }
+    ++writer->stats.chunks;
+    writer->stats.bytes += writer->offset - start;
+}
+
+/* 后台写入线程：写出等待的块，直到关闭且没有等待的块 */
+static int SDLCALL writer_thread_(void *userdata)
+{
+    SnakeTrajectoryWriter *writer = (SnakeTrajectoryWriter *)userdata;
+
+    SDL_LockMutex(writer->lock);
+    for (;;)
+    {
+        TrajectoryBuffer *buffer;
+        while (!writer->pending && !writer->closing)
+        {
+            SDL_WaitCondition(writer->queued, writer->lock);
+        }
+        if (!writer->pending)
+        {
+            break;
+        }
+        buffer = writer->pending;
+        writer->pending = NULL;
+        SDL_UnlockMutex(writer->lock);
+
+        if (!writer->failed)
+        {
+            write_chunk_(writer, buffer);
+        }
+
+        SDL_LockMutex(writer->lock);
+        writer->spare = buffer;
+        SDL_SignalCondition(writer->released);
+    }
+    SDL_UnlockMutex(writer->lock);
+    return 0;
+}
+
+SnakeTrajectoryWriter *snake_trajectory_writer_open(const char *path)
+{
+    SnakeTrajectoryWriter *writer = (SnakeTrajectoryWriter *)SDL_calloc(1, sizeof(SnakeTrajectoryWriter));
+    Uint8 header[TRAJECTORY_HEADER_SIZE];
+    SDL_IOStream *mem;
+    bool ok;
+
+    if (!writer)
+    {
+        return NULL;
+    }
+    writer->io = SDL_IOFromFile(path, "wb");
+    if (!writer->io)
+    {
+        SDL_free(writer);
+        return NULL;
+    }
+
+    /* 文件头：先写入内存再补齐 */
+    SDL_zeroa(header);
+    mem = SDL_IOFromMem(header, sizeof(header));
+    ok = mem &&
+         SDL_WriteU32LE(mem, TRAJECTORY_FILE_MAGIC) &&
+         SDL_WriteU32LE(mem, TRAJECTORY_FILE_VERSION) &&
+         SDL_WriteU16LE(mem, SNAKE_GAME_WIDTH) &&
+         SDL_WriteU16LE(mem, SNAKE_GAME_HEIGHT) &&
+         SDL_WriteU16LE(mem, SNAKE_CELL_MAX_BITS) &&
+         SDL_WriteU16LE(mem, (Uint16)SNAKE_TRAJECTORY_OBS_BYTES) &&
+         SDL_WriteU32LE(mem, SNAKE_TRAJECTORY_CHUNK_ROWS);
+    if (mem)
+    {
+        SDL_CloseIO(mem);
+    }
+    if (!ok || !write_(writer, header, sizeof(header)))
+    {
+        SDL_CloseIO(writer->io);
+        SDL_free(writer);
+        return NULL;
+    }
+
+    writer->current = &writer->buffers[0];
+    writer->spare = &writer->buffers[1];
+    writer->lock = SDL_CreateMutex();
+    writer->queued = SDL_CreateCondition();
+    writer->released = SDL_CreateCondition();
+    if (writer->lock && writer->queued && writer->released)
+    {
+        writer->thread = SDL_CreateThread(writer_thread_, "snake-trajectory-writer", writer);
+    }
+    if (!writer->thread)
+    {
+        SDL_DestroyCondition(writer->released);
+        SDL_DestroyCondition(writer->queued);
+        SDL_DestroyMutex(writer->lock);
+        SDL_CloseIO(writer->io);
+        SDL_free(writer);
+        return NULL;
+    }
+    return writer;
+}
+
+/* 把当前缓冲区交给后台线程，换入另一个缓冲区（还没写完时等待） */
+static void submit_current_(SnakeTrajectoryWriter *writer)
+{
+    TrajectoryBuffer *next;
+    const Uint64 next_row = writer->current->first_row + writer->current->rows;
+
+    SDL_LockMutex(writer->lock);
+    if (!writer->spare)
+    {
+        ++writer->stats.stalls;
+        do
+        {
+            SDL_WaitCondition(writer->released, writer->lock);
+        } while (!writer->spare);
+    }
+    next = writer->spare;
+    writer->spare = NULL;
+    writer->pending = writer->current;
+    SDL_SignalCondition(writer->queued);
+    SDL_UnlockMutex(writer->lock);
+
+    writer->current = next;
+    writer->current->rows = 0;
+    writer->current->first_row = next_row;
+    SDL_zeroa(writer->current->done);
+}
+
+void snake_trajectory_writer_record(SnakeTrajectoryWriter *writer, const unsigned char *obs, Uint8 action, float reward, bool done)
+{
+    TrajectoryBuffer *buffer = writer->current;
+    Uint32 row;
+
+    if (buffer->rows == SNAKE_TRAJECTORY_CHUNK_ROWS)
+    {
+        submit_current_(writer);
+        buffer = writer->current;
+    }
+    row = buffer->rows++;
+    SDL_memcpy(buffer->obs[row], obs, SNAKE_TRAJECTORY_OBS_BYTES);
+    buffer->action[row] = action;
+    buffer->reward[row] = SDL_SwapFloatLE(reward);
+    if (done)
+    {
+        buffer->done[row / 8] |= (Uint8)(1U << (row % 8));
+    }
+    ++writer->stats.rows;
+}
+
+bool snake_trajectory_writer_close(SnakeTrajectoryWriter *writer, SnakeTrajectoryWriterStats *stats)
+{
+    bool ok;
+    Uint32 i;
+    int c;
+
+    if (writer->current->rows > 0)
+    {
+        submit_current_(writer);
+    }
+    SDL_LockMutex(writer->lock);
+    writer->closing = true;
+    SDL_SignalCondition(writer->queued);
+    SDL_UnlockMutex(writer->lock);
+    SDL_WaitThread(writer->thread, NULL);
+
+    /* 索引和文件尾 */
+    ok = !writer->failed;
+    for (i = 0; ok && i < writer->stats.chunks; i++)
+    {
+        const TrajectoryChunkEntry *entry = &writer->index[i];
+        ok = SDL_WriteU64LE(writer->io, entry->first_row) &&
+             SDL_WriteU32LE(writer->io, entry->rows) &&
+             SDL_WriteU32LE(writer->io, 0);
+        for (c = 0; ok && c < SNAKE_TRAJECTORY_COLUMN_COUNT; c++)
+        {
+            ok = SDL_WriteU64LE(writer->io, entry->offsets[c]) && SDL_WriteU64LE(writer->io, entry->sizes[c]);
+        }
+    }
+    ok = ok && SDL_WriteU64LE(writer->io, writer->offset);
+    ok = ok && SDL_WriteU64LE(writer->io, writer->stats.rows);
+    ok = ok && SDL_WriteU32LE(writer->io, writer->stats.chunks);
+    ok = ok && SDL_WriteU32LE(writer->io, TRAJECTORY_TRAILER_MAGIC);
+    if (!SDL_CloseIO(writer->io))
+    {
+        ok = false;
+    }
+
+    if (stats)
+    {
+        *stats = writer->stats;
+    }
+    SDL_DestroyCondition(writer->released);
+    SDL_DestroyCondition(writer->queued);
+    SDL_DestroyMutex(writer->lock);
+    SDL_free(writer->index);
+    SDL_free(writer);
+    return ok;
+}
+
+/* 读取并检查文件头：场地大小和编码必须与当前版本相同 */
+static bool read_header_(SnakeTrajectoryReader *reader, const char *path)
+{
+    Uint32 magic = 0;
+    Uint32 version = 0;
+    Uint16 width = 0;
+    Uint16 height = 0;
+    Uint16 bits = 0;
+    Uint16 obs_bytes = 0;
+    Uint32 chunk_rows = 0;
+
+    if (!SDL_ReadU32LE(reader->io, &magic) || !SDL_ReadU32LE(reader->io, &version) ||
+        magic != TRAJECTORY_FILE_MAGIC || version != TRAJECTORY_FILE_VERSION)
+    {
+        return SDL_SetError("%s is not a trajectory file", path);
+    }
+    if (!SDL_ReadU16LE(reader->io, &width) || !SDL_ReadU16LE(reader->io, &height) ||
+        !SDL_ReadU16LE(reader->io, &bits) || !SDL_ReadU16LE(reader->io, &obs_bytes) ||
+        !SDL_ReadU32LE(reader->io, &chunk_rows) ||
+        width != SNAKE_GAME_WIDTH || height != SNAKE_GAME_HEIGHT || bits != SNAKE_CELL_MAX_BITS ||
+        obs_bytes != SNAKE_TRAJECTORY_OBS_BYTES || chunk_rows == 0)
+    {
+        return SDL_SetError("%s was recorded with a different board", path);
+    }
+    return true;
+}
+
+/* 读取文件尾指向的索引并检查每列都在文件范围内 */
+static bool read_index_(SnakeTrajectoryReader *reader, const char *path)
+{
+    const Sint64 file_size = SDL_GetIOSize(reader->io);
+    Uint64 index_offset = 0;
+    Uint64 rows = 0;
+    Uint32 magic = 0;
+    Uint32 reserved = 0;
+    Uint32 i;
+    int c;
+
+    if (file_size < (Sint64)(TRAJECTORY_HEADER_SIZE + TRAJECTORY_TRAILER_SIZE) ||
+        SDL_SeekIO(reader->io, file_size - TRAJECTORY_TRAILER_SIZE, SDL_IO_SEEK_SET) < 0 ||
+        !SDL_ReadU64LE(reader->io, &index_offset) ||
+        !SDL_ReadU64LE(reader->io, &reader->rows) ||
+        !SDL_ReadU32LE(reader->io, &reader->chunk_count) ||
+        !SDL_ReadU32LE(reader->io, &magic) ||
+        magic != TRAJECTORY_TRAILER_MAGIC ||
+        index_offset < TRAJECTORY_HEADER_SIZE ||
+        index_offset + (Uint64)reader->chunk_count * TRAJECTORY_INDEX_ENTRY_SIZE + TRAJECTORY_TRAILER_SIZE != (Uint64)file_size)
+    {
+        return SDL_SetError("%s has no index (recording did not finish)", path);
+    }
+
+    reader->index = (TrajectoryChunkEntry *)SDL_calloc(reader->chunk_count ? reader->chunk_count : 1, sizeof(TrajectoryChunkEntry));
+    if (!reader->index || SDL_SeekIO(reader->io, (Sint64)index_offset, SDL_IO_SEEK_SET) < 0)
+    {
+        return false;
+    }
+    for (i = 0; i < reader->chunk_count; i++)
+    {
+        TrajectoryChunkEntry *entry = &reader->index[i];
+        if (!SDL_ReadU64LE(reader->io, &entry->first_row) ||
+            !SDL_ReadU32LE(reader->io, &entry->rows) ||
+            !SDL_ReadU32LE(reader->io, &reserved) ||
+            entry->first_row != rows || entry->rows == 0)
+        {
+            return SDL_SetError("%s has a corrupt index", path);
+        }
+        for (c = 0; c < SNAKE_TRAJECTORY_COLUMN_COUNT; c++)
+        {
+            if (!SDL_ReadU64LE(reader->io, &entry->offsets[c]) || !SDL_ReadU64LE(reader->io, &entry->sizes[c]) ||
+                entry->sizes[c] != column_size_((SnakeTrajectoryColumn)c, entry->rows) ||
+                entry->offsets[c] < TRAJECTORY_HEADER_SIZE || entry->offsets[c] + entry->sizes[c] > index_offset)
+            {
+                return SDL_SetError("%s has a corrupt index", path);
+            }
+        }
+        rows += entry->rows;
+    }
+    if (rows != reader->rows)
+    {
+        return SDL_SetError("%s has a corrupt index", path);
+    }
+    return true;
+}
+
+SnakeTrajectoryReader *snake_trajectory_reader_open(const char *path)
+{
+    SnakeTrajectoryReader *reader = (SnakeTrajectoryReader *)SDL_calloc(1, sizeof(SnakeTrajectoryReader));
+
+    if (!reader)
+    {
+        return NULL;
+    }
+#ifdef SDL_PLATFORM_LINUX
+    reader->fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (reader->fd < 0)
+    {
+        SDL_SetError("Cannot open %s", path);
+        SDL_free(reader);
+        return NULL;
+    }
+#endif
+    reader->io = SDL_IOFromFile(path, "rb");
+    if (!reader->io || !read_header_(reader, path) || !read_index_(reader, path))
+    {
+        snake_trajectory_reader_close(reader);
+        return NULL;
+    }
+    return reader;
+}
+
+void snake_trajectory_reader_close(SnakeTrajectoryReader *reader)
+{
+    if (!reader)
+    {
+        return;
+    }
+    if (reader->io)
+    {
+        SDL_CloseIO(reader->io);
+    }
+#ifdef SDL_PLATFORM_LINUX
+    close(reader->fd);
+#endif
+    SDL_free(reader->index);
+    SDL_free(reader);
+}
+
+Uint64 snake_trajectory_reader_rows(const SnakeTrajectoryReader *reader)
+{
+    return reader->rows;
+}
+
+Uint32 snake_trajectory_reader_chunks(const SnakeTrajectoryReader *reader)
+{
+    return reader->chunk_count;
+}
+
+bool snake_trajectory_map(SnakeTrajectoryReader *reader, Uint32 chunk, SnakeTrajectoryColumn column, SnakeTrajectoryView *view)
+{
+    const TrajectoryChunkEntry *entry;
+    Uint64 offset;
+    Uint64 size;
+
+    SDL_zerop(view);
+    if (chunk >= reader->chunk_count || (unsigned)column >= SNAKE_TRAJECTORY_COLUMN_COUNT)
+    {
+        return SDL_InvalidParamError("chunk");
+    }
+    entry = &reader->index[chunk];
+    offset = entry->offsets[column];
+    size = entry->sizes[column];
+    view->size = size;
+    view->rows = entry->rows;
+
+#ifdef SDL_PLATFORM_LINUX
+    {
+        /* mmap 的偏移必须按页对齐，从所在页的开头映射 */
+        const Uint64 page = (Uint64)sysconf(_SC_PAGESIZE);
+        const Uint64 start = offset / page * page;
+        void *mapping;
+
+        view->mapping_size = (size_t)(offset + size - start);
+        mapping = mmap(NULL, view->mapping_size, PROT_READ, MAP_PRIVATE, reader->fd, (off_t)start);
+        if (mapping == MAP_FAILED)
+        {
+            SDL_zerop(view);
+            return SDL_SetError("Cannot map trajectory chunk %u", chunk);
+        }
+        view->mapping = mapping;
+        view->data = (const Uint8 *)mapping + (offset - start);
+    }
+#else
+    view->mapping = SDL_malloc((size_t)size);
+    view->mapping_size = (size_t)size;
+    if (!view->mapping ||
+        SDL_SeekIO(reader->io, (Sint64)offset, SDL_IO_SEEK_SET) < 0 ||
+        SDL_ReadIO(reader->io, view->mapping, (size_t)size) != size)
+    {
+        SDL_free(view->mapping);
+        SDL_zerop(view);
+        return SDL_SetError("Cannot read trajectory chunk %u", chunk);
+    }
+    view->data = view->mapping;
+#endif
+    return true;
+}
+
+void snake_trajectory_unmap(SnakeTrajectoryView *view)
+{
+    if (view->mapping)
+    {
+#ifdef SDL_PLATFORM_LINUX
+        munmap(view->mapping, view->mapping_size);
+#else
+        SDL_free(view->mapping);
+#endif
+    }
+    SDL_zerop(view);
+}
@@ -0,0 +1,297 @@
+/*
+ * 轨迹数据集检查
+ * 录制一段随机对局的轨迹（后台线程按块写入），再从文件读取：
+ * 先只映射奖励和结束两列统计总奖励和局数，检查不必读取观察列；
+ * 再映射动作列重新模拟同一局，每行的观察必须与模拟时执行 tick 之前的场地一致；
+ * 最后在多人对局中检查奖励：其他玩家死亡时玩家1 的奖励和结束标记不受影响
+ */
+
+#include "headless.h"
+#include "batch.h"
+#include "trajectory.h"
+
+#define TRAJECTORY_CHECK_DEFAULT_PATH "trajectory_check.snkt"
+#define TRAJECTORY_CHECK_TICKS 100000U   /* 默认录制长度 */
+#define TRAJECTORY_CHECK_SEED 0x7A3C
+#define TRAJECTORY_CHECK_PLAYERS 3              /* 多人对局的玩家数 */
+#define TRAJECTORY_CHECK_MULTIPLAYER_TICKS 20000U /* 多人对局的长度 */
+
+/* 随机对局中的一个 tick：随机转向、推进，返回实际采用的动作 */
+static Uint8 random_tick_(SnakeContext *ctx, Uint64 *rng)
+{
+    const char before = ctx->players[0].next_dir;
+    Uint8 turn;
+
+    snake_batch_random_turns(&turn, 1, rng);
+    if (turn != SNAKE_BATCH_NO_TURN)
+    {
+        snake_redir(ctx, (SnakeDirection)turn);
+    }
+    return ctx->players[0].next_dir != before ? (Uint8)ctx->players[0].next_dir : SNAKE_TRAJECTORY_NO_ACTION;
+}
+
+/* 只映射奖励和结束两列 */
+static bool sum_rewards_(SnakeTrajectoryReader *reader, double *reward_sum, Uint64 *episodes, Uint64 *mapped)
+{
+    Uint32 chunk;
+    Uint32 row;
+
+    for (chunk = 0; chunk < snake_trajectory_reader_chunks(reader); chunk++)
+    {
+        SnakeTrajectoryView rewards;
+        SnakeTrajectoryView done;
+        if (!snake_trajectory_map(reader, chunk, SNAKE_TRAJECTORY_REWARD, &rewards))
+        {
+            return false;
+        }
+        if (!snake_trajectory_map(reader, chunk, SNAKE_TRAJECTORY_DONE, &done))
+        {
+            snake_trajectory_unmap(&rewards);
+            return false;
+        }
+        for (row = 0; row < rewards.rows; row++)
+        {
+            float reward;
+            SDL_memcpy(&reward, (const Uint8 *)rewards.data + row * sizeof(float), sizeof(reward));
+            *reward_sum += SDL_SwapFloatLE(reward);
+            *episodes += (((const Uint8 *)done.data)[row / 8] >> (row % 8)) & 1U;
+        }
+        *mapped += rewards.size + done.size;
+        snake_trajectory_unmap(&done);
+        snake_trajectory_unmap(&rewards);
+    }
+    return true;
+}
+
+/* 映射动作和观察两列，重新模拟并比较每行的观察 */
+static bool replay_(SnakeTrajectoryReader *reader, SnakeContext *ctx)
+{
+    Uint32 chunk;
+    Uint32 row;
+    Uint64 tick = 0;
+
+    snake_initialize_seeded(ctx, TRAJECTORY_CHECK_SEED);
+    for (chunk = 0; chunk < snake_trajectory_reader_chunks(reader); chunk++)
+    {
+        SnakeTrajectoryView actions;
+        SnakeTrajectoryView obs;
+        bool ok = true;
+        if (!snake_trajectory_map(reader, chunk, SNAKE_TRAJECTORY_ACTION, &actions))
+        {
+            return false;
+        }
+        if (!snake_trajectory_map(reader, chunk, SNAKE_TRAJECTORY_OBS, &obs))
+        {
+            snake_trajectory_unmap(&actions);
+            return false;
+        }
+        for (row = 0; ok && row < actions.rows; row++, tick++)
+        {
+            const Uint8 action = ((const Uint8 *)actions.data)[row];
+            if (SDL_memcmp((const Uint8 *)obs.data + (size_t)row * SNAKE_TRAJECTORY_OBS_BYTES, ctx->cells, SNAKE_TRAJECTORY_OBS_BYTES) != 0)
+            {
+                SDL_SetError("observation of row %" SDL_PRIu64 " differs from the simulated board", tick);
+                ok = false;
+            }
+            if (action != SNAKE_TRAJECTORY_NO_ACTION)
+            {
+                snake_redir(ctx, (SnakeDirection)action);
+            }
+            snake_step(ctx);
+        }
+        snake_trajectory_unmap(&obs);
+        snake_trajectory_unmap(&actions);
+        if (!ok)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* 多人随机对局：每行的结束标记只在玩家1 自己死亡或占满场地时为 true，
+ * 其他玩家死亡的 tick 中玩家1 的奖励仍是自己得分的增加量
+ */
+static bool check_multiplayer_(SnakeContext *ctx, Uint64 *rng)
+{
+    int own_deaths = 0;
+    int other_deaths = 0;
+    Uint32 tick;
+    int p;
+
+    snake_initialize_seeded(ctx, TRAJECTORY_CHECK_SEED);
+    snake_set_player_count(ctx, TRAJECTORY_CHECK_PLAYERS);
+    for (tick = 0; tick < TRAJECTORY_CHECK_MULTIPLAYER_TICKS; tick++)
+    {
+        const SnakePlayer prev = ctx->players[0];
+        Uint8 turns[TRAJECTORY_CHECK_PLAYERS];
+        bool own_death;
+        bool episode_done;
+        float reward;
+
+        snake_batch_random_turns(turns, TRAJECTORY_CHECK_PLAYERS, rng);
+        for (p = 0; p < TRAJECTORY_CHECK_PLAYERS; p++)
+        {
+            if (turns[p] != SNAKE_BATCH_NO_TURN)
+            {
+                snake_player_redir(ctx, p, (SnakeDirection)turns[p]);
+            }
+        }
+        snake_step(ctx);
+        reward = snake_trajectory_reward(ctx, &prev, &episode_done);
+        own_death = prev.alive && !ctx->players[0].alive;
+        if (episode_done != (own_death || (ctx->events & SNAKE_EVENT_WON) != 0) ||
+            (own_death && reward != -1.0f))
+        {
+            SDL_SetError("tick %u: player 1 %s but the row has reward %.0f, done %d", ctx->tick,
+                         own_death ? "died" : "is alive", reward, episode_done);
+            return false;
+        }
+        if (!episode_done && (ctx->events & SNAKE_EVENT_DIED))
+        {
+            if (reward != (float)(ctx->players[0].score - prev.score))
+            {
+                SDL_SetError("tick %u: another player died and player 1 got reward %.0f", ctx->tick, reward);
+                return false;
+            }
+            ++other_deaths;
+        }
+        own_deaths += own_death;
+    }
+    if (own_deaths == 0 || other_deaths == 0)
+    {
+        SDL_SetError("%d players over %u ticks: %d own deaths, %d deaths of other players, expected both",
+                     TRAJECTORY_CHECK_PLAYERS, TRAJECTORY_CHECK_MULTIPLAYER_TICKS, own_deaths, other_deaths);
+        return false;
+    }
+    SDL_Log("trajectory-check: %d players: %d episodes ended by player 1's own deaths, %d deaths of other players left player 1's rows alone",
+            TRAJECTORY_CHECK_PLAYERS, own_deaths, other_deaths);
+    return true;
+}
+
+SDL_AppResult snake_trajectory_check(int argc, char *argv[])
+{
+    const char *path = TRAJECTORY_CHECK_DEFAULT_PATH;
+    Uint32 ticks = TRAJECTORY_CHECK_TICKS;
+    SnakeTrajectoryWriter *writer = NULL;
+    SnakeTrajectoryReader *reader = NULL;
+    SnakeTrajectoryWriterStats stats;
+    SnakeContext *ctx = (SnakeContext *)SDL_aligned_alloc(SNAKE_CACHE_LINE, sizeof(SnakeContext));
+    Uint64 rng = TRAJECTORY_CHECK_SEED;
+    double reward_sum = 0.0;
+    double read_sum = 0.0;
+    Uint64 episodes = 0;
+    Uint64 read_episodes = 0;
+    Uint64 mapped = 0;
+    Uint64 start;
+    Uint32 tick;
+    bool ok = false;
+    int i;
+
+    for (i = 1; i < argc; i++)
+    {
+        if (SDL_strcmp(argv[i], "--trajectory-path") == 0 && i + 1 < argc)
+        {
+            path = argv[++i];
+        }
+        else if (SDL_strcmp(argv[i], "--trajectory-ticks") == 0 && i + 1 < argc)
+        {
+            ticks = (Uint32)SDL_strtoul(argv[++i], NULL, 10);
+        }
+    }
+    if (!ctx)
+    {
+        return SDL_APP_FAILURE;
+    }
+
+    /* 录制 */
+    writer = snake_trajectory_writer_open(path);
+    if (!writer)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "trajectory-check: %s", SDL_GetError());
+        goto done;
+    }
+    start = SDL_GetTicksNS();
+    snake_initialize_seeded(ctx, TRAJECTORY_CHECK_SEED);
+    for (tick = 0; tick < ticks; tick++)
+    {
+        unsigned char obs[SNAKE_TRAJECTORY_OBS_BYTES];
+        const SnakePlayer prev = ctx->players[0];
+        Uint8 action;
+        float reward;
+        bool episode_done;
+
+        SDL_memcpy(obs, ctx->cells, sizeof(obs));
+        action = random_tick_(ctx, &rng);
+        snake_step(ctx);
+        reward = snake_trajectory_reward(ctx, &prev, &episode_done);
+        snake_trajectory_writer_record(writer, obs, action, reward, episode_done);
+        reward_sum += reward;
+        episodes += episode_done;
+    }
+    ok = snake_trajectory_writer_close(writer, &stats);
+    writer = NULL;
+    if (!ok)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "trajectory-check: writing %s failed", path);
+        goto done;
+    }
+    SDL_Log("trajectory-check: recorded %" SDL_PRIu64 " rows in %.1f ms: %u chunks, %.1f MiB, %u stalls",
+            stats.rows, (SDL_GetTicksNS() - start) / 1e6, stats.chunks, stats.bytes / (1024.0 * 1024.0), stats.stalls);
+
+    /* 只读奖励和结束两列 */
+    ok = false;
+    reader = snake_trajectory_reader_open(path);
+    if (!reader)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "trajectory-check: %s", SDL_GetError());
+        goto done;
+    }
+    if (snake_trajectory_reader_rows(reader) != ticks)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "trajectory-check: %" SDL_PRIu64 " rows in the file, expected %u",
+                     snake_trajectory_reader_rows(reader), ticks);
+        goto done;
+    }
+    start = SDL_GetTicksNS();
+    if (!sum_rewards_(reader, &read_sum, &read_episodes, &mapped))
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "trajectory-check: %s", SDL_GetError());
+        goto done;
+    }
+    if (read_sum != reward_sum || read_episodes != episodes)
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "trajectory-check: read reward %.0f over %" SDL_PRIu64 " episodes, recorded %.0f over %" SDL_PRIu64,
+                     read_sum, read_episodes, reward_sum, episodes);
+        goto done;
+    }
+    SDL_Log("trajectory-check: reward and done columns: total reward %.0f over %" SDL_PRIu64 " episodes, %.1f KiB mapped (%.2f%% of the file) in %.2f ms",
+            read_sum, read_episodes, mapped / 1024.0, stats.bytes ? 100.0 * mapped / stats.bytes : 0.0,
+            (SDL_GetTicksNS() - start) / 1e6);
+
+    /* 按动作列重新模拟，与观察列比较 */
+    start = SDL_GetTicksNS();
+    if (!replay_(reader, ctx))
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "trajectory-check: %s", SDL_GetError());
+        goto done;
+    }
+    SDL_Log("trajectory-check: replayed %u rows from the action column, observations match (%.1f ms)", ticks,
+            (SDL_GetTicksNS() - start) / 1e6);
+    if (!check_multiplayer_(ctx, &rng))
+    {
+        SDL_LogError(SDL_LOG_CATEGORY_TEST, "trajectory-check: %s", SDL_GetError());
+        goto done;
+    }
+    ok = true;
+
+done:
+    snake_trajectory_reader_close(reader);
+    if (writer)
+    {
+        snake_trajectory_writer_close(writer, NULL);
+    }
+    SDL_RemovePath(path);
+    SDL_aligned_free(ctx);
+    return ok ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+}